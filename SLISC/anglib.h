@@ -6,16 +6,42 @@
 
 #pragma once
 #include "scalar_arith.h"
+#include "cmat3d.h"
+#include <unordered_map>
 
 namespace slisc {
 
 inline Doub binom(Long_I n, Long_I r) {
-    if (n == r || r == 0)
-        return 1.;
-    else if (r == 1)
-        return (Doub)n;
-    else
-        return n / Doub(n - r)*binom(n - 1, r);
+    Long k = MIN(r, n - r);
+    if (k < 0)
+        return 0.;
+    Doub ret = 1.;
+    for (Long i = 1; i <= k; ++i)
+        ret = ret * (n - k + i) / i;
+    return ret;
+}
+
+// log(n!), tabulated for n < lnfact_N (the table is created on the first call, thread-safe)
+const Long lnfact_N = 1024;
+
+class LnFactTable
+{
+public:
+    VecDoub v;
+    LnFactTable() : v(lnfact_N)
+    {
+        v[0] = 0;
+        for (Long n = 1; n < lnfact_N; ++n)
+            v[n] = v[n - 1] + log((Doub)n);
+    }
+};
+
+inline Doub lnfact(Long_I n)
+{
+    static const LnFactTable tab;
+    if (n < lnfact_N)
+        return tab.v[n];
+    return lgamma(n + 1.);
 }
 
 // calc dimension of CG table and max(m1)
@@ -81,13 +107,8 @@ inline Doub threej(Long_I j1, Long_I m1, Long_I j2, Long_I m2, Long_I j3, Long_I
 }
 
 inline Doub angdelta(Long_I a, Long_I b, Long_I c) {
-    Doub angdelta, scr1;
-    scr1 = factorial((a + b - c) / 2);
-    scr1 = scr1 / factorial((a + b + c) / 2 + 1);
-    scr1 = scr1 * factorial((a - b + c) / 2);
-    scr1 = scr1 * factorial((-a + b + c) / 2);
-    angdelta = sqrt(scr1);
-    return angdelta;
+    return exp(0.5 * (lnfact((a + b - c) / 2) - lnfact((a + b + c) / 2 + 1)
+        + lnfact((a - b + c) / 2) + lnfact((-a + b + c) / 2)));
 }
 
 // 6j symbol [a/2,b/2,c/2; d/2,e/2,f/2]
@@ -164,4 +185,243 @@ inline Doub yyy(Long_I l1, Long_I l2, Long_I L, Long_I M, Long_I l,
     return out;
 }
 
+// === tables and memoization ===
+
+// 3j symbols (j1 j2 j3; m1 m2 m3) for all allowed j1, m1 = -m2 - m3 (all arguments are doubled)
+// f[k] is for two_j1 = two_j1min + 2k, f.size() == 0 if there is none
+// three-term recurrence in j1 (K. Schulten and R. G. Gordon, J. Math. Phys. 16, 1961 (1975))
+// forward from j1min and backward from j1max (both stable) matched at the first maximum
+inline void threej_table(VecDoub_O f, Long_O two_j1min, Long_I two_j2, Long_I two_j3, Long_I two_m2, Long_I two_m3)
+{
+    Long two_m1 = -two_m2 - two_m3;
+    two_j1min = MAX(abs(two_j2 - two_j3), abs(two_m1));
+    Long two_j1max = two_j2 + two_j3;
+    if (isodd(two_j2 - two_m2) || isodd(two_j3 - two_m3) || abs(two_m2) > two_j2 ||
+        abs(two_m3) > two_j3 || two_j1max < two_j1min) {
+        f.resize(0); return;
+    }
+    Long N = (two_j1max - two_j1min) / 2 + 1;
+    f.resize(N);
+    Doub j2 = 0.5 * two_j2, j3 = 0.5 * two_j3, m1 = 0.5 * two_m1, m2 = 0.5 * two_m2, m3 = 0.5 * two_m3;
+    Doub j1min = 0.5 * two_j1min, j1max = 0.5 * two_j1max;
+    auto A = [&](Doub_I j) {
+        return sqrt((j * j - (j2 - j3) * (j2 - j3)) * ((j2 + j3 + 1) * (j2 + j3 + 1) - j * j) * (j * j - m1 * m1));
+    };
+    auto B = [&](Doub_I j) {
+        return -(2 * j + 1) * ((j2 * (j2 + 1) - j3 * (j3 + 1)) * m1 - j * (j + 1) * (m3 - m2));
+    };
+    const Doub big = 1e100;
+    // forward
+    f[0] = 1;
+    Long kp = N - 1; // matching point
+    if (N > 1) {
+        if (two_j1min == 0) // j2 == j3, m1 == 0
+            f[1] = m2 / sqrt(j2 * (j2 + 1));
+        else
+            f[1] = -B(j1min) / (j1min * A(j1min + 1));
+    }
+    for (Long k = 1; k < N - 1; ++k) {
+        Doub j = j1min + k;
+        f[k + 1] = -(B(j) * f[k] + (j + 1) * A(j) * f[k - 1]) / (j * A(j + 1));
+        if (abs(f[k + 1]) > big)
+            for (Long i = 0; i <= k + 1; ++i)
+                f[i] /= big;
+        if (abs(f[k + 1]) < abs(f[k - 1])) { // f[k+1]^2 + f[k]^2 decreases
+            kp = k; break;
+        }
+    }
+    // backward, match f[kp-1], f[kp]
+    if (kp < N - 1) {
+        VecDoub g(N);
+        g[N - 1] = 1;
+        g[N - 2] = -B(j1max) / ((j1max + 1) * A(j1max));
+        for (Long k = N - 2; k >= kp; --k) {
+            Doub j = j1min + k;
+            g[k - 1] = -(j * A(j + 1) * g[k + 1] + B(j) * g[k]) / ((j + 1) * A(j));
+            if (abs(g[k - 1]) > big)
+                for (Long i = k - 1; i < N; ++i)
+                    g[i] /= big;
+        }
+        Doub sc = (f[kp - 1] * g[kp - 1] + f[kp] * g[kp]) / (g[kp - 1] * g[kp - 1] + g[kp] * g[kp]);
+        for (Long k = kp + 1; k < N; ++k)
+            f[k] = sc * g[k];
+    }
+    // normalize, sum_j1 (2j1+1) f^2 = 1, sign(f(j1max)) = (-1)^(j2-j3-m1)
+    Doub sum = 0;
+    for (Long k = 0; k < N; ++k)
+        sum += (2 * (j1min + k) + 1) * f[k] * f[k];
+    sum = 1 / sqrt(sum);
+    if ((f[N - 1] < 0) != isodd((two_j2 - two_j3 - two_m1) / 2))
+        sum = -sum;
+    for (Long k = 0; k < N; ++k)
+        f[k] *= sum;
+}
+
+// Clebsch-Gordan coefficients <j1 m1 j2 m2|J M> for all allowed J, M = m1 + m2 (all arguments are doubled)
+// c[k] is for two_J = two_Jmin + 2k
+inline void cleb_table(VecDoub_O c, Long_O two_Jmin, Long_I two_j1, Long_I two_m1, Long_I two_j2, Long_I two_m2)
+{
+    // <j1 m1 j2 m2|J M> = (-1)^(j1-j2+M) * sqrt(2J+1) * (J j1 j2; -M m1 m2)
+    threej_table(c, two_Jmin, two_j1, two_j2, two_m1, two_m2);
+    Doub sgn = isodd((two_j1 - two_j2 + two_m1 + two_m2) / 2) ? -1 : 1;
+    for (Long k = 0; k < c.size(); ++k)
+        c[k] *= sgn * sqrt(two_Jmin + 2. * k + 1);
+}
+
+// all Clebsch-Gordan coefficients for fixed j1, j2 (doubled)
+// C(i1, i2, k) = <j1 m1 j2 m2|J M>, two_m1 = 2*i1 - two_j1, two_m2 = 2*i2 - two_j2, two_J = |two_j1 - two_j2| + 2k
+inline void cleb_table(Cmat3d<Doub> &C, Long_I two_j1, Long_I two_j2)
+{
+    Long two_Jmin0 = abs(two_j1 - two_j2), two_Jmin;
+    C.resize(two_j1 + 1, two_j2 + 1, MIN(two_j1, two_j2) + 1);
+    C = 0;
+    VecDoub c(0);
+    for (Long i2 = 0; i2 <= two_j2; ++i2)
+        for (Long i1 = 0; i1 <= two_j1; ++i1) {
+            cleb_table(c, two_Jmin, two_j1, 2 * i1 - two_j1, two_j2, 2 * i2 - two_j2);
+            for (Long k = 0; k < c.size(); ++k)
+                C(i1, i2, (two_Jmin - two_Jmin0) / 2 + k) = c[k];
+        }
+}
+
+// hash tables of 6j and 9j symbols, arguments are doubled
+// a query is reduced by symmetry (24 for 6j, 72 for 9j), only the canonical key is stored
+// a small direct-mapped cache of raw keys skips the reduction for repeated queries
+// only used for two_j < 1024 (6j) or two_j < 128 (9j), otherwise computed directly
+const Int ang_memo_cache_bits = 10;
+const Long ang_memo_Ncache = Long(1) << ang_memo_cache_bits; // entries in each raw-key cache
+
+class AngMemo
+{
+private:
+    std::unordered_map<Ullong, Doub> m_6j, m_9j; // canonical keys only
+    vector<std::pair<Ullong, Doub>> m_6j_cache, m_9j_cache; // raw keys, never Ullong(-1)
+    static Long cache_ind(Ullong_I key)
+    { return (key * 0x9E3779B97F4A7C15ULL) >> (64 - ang_memo_cache_bits); }
+public:
+    Long max_size = 1 << 16; // for each table, cleared when exceeded
+    AngMemo() { clear(); }
+    Doub sixj(Long_I a, Long_I b, Long_I c, Long_I d, Long_I e, Long_I f);
+    Doub ninej(Long_I a, Long_I b, Long_I c, Long_I d, Long_I e, Long_I f, Long_I g, Long_I h, Long_I i);
+    Long size() const { return m_6j.size() + m_9j.size(); }
+    void clear()
+    {
+        m_6j.clear(); m_9j.clear();
+        m_6j_cache.assign(ang_memo_Ncache, std::pair<Ullong, Doub>(-1, 0));
+        m_9j_cache.assign(ang_memo_Ncache, std::pair<Ullong, Doub>(-1, 0));
+    }
+};
+
+inline Doub AngMemo::sixj(Long_I a, Long_I b, Long_I c, Long_I d, Long_I e, Long_I f)
+{
+    if (MAX(MAX(MAX(a, b), MAX(c, d)), MAX(e, f)) >= 1024)
+        return slisc::sixj(a, b, c, d, e, f);
+    // repeated queries only need one lookup
+    Ullong key0 = ((((((Ullong)a << 10 | b) << 10 | c) << 10 | d) << 10 | e) << 10) | f;
+    std::pair<Ullong, Doub> &cache = m_6j_cache[cache_ind(key0)];
+    if (cache.first == key0)
+        return cache.second;
+    // columns can be permuted, upper and lower can be swapped in two columns
+    static const Int perm[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+    static const Int flip[4][3] = { {0,0,0}, {1,1,0}, {1,0,1}, {0,1,1} };
+    const Long col[3][2] = { {a, d}, {b, e}, {c, f} };
+    Ullong key = -1;
+    for (Int p = 0; p < 6; ++p)
+        for (Int q = 0; q < 4; ++q) {
+            Ullong k = 0;
+            for (Int r = 0; r < 2; ++r)
+                for (Int j = 0; j < 3; ++j)
+                    k = (k << 10) | (Ullong)col[perm[p][j]][r ^ flip[q][j]];
+            key = MIN(key, k);
+        }
+    auto it = m_6j.find(key);
+    Doub val;
+    if (it != m_6j.end())
+        val = it->second;
+    else {
+        val = slisc::sixj(a, b, c, d, e, f);
+        if ((Long)m_6j.size() >= max_size)
+            m_6j.clear();
+        m_6j[key] = val;
+    }
+    cache.first = key0; cache.second = val;
+    return val;
+}
+
+inline Doub AngMemo::ninej(Long_I a, Long_I b, Long_I c, Long_I d, Long_I e, Long_I f, Long_I g, Long_I h, Long_I i)
+{
+    const Long m[3][3] = { {a, b, c}, {d, e, f}, {g, h, i} };
+    Long sum = 0, mx = 0;
+    for (Int r = 0; r < 3; ++r)
+        for (Int j = 0; j < 3; ++j) {
+            sum += m[r][j]; mx = MAX(mx, m[r][j]);
+        }
+    if (mx >= 128)
+        return slisc::ninej(a, b, c, d, e, f, g, h, i);
+    // repeated queries only need one lookup
+    Ullong key0 = 0;
+    for (Int r = 0; r < 3; ++r)
+        for (Int j = 0; j < 3; ++j)
+            key0 = (key0 << 7) | (Ullong)m[r][j];
+    std::pair<Ullong, Doub> &cache = m_9j_cache[cache_ind(key0)];
+    if (cache.first == key0)
+        return cache.second;
+    // rows and columns can be permuted (odd permutations give (-1)^sum), or transposed
+    static const Int perm[6][3] = { {0,1,2}, {1,2,0}, {2,0,1}, {0,2,1}, {2,1,0}, {1,0,2} }; // even, odd
+    Bool odd_sum = isodd(sum / 2);
+    Ullong key = -1; Bool neg = false;
+    for (Int t = 0; t < 2; ++t)
+        for (Int pr = 0; pr < 6; ++pr)
+            for (Int pc = 0; pc < 6; ++pc) {
+                Ullong k = 0;
+                for (Int r = 0; r < 3; ++r)
+                    for (Int j = 0; j < 3; ++j)
+                        k = (k << 7) | (Ullong)(t ? m[perm[pc][j]][perm[pr][r]] : m[perm[pr][r]][perm[pc][j]]);
+                if (k < key) {
+                    key = k; neg = odd_sum && ((pr >= 3) != (pc >= 3));
+                }
+            }
+    auto it = m_9j.find(key);
+    Doub val; // value of the canonical key
+    if (it != m_9j.end())
+        val = it->second;
+    else {
+        // same as slisc::ninej(), with memoized 6j symbols
+        val = 0;
+        if (!(abs(a-b)>c || a+b<c || abs(d-e)>f || d+e<f || abs(g-h)>i || g+h<i ||
+            abs(a-d)>g || a+d<g || abs(b-e)>h || b+e<h || abs(c-f)>i || c+f<i)) {
+            Long xlo = MAX(abs(b-f), MAX(abs(a-i), abs(h-d)));
+            Long xhi = MIN(b + f, MIN(a + i, h + d));
+            for (Long x = xlo; x <= xhi; x += 2)
+                val += (isodd(x) ? -1 : 1) * (x + 1) * sixj(a, b, c, f, i, x) *
+                    sixj(d, e, f, b, x, h) * sixj(g, h, i, x, a, d);
+        }
+        if (neg)
+            val = -val;
+        if ((Long)m_9j.size() >= max_size)
+            m_9j.clear();
+        m_9j[key] = val;
+    }
+    cache.first = key0; cache.second = neg ? -val : val;
+    return cache.second;
+}
+
+// memo for the current thread, so that sixj_memo() and ninej_memo() can be used in OpenMP loops without locks
+inline AngMemo &ang_memo()
+{
+    static thread_local AngMemo memo;
+    return memo;
+}
+
+// memoized sixj() and ninej()
+inline Doub sixj_memo(Long_I a, Long_I b, Long_I c, Long_I d, Long_I e, Long_I f)
+{
+    return ang_memo().sixj(a, b, c, d, e, f);
+}
+
+inline Doub ninej_memo(Long_I a, Long_I b, Long_I c, Long_I d, Long_I e, Long_I f, Long_I g, Long_I h, Long_I i)
+{
+    return ang_memo().ninej(a, b, c, d, e, f, g, h, i);
+}
+
 } // namespace slisc
@@ -1,4 +1,5 @@
 // band diagonal matrix class
+#pragma once
 #include "cmat.h"
 
 namespace slisc {
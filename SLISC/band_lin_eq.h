@@ -0,0 +1,321 @@
+// direct solvers for band diagonal matrices (Band, CmatObd)
+// factorize once, then solve for any number of right hand sides
+// cost of factorization is O(N*Nlow*(Nlow+Nup)), each solve is O(N*(2*Nlow+Nup))
+// e.g. Crank-Nicolson propagator: LuBand<Comp> lu(A); then lu.solve(x) for each time step
+#pragma once
+#include "band.h"
+#include "cmatobd.h"
+
+namespace slisc {
+
+// convert CmatObd to Band (Nup = Nlow = n0() - 1)
+template <class T, class T1, SLS_IF(is_promo<T, T1>())>
+void cmatobd2band(Band<T> &b, const CmatObd<T1> &a)
+{
+    Long N0 = a.n0(), step = N0 - 1, N = a.n1(), Nblk = a.nblk(), k = N0 - 1;
+    b.m_N1 = b.m_N2 = N; b.m_Nup = b.m_Nlow = k;
+    b.m_a.resize(2 * k + 1, N);
+    b.m_a = 0;
+    const T1 *pa = a.ptr();
+    for (Long blk = 0; blk < Nblk; ++blk) {
+        Long gs = blk * step - 1; // global index of the first row/column of the block
+        Long k0 = gs < 0 ? 1 : 0, k1 = gs + N0 > N ? N0 - 1 : N0; // valid range in the block
+        for (Long j = k0; j < k1; ++j) {
+            for (Long i = k0; i < k1; ++i)
+                b.m_a(k + i - j, gs + j) += pa[N0 * j + i];
+        }
+        pa += N0 * N0;
+    }
+}
+
+// LU decomposition with partial pivoting for a square band matrix
+// same algorithm and storage as LAPACK ?gbtrf(), with Nlow more upper diagonals for fill-in
+template <class T>
+class LuBand
+{
+private:
+    Long m_N, m_Nup, m_Nlow;
+    Cmat<T> m_lu; // (2*Nlow+Nup+1, N), A(i,j) is m_lu(Nlow+Nup+i-j, j)
+    VecLong m_ipiv; // row i was interchanged with row m_ipiv[i]
+public:
+    LuBand();
+    LuBand(const Band<T> &a);
+    LuBand(const CmatObd<T> &a);
+    void factor(const Band<T> &a);
+    void factor(const CmatObd<T> &a);
+    Long n1() const;
+    Long n2() const;
+    // solve A*X = B, B is column major (n1(), Ncol), overwritten by X
+    void solve(T *x, Long_I Ncol = 1) const;
+    template <class Tx, SLS_IF(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+    void solve(Tx &x) const;
+};
+
+template <class T>
+LuBand<T>::LuBand() : m_N(0), m_Nup(0), m_Nlow(0), m_lu(0, 0), m_ipiv(0) {}
+
+template <class T>
+LuBand<T>::LuBand(const Band<T> &a) : LuBand()
+{
+    factor(a);
+}
+
+template <class T>
+LuBand<T>::LuBand(const CmatObd<T> &a) : LuBand()
+{
+    factor(a);
+}
+
+template <class T>
+void LuBand<T>::factor(const CmatObd<T> &a)
+{
+    Band<T> b(0, 0, 0, 0);
+    cmatobd2band(b, a);
+    factor(b);
+}
+
+template <class T>
+void LuBand<T>::factor(const Band<T> &a)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n1() != a.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    Long N = m_N = a.n1(), kl = m_Nlow = a.nlow(), ku = m_Nup = a.nup();
+    Long kv = ku + kl;
+    m_lu.resize(kv + kl + 1, N);
+    m_ipiv.resize(N);
+    m_lu = 0;
+    for (Long j = 0; j < N; ++j)
+        veccpy(&m_lu(kl, j), &a.m_a(0, j), kv + 1);
+
+    Long ju = 0; // last column affected by the row interchanges so far
+    for (Long j = 0; j < N; ++j) {
+        Long km = MIN(kl, N - 1 - j);
+        T *col = &m_lu(kv, j); // col[r] = A(j+r, j)
+        // find pivot
+        Long p = 0;
+        Doub amax = abs(col[0]);
+        for (Long r = 1; r <= km; ++r) {
+            if (abs(col[r]) > amax) {
+                amax = abs(col[r]); p = r;
+            }
+        }
+        m_ipiv[j] = j + p;
+        if (col[p] == T(0))
+            SLS_ERR("LuBand: matrix is singular!");
+        ju = MAX(ju, MIN(j + ku + p, N - 1));
+        // interchange rows j and j+p in columns [j, ju]
+        if (p != 0) {
+            for (Long c = j; c <= ju; ++c)
+                swap(m_lu(kv + j - c, c), m_lu(kv + j + p - c, c));
+        }
+        // compute multipliers and update the trailing sub-matrix
+        T s = T(1) / col[0];
+        for (Long r = 1; r <= km; ++r)
+            col[r] *= s;
+        for (Long c = j + 1; c <= ju; ++c) {
+            T *col_c = &m_lu(kv + j - c, c); // col_c[r] = A(j+r, c)
+            T t = col_c[0];
+            if (t == T(0))
+                continue;
+            for (Long r = 1; r <= km; ++r)
+                col_c[r] -= col[r] * t;
+        }
+    }
+}
+
+template <class T>
+Long LuBand<T>::n1() const
+{
+    return m_N;
+}
+
+template <class T>
+Long LuBand<T>::n2() const
+{
+    return m_N;
+}
+
+template <class T>
+void LuBand<T>::solve(T *x, Long_I Ncol) const
+{
+    Long N = m_N, kl = m_Nlow, kv = m_Nup + m_Nlow;
+    // L * Y = P * B
+    for (Long j = 0; j < N; ++j) {
+        Long km = MIN(kl, N - 1 - j), p = m_ipiv[j];
+        const T *col = &m_lu(kv, j);
+        for (Long c = 0; c < Ncol; ++c) {
+            T *xc = x + N * c;
+            if (p != j)
+                swap(xc[j], xc[p]);
+            T s = xc[j];
+            for (Long r = 1; r <= km; ++r)
+                xc[j + r] -= col[r] * s;
+        }
+    }
+    // U * X = Y
+    for (Long j = N - 1; j >= 0; --j) {
+        Long km = MIN(kv, j);
+        const T *col = &m_lu(kv, j); // col[-r] = U(j-r, j)
+        for (Long c = 0; c < Ncol; ++c) {
+            T *xc = x + N * c;
+            T s = (xc[j] /= col[0]);
+            for (Long r = 1; r <= km; ++r)
+                xc[j - r] -= col[-r] * s;
+        }
+    }
+}
+
+template <class T>
+template <class Tx, SLS_IF0(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+void LuBand<T>::solve(Tx &x) const
+{
+    static_assert(is_same<contain_type<Tx>, T>(), "type mismatch!");
+#ifdef SLS_CHECK_SHAPE
+    if (x.size() % m_N != 0)
+        SLS_ERR("wrong shape!");
+#endif
+    solve(x.ptr(), m_N == 0 ? 0 : x.size() / m_N);
+}
+
+// L*D*L^H decomposition without pivoting for a Hermitian (or real symmetric) band matrix
+// only the lower triangle is used
+// stable for positive definite matrices, D is real
+template <class T>
+class LdlBand
+{
+private:
+    Long m_N, m_Nlow;
+    Cmat<T> m_l; // (Nlow+1, N), L(i,j) is m_l(i-j, j), m_l(0, j) is not used
+    Vector<rm_comp<T>> m_d;
+public:
+    LdlBand();
+    LdlBand(const Band<T> &a);
+    LdlBand(const CmatObd<T> &a);
+    void factor(const Band<T> &a);
+    void factor(const CmatObd<T> &a);
+    Long n1() const;
+    Long n2() const;
+    const Vector<rm_comp<T>> &diag() const; // D
+    // solve A*X = B, B is column major (n1(), Ncol), overwritten by X
+    void solve(T *x, Long_I Ncol = 1) const;
+    template <class Tx, SLS_IF(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+    void solve(Tx &x) const;
+};
+
+template <class T>
+LdlBand<T>::LdlBand() : m_N(0), m_Nlow(0), m_l(0, 0), m_d(0) {}
+
+template <class T>
+LdlBand<T>::LdlBand(const Band<T> &a) : LdlBand()
+{
+    factor(a);
+}
+
+template <class T>
+LdlBand<T>::LdlBand(const CmatObd<T> &a) : LdlBand()
+{
+    factor(a);
+}
+
+template <class T>
+void LdlBand<T>::factor(const CmatObd<T> &a)
+{
+    Band<T> b(0, 0, 0, 0);
+    cmatobd2band(b, a);
+    factor(b);
+}
+
+template <class T>
+void LdlBand<T>::factor(const Band<T> &a)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n1() != a.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    Long N = m_N = a.n1(), k = m_Nlow = a.nlow(), ku = a.nup();
+    m_l.resize(k + 1, N);
+    m_d.resize(N);
+    for (Long j = 0; j < N; ++j)
+        veccpy(&m_l(0, j), &a.m_a(ku, j), k + 1);
+
+    for (Long j = 0; j < N; ++j) {
+        Long km = MIN(k, N - 1 - j);
+        T *col = &m_l(0, j); // col[r] = A(j+r, j)
+        rm_comp<T> d = real(col[0]);
+        if (d == 0)
+            SLS_ERR("LdlBand: zero pivot, matrix is singular or indefinite!");
+        m_d[j] = d;
+        // A(j+r, j+c) -= A(j+r, j) * conj(A(j+c, j)) / d, for r >= c >= 1
+        for (Long c = 1; c <= km; ++c) {
+            T t = CONJ(col[c]) / d;
+            T *col_c = &m_l(0, j + c) - c; // col_c[r] = A(j+r, j+c)
+            for (Long r = c; r <= km; ++r)
+                col_c[r] -= col[r] * t;
+        }
+        for (Long r = 1; r <= km; ++r)
+            col[r] /= d;
+    }
+}
+
+template <class T>
+Long LdlBand<T>::n1() const
+{
+    return m_N;
+}
+
+template <class T>
+Long LdlBand<T>::n2() const
+{
+    return m_N;
+}
+
+template <class T>
+const Vector<rm_comp<T>> &LdlBand<T>::diag() const
+{
+    return m_d;
+}
+
+template <class T>
+void LdlBand<T>::solve(T *x, Long_I Ncol) const
+{
+    Long N = m_N, k = m_Nlow;
+    // L * Y = B
+    for (Long j = 0; j < N; ++j) {
+        Long km = MIN(k, N - 1 - j);
+        const T *col = &m_l(0, j);
+        for (Long c = 0; c < Ncol; ++c) {
+            T *xc = x + N * c;
+            T s = xc[j];
+            for (Long r = 1; r <= km; ++r)
+                xc[j + r] -= col[r] * s;
+        }
+    }
+    // D * L^H * X = Y
+    for (Long j = N - 1; j >= 0; --j) {
+        Long km = MIN(k, N - 1 - j);
+        const T *col = &m_l(0, j);
+        for (Long c = 0; c < Ncol; ++c) {
+            T *xc = x + N * c;
+            T s = xc[j] / m_d[j];
+            for (Long r = 1; r <= km; ++r)
+                s -= CONJ(col[r]) * xc[j + r];
+            xc[j] = s;
+        }
+    }
+}
+
+template <class T>
+template <class Tx, SLS_IF0(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+void LdlBand<T>::solve(Tx &x) const
+{
+    static_assert(is_same<contain_type<Tx>, T>(), "type mismatch!");
+#ifdef SLS_CHECK_SHAPE
+    if (x.size() % m_N != 0)
+        SLS_ERR("wrong shape!");
+#endif
+    solve(x.ptr(), m_N == 0 ? 0 : x.size() / m_N);
+}
+
+} // namespace slisc
@@ -28,10 +28,10 @@ public:
     template <class Tmat, SLS_IF(is_dense_mat<Tmat>())>
     Cmat & operator=(const Tmat &rhs);
     Cmat & operator=(const T &rhs);
-    template <class T1>
-    Cmat & operator=(const MatCoo<T1> &rhs);
-    template <class T1>
-    Cmat & operator=(const MatCooH<T1> &rhs);
+    template <class T1, class Tind>
+    Cmat & operator=(const MatCoo<T1, Tind> &rhs);
+    template <class T1, class Tind>
+    Cmat & operator=(const MatCooH<T1, Tind> &rhs);
 #ifdef _CUSLISC_
     Cmat & operator=(const Gcmat<T> &rhs) // copy from GPU vector
     { rhs.get(*this); return *this; }
@@ -89,14 +89,14 @@ inline Cmat<T> & Cmat<T>::operator=(const T &rhs)
     return *this;
 }
 
-template <class T> template <class T1>
-inline Cmat<T> & Cmat<T>::operator=(const MatCoo<T1> &rhs)
+template <class T> template <class T1, class Tind>
+inline Cmat<T> & Cmat<T>::operator=(const MatCoo<T1, Tind> &rhs)
 {
     return coo2dense(*this, rhs);
 }
 
-template <class T> template <class T1>
-inline Cmat<T> & Cmat<T>::operator=(const MatCooH<T1> &rhs)
+template <class T> template <class T1, class Tind>
+inline Cmat<T> & Cmat<T>::operator=(const MatCooH<T1, Tind> &rhs)
 {
     return cooh2dense(*this, rhs);
 }
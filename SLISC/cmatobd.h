@@ -22,8 +22,8 @@ public:
     Long find(Long_I i, Long_I j);
     template <class T1, SLS_IF(is_promo<T, T1>())>
     CmatObd &operator=(const CmatObd<T1> &rhs);
-    template <class T1, SLS_IF(is_promo<T, T1>())>
-    CmatObd &operator=(const MatCoo<T1> &rhs);
+    template <class T1, class Tind, SLS_IF(is_promo<T, T1>())>
+    CmatObd &operator=(const MatCoo<T1, Tind> &rhs);
     template <class T1, SLS_IF(is_promo<T, T1>())>
     CmatObd &operator=(const Cmat3d<T1> &a);
     const T * ptr() const; // not the first element!
@@ -104,8 +104,8 @@ CmatObd<T> &CmatObd<T>::operator=(const CmatObd<T1> &a)
 
 // convert Mcoo matrix to MatOdb matrix
 template <class T>
-template <class T1, SLS_IF0(is_promo<T, T1>())>
-CmatObd<T> &CmatObd<T>::operator=(const MatCoo<T1> &a)
+template <class T1, class Tind, SLS_IF0(is_promo<T, T1>())>
+CmatObd<T> &CmatObd<T>::operator=(const MatCoo<T1, Tind> &a)
 {
 #ifdef SLS_CHECK_SHAPE
     if (!shape_cmp(*this, a))
@@ -0,0 +1,218 @@
+// lossless compression of binary data
+// byte-shuffle filter followed by a built-in LZ codec (or zlib if SLS_USE_ZLIB is defined)
+// compression method: 0: none, 1: byte-shuffle + LZ, 2: byte-shuffle + zlib
+
+#pragma once
+#include "scalar_arith.h"
+#ifdef SLS_USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace slisc {
+
+// byte-shuffle: put the k-th byte of every element together
+// so that similar bytes (e.g. sign and exponent of floating point numbers) are adjacent
+// N is the number of elements
+inline void byte_shuffle(Uchar *out, const Uchar *in, Long_I N, Int_I elm_size)
+{
+    for (Long i = 0; i < N; ++i)
+        for (Int k = 0; k < elm_size; ++k)
+            out[k*N + i] = in[i*elm_size + k];
+}
+
+inline void byte_unshuffle(Uchar *out, const Uchar *in, Long_I N, Int_I elm_size)
+{
+    for (Int k = 0; k < elm_size; ++k)
+        for (Long i = 0; i < N; ++i)
+            out[i*elm_size + k] = in[k*N + i];
+}
+
+// === LZ codec ===
+// a byte-oriented LZ77 format similar to LZ4:
+// each sequence is a token byte (high 4 bits: number of literals, low 4 bits: match length - 4),
+// optional length bytes for literals, literals, 2-byte offset, optional length bytes for match.
+// a length of 15 in the token is followed by bytes added to the length until a byte is not 255.
+// the last sequence has literals only.
+
+// write the extra length bytes
+inline Bool lz_put_len(Uchar *out, Long_IO op, Long_I Nout, Long len)
+{
+    for (; len >= 255; len -= 255) {
+        if (op >= Nout) return false;
+        out[op++] = 255;
+    }
+    if (op >= Nout) return false;
+    out[op++] = (Uchar)len;
+    return true;
+}
+
+// read the extra length bytes
+inline Bool lz_get_len(const Uchar *in, Long_IO ip, Long_I N, Long_IO len)
+{
+    Uchar b;
+    do {
+        if (ip >= N) return false;
+        b = in[ip++];
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+// compress N bytes, return compressed size
+// return -1 if compressed size would exceed Nout
+inline Long lz_compress(Uchar *out, Long_I Nout, const Uchar *in, Long_I N)
+{
+    const Int hash_bits = 14;
+    const Long max_off = 65535;
+    Long ip = 0, op = 0, anchor = 0, ref, lit, len, off;
+    Uint seq, h;
+    vector<Long> table(1 << hash_bits, -1);
+
+    while (ip + 4 <= N) {
+        memcpy(&seq, in + ip, 4);
+        h = (seq * 2654435761U) >> (32 - hash_bits);
+        ref = table[h]; table[h] = ip;
+        if (ref < 0 || ip - ref > max_off || memcmp(in + ref, in + ip, 4) != 0) {
+            // skip faster in incompressible data
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+        len = 4;
+        while (ip + len < N && in[ref + len] == in[ip + len])
+            ++len;
+        // token and literals
+        lit = ip - anchor; off = ip - ref;
+        if (op >= Nout) return -1;
+        Long itoken = op++;
+        out[itoken] = (Uchar)((MIN(lit, (Long)15) << 4) | MIN(len - 4, (Long)15));
+        if (lit >= 15 && !lz_put_len(out, op, Nout, lit - 15))
+            return -1;
+        if (op + lit + 2 > Nout) return -1;
+        memcpy(out + op, in + anchor, lit); op += lit;
+        // offset and match length
+        out[op++] = (Uchar)(off & 255); out[op++] = (Uchar)(off >> 8);
+        if (len - 4 >= 15 && !lz_put_len(out, op, Nout, len - 19))
+            return -1;
+        ip += len; anchor = ip;
+    }
+    // last literals
+    lit = N - anchor;
+    if (op >= Nout) return -1;
+    out[op++] = (Uchar)(MIN(lit, (Long)15) << 4);
+    if (lit >= 15 && !lz_put_len(out, op, Nout, lit - 15))
+        return -1;
+    if (op + lit > Nout) return -1;
+    memcpy(out + op, in + anchor, lit); op += lit;
+    return op;
+}
+
+// decompress, return decompressed size
+// return -1 if data is corrupted or decompressed size would exceed Nout
+inline Long lz_decompress(Uchar *out, Long_I Nout, const Uchar *in, Long_I N)
+{
+    Long ip = 0, op = 0, len, off;
+    Uchar token;
+    while (ip < N) {
+        token = in[ip++];
+        // literals
+        len = token >> 4;
+        if (len == 15 && !lz_get_len(in, ip, N, len))
+            return -1;
+        if (ip + len > N || op + len > Nout)
+            return -1;
+        memcpy(out + op, in + ip, len);
+        ip += len; op += len;
+        if (ip == N)
+            break;
+        // match
+        if (ip + 2 > N)
+            return -1;
+        off = (Long)in[ip] | ((Long)in[ip + 1] << 8); ip += 2;
+        if (off == 0 || off > op)
+            return -1;
+        len = token & 15;
+        if (len == 15 && !lz_get_len(in, ip, N, len))
+            return -1;
+        len += 4;
+        if (op + len > Nout)
+            return -1;
+        if (off >= len)
+            memcpy(out + op, out + op - off, len);
+        else // overlapping copy
+            for (Long i = 0; i < len; ++i)
+                out[op + i] = out[op - off + i];
+        op += len;
+    }
+    return op;
+}
+
+// === buffer compression ===
+
+// compress N bytes of elements (elm_size bytes each) with a method
+// return the method used, which is 0 (data copied) if the data can not be compressed
+inline Int compress_buf(vector<Uchar> &out, const Uchar *in, Long_I N, Int_I elm_size, Int_I method)
+{
+    if (method != 0 && N > 0 && N % elm_size == 0) {
+        vector<Uchar> buf(N);
+        byte_shuffle(buf.data(), in, N / elm_size, elm_size);
+        out.resize(N);
+        if (method == 1) {
+            Long Nout = lz_compress(out.data(), N, buf.data(), N);
+            if (Nout >= 0) {
+                out.resize(Nout);
+                return 1;
+            }
+        }
+        else if (method == 2) {
+#ifdef SLS_USE_ZLIB
+            uLongf Nout = compressBound(N);
+            out.resize(Nout);
+            if (compress2(out.data(), &Nout, buf.data(), N, 1) == Z_OK && (Long)Nout < N) {
+                out.resize(Nout);
+                return 2;
+            }
+#else
+            SLS_ERR("zlib compression requires SLS_USE_ZLIB!");
+#endif
+        }
+        else
+            SLS_ERR("unknown compression method!");
+    }
+    out.resize(N);
+    if (N > 0)
+        memcpy(out.data(), in, N);
+    return 0;
+}
+
+// decompress to N bytes, reverse of compress_buf()
+// return 0 if successful, -1 if data is corrupted
+inline Int decompress_buf(Uchar *out, Long_I N, const Uchar *in, Long_I Nin, Int_I elm_size, Int_I method)
+{
+    if (method == 0) {
+        if (Nin != N)
+            return -1;
+        if (N > 0)
+            memcpy(out, in, N);
+        return 0;
+    }
+    vector<Uchar> buf(N);
+    if (method == 1) {
+        if (lz_decompress(buf.data(), N, in, Nin) != N)
+            return -1;
+    }
+    else if (method == 2) {
+#ifdef SLS_USE_ZLIB
+        uLongf Nout = N;
+        if (uncompress(buf.data(), &Nout, in, Nin) != Z_OK || (Long)Nout != N)
+            return -1;
+#else
+        SLS_ERR("zlib compression requires SLS_USE_ZLIB!");
+#endif
+    }
+    else
+        return -1;
+    byte_unshuffle(out, buf.data(), N / elm_size, elm_size);
+    return 0;
+}
+
+} // namespace slisc
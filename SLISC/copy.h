@@ -217,8 +217,9 @@ inline void copy(Jcmat3d<T> &a, const Jcmat3d<T1> &a1)
 
 // for sparse containers
 
-template <class T, class T1, SLS_IF(is_promo<T,T1>())>
-void copy(MatCoo<T> &v, const MatCoo<T1> &v1)
+// can also convert between index types
+template <class T, class Tind, class T1, class Tind1, SLS_IF(is_promo<T,T1>())>
+void copy(MatCoo<T, Tind> &v, const MatCoo<T1, Tind1> &v1)
 {
 #ifdef SLS_CHECK_SHAPE
     if (!shape_cmp(v, v1))
@@ -234,12 +235,17 @@ void copy(MatCoo<T> &v, const MatCoo<T1> &v1)
     Long Nnz = v1.nnz();
     v.resize(Nnz);
     veccpy(v.ptr(), v1.ptr(), Nnz);
-    veccpy(v.row_ptr(), v1.row_ptr(), Nnz);
-    veccpy(v.col_ptr(), v1.col_ptr(), Nnz);
+    Tind *row = v.row_ptr(), *col = v.col_ptr();
+    const Tind1 *row1 = v1.row_ptr(), *col1 = v1.col_ptr();
+    for (Long i = 0; i < Nnz; ++i) {
+        row[i] = Tind(row1[i]); col[i] = Tind(col1[i]);
+    }
+    if (v1.sorted())
+        v.update_sorted();
 }
 
-template <class T, class T1, SLS_IF(is_promo<T, T1>())>
-void copy(MatCoo<T> &v, const CmatObd<T1> &v1)
+template <class T, class Tind, class T1, SLS_IF(is_promo<T, T1>())>
+void copy(MatCoo<T, Tind> &v, const CmatObd<T1> &v1)
 {
 #ifdef SLS_CHECK_SHAPE
     if (!shape_cmp(v, v1))
@@ -1,29 +1,53 @@
 // evaluate (radial) coulomb wavefunctions and their derivatives
 // Note that F, dF could be calculated simultaneously with no extra cost
-// TODO : implement G, dG
+// G, dG are calculated together with F, dF
 #pragma once
-#include "global.h"
+#include "arithmetic.h"
 #include "cwfcomp/cwfcomp.h"
-#ifdef SLS_USE_GSL
-#include <gsl/gsl_sf_gamma.h>
-#include <gsl/gsl_errno.h>
-#endif
 
 namespace slisc {
 using cwfcomp::Coulomb_wave_functions;
 
 // === coulomb phase shift ===
-#ifdef SLS_USE_GSL
-Doub coulomb_sigma(Int_I l, Doub_I eta)
+// sigma_l(eta) = arg(Gamma(l + 1 + i*eta)), reduced to (-pi, pi] (same as GSL)
+
+inline Doub coulomb_sigma_reduce(Doub_I sigma)
+{
+    Doub s = sigma - 2 * PI * floor(sigma / (2 * PI));
+    return s > PI ? s - 2 * PI : s;
+}
+
+inline Doub coulomb_sigma(Int_I l, Doub_I eta)
 {
     if (eta > 0)
         SLS_ERR("are you sure?");
-    gsl_sf_result lnr, arg;
-    if (gsl_sf_lngamma_complex_e(l + 1, eta, &lnr, &arg) == GSL_ELOSS)
-        SLS_ERR("arg has loss!");
-    return arg.val;
+    return coulomb_sigma_reduce(imag(lngamma(Comp(l + 1, eta))));
 }
+
+// sigma(i, l) = sigma_l(eta[i]), l = 0, 1, ..., lmax
+// only sigma_0 needs lngamma(), then use sigma_{l+1} = sigma_l + atan(eta/(l+1))
+// each column is a contiguous loop over eta
+inline void coulomb_sigma(CmatDoub_O sigma, Int_I lmax, VecDoub_I eta)
+{
+    Long Neta = eta.size();
+#ifdef SLS_CHECK_SHAPE
+    if (sigma.n1() != Neta || sigma.n2() != lmax + 1)
+        SLS_ERR("wrong shape!");
 #endif
+    Doub *s = sigma.ptr();
+    for (Long i = 0; i < Neta; ++i)
+        s[i] = imag(lngamma(Comp(1, eta[i])));
+    for (Int l = 1; l <= lmax; ++l) {
+        Doub *s1 = s + Neta;
+        Doub inv_l = 1. / l;
+        for (Long i = 0; i < Neta; ++i)
+            s1[i] = s[i] + atan(eta[i] * inv_l);
+        s = s1;
+    }
+    s = sigma.ptr();
+    for (Long i = 0; i < sigma.size(); ++i)
+        s[i] = coulomb_sigma_reduce(s[i]);
+}
 
 // === coulombF() ===
 // efficiency is about 1e-4s/evaluation
@@ -101,7 +125,7 @@ inline void coulombFDF(Doub_O F, Doub_O dF, Int_I l, Doub_I k, Doub_I r, Doub_I
     Comp F1, dF1;
     cwfcomp::Coulomb_wave_functions f(true, l, Z / k);
     f.F_dF(k*r, F1, dF1);
-    F = real(F1); dF1 = real(dF1);
+    F = real(F1); dF = real(dF1);
 }
 
 // for vector/matrix and tensor
@@ -135,4 +159,231 @@ inline void coulombFDF(Mat3Doub &F, Vbase<Doub> &dF, Int_I l, Doub_I k, Mat3Doub
     F.resize(r); coulombFDF0(F, dF, l, k, r, Z);
 }
 
+// === batched coulombF() and coulombDF() along a sorted grid ===
+// seed with cwfcomp at the first point of each chunk, then march outward with Taylor series
+// the regular function F is dominant in the outward direction, so marching is stable
+// each chunk has coulomb_chunk points, chunks (and channels) are independent
+
+const Long coulomb_chunk = 256;
+// below this rho = k*r, use cwfcomp for each point (Taylor series converges slowly near 0)
+const Doub coulomb_rho_min = 1.;
+
+// one Taylor step of u'' = (l(l+1)/rho^2 + 2*eta/rho - 1) u, from rho0 to rho0 + h
+// need |h| <= rho0/2 for fast convergence, accurate to machine precision
+inline void coulomb_taylor(Doub_IO u, Doub_IO du, Doub_I rho0, Doub_I h, Int_I l, Doub_I eta)
+{
+    Doub L = l * (l + 1.), rho2 = rho0 * rho0;
+    Doub c0 = L + 2 * eta * rho0 - rho2, c1 = 2 * (eta - rho0);
+    // a[n] are the Taylor coefficients times h^n
+    Doub a_2 = 0, a_1 = 0, a0 = u, a1 = du * h;
+    Doub sum = a0 + a1, dsum = a1; // dsum is h * u'
+    Doub scale = abs(a0) + abs(a1), h2 = h * h;
+    for (Long n = 0; n < 500; ++n) {
+        Doub a2 = ((c0 - n * (n - 1.)) * a0 * h2 + c1 * a_1 * h2 * h - a_2 * h2 * h2
+            - 2 * rho0 * (n + 1.) * n * a1 * h) / (rho2 * (n + 2.) * (n + 1.));
+        sum += a2; dsum += (n + 2) * a2;
+        scale = MAX(scale, abs(a2));
+        if (n > 3 && abs(a2) + abs(a1) < 1e-17 * scale)
+            break;
+        a_2 = a_1; a_1 = a0; a0 = a1; a1 = a2;
+    }
+    u = sum; du = dsum / h;
+}
+
+// F and dF (w.r.t. k*r) for one chunk, r[0] < r[1] < ... < r[N-1]
+inline void coulombFDF_chunk(Doub *F, Doub *dF, Int_I l, Doub_I k, const Doub *r, Long_I N, Doub_I Z)
+{
+    Doub eta = Z / k;
+    Comp F1, dF1;
+    Long i = 0;
+    // small rho, or seed
+    for (; i < N; ++i) {
+        cwfcomp::Coulomb_wave_functions f(true, l, eta);
+        f.F_dF(k * r[i], F1, dF1);
+        F[i] = real(F1); dF[i] = real(dF1);
+        if (k * r[i] >= coulomb_rho_min)
+            break;
+    }
+    // march outward
+    for (++i; i < N; ++i) {
+        Doub rho = k * r[i - 1], rho1 = k * r[i], u = F[i - 1], du = dF[i - 1];
+        if (rho1 < rho)
+            SLS_ERR("r must be sorted!");
+        while (rho < rho1) {
+            Doub h = MIN(rho1 - rho, MIN(0.5 * rho, 2.));
+            coulomb_taylor(u, du, rho, h, l, eta);
+            rho += h;
+            if (rho1 - rho < 1e-14 * rho1)
+                break;
+        }
+        F[i] = u; dF[i] = du;
+    }
+}
+
+// F, dF for a sorted r (ascending, r >= 0), same accuracy as the point-wise version, much faster
+template <class Tv, class Tv1, SLS_IF(is_dense<Tv>() && is_dense<Tv1>() &&
+    is_Doub<contain_type<Tv>>() && is_Doub<contain_type<Tv1>>())>
+inline void coulombFDF_sorted(Tv &F, Tv &dF, Int_I l, Doub_I k, const Tv1 &r, Doub_I Z = -1.)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (!shape_cmp(F, r) || !shape_cmp(dF, r))
+        SLS_ERR("wrong shape!");
+#endif
+    Long N = r.size();
+    for (Long i = 0; i < N; i += coulomb_chunk)
+        coulombFDF_chunk(F.ptr() + i, dF.ptr() + i, l, k, r.ptr() + i, MIN(coulomb_chunk, N - i), Z);
+}
+
+// F(:, j), dF(:, j) for channels (l[j], k[j]), sorted r, parallel over channels and chunks of r
+inline void coulombFDF_par(CmatDoub_O F, CmatDoub_O dF, VecInt_I l, VecDoub_I k, VecDoub_I r, Doub_I Z = -1.)
+{
+    Long N = r.size(), Nch = l.size(), Nchunk = (N + coulomb_chunk - 1) / coulomb_chunk;
+#ifdef SLS_CHECK_SHAPE
+    if (k.size() != Nch || F.n1() != N || F.n2() != Nch || !shape_cmp(F, dF))
+        SLS_ERR("wrong shape!");
+#endif
+#pragma omp parallel for schedule(dynamic)
+    for (Long m = 0; m < Nch * Nchunk; ++m) {
+        Long j = m / Nchunk, i = coulomb_chunk * (m % Nchunk);
+        coulombFDF_chunk(&F(i, j), &dF(i, j), l[j], k[j], r.ptr() + i, MIN(coulomb_chunk, N - i), Z);
+    }
+}
+
+// === coulombG(), coulombFG(), coulombFGDG() ===
+// F, G and derivatives (w.r.t. k*r), using H+ = G + iF
+inline void coulomb_cwf(Doub_O F, Doub_O G, Doub_O dF, Doub_O dG, Int_I l, Doub_I eta, Doub_I rho)
+{
+    Comp F1, dF1, H, dH;
+    cwfcomp::Coulomb_wave_functions f(true, l, eta);
+    f.F_dF(rho, F1, dF1);
+    f.H_dH(1, rho, H, dH);
+    F = real(F1); dF = real(dF1);
+    G = real(H) + imag(F1); dG = real(dH) + imag(dF1); // G = H+ - iF
+}
+
+// for scalar
+inline Doub coulombG(Int_I l, Doub_I k, Doub_I r, Doub_I Z = -1.)
+{
+    Doub F, G, dF, dG;
+    coulomb_cwf(F, G, dF, dG, l, Z / k, k * r);
+    return G;
+}
+
+inline void coulombFGDG(Doub_O F, Doub_O G, Doub_O dF, Doub_O dG, Int_I l, Doub_I k, Doub_I r, Doub_I Z = -1.)
+{
+    coulomb_cwf(F, G, dF, dG, l, Z / k, k * r);
+}
+
+// F, G, dF, dG for one chunk, r[0] < r[1] < ... < r[N-1]
+// F is marched outward (coulombFDF_chunk())
+// G is marched outward from the turning point (oscillatory region)
+// and inward from the turning point (G is dominant inward in the classically forbidden region)
+// k*r < coulomb_rho_min uses cwfcomp (power series) for each point
+inline void coulombFGDG_chunk(Doub *F, Doub *G, Doub *dF, Doub *dG, Int_I l, Doub_I k,
+    const Doub *r, Long_I N, Doub_I Z)
+{
+    if (N == 0)
+        return;
+    coulombFDF_chunk(F, dF, l, k, r, N, Z);
+    Doub eta = Z / k, Ftmp, dFtmp;
+    Doub rho_tp = MAX(eta + sqrt(eta * eta + l * (l + 1.)), coulomb_rho_min);
+    Long i_tp = 0;
+    while (i_tp < N && k * r[i_tp] < rho_tp)
+        ++i_tp;
+    // outward
+    if (i_tp < N) {
+        coulomb_cwf(Ftmp, G[i_tp], dFtmp, dG[i_tp], l, eta, k * r[i_tp]);
+        for (Long i = i_tp + 1; i < N; ++i) {
+            Doub rho = k * r[i - 1], rho1 = k * r[i], u = G[i - 1], du = dG[i - 1];
+            while (rho < rho1) {
+                Doub h = MIN(rho1 - rho, MIN(0.5 * rho, 2.));
+                coulomb_taylor(u, du, rho, h, l, eta);
+                rho += h;
+                if (rho1 - rho < 1e-14 * rho1)
+                    break;
+            }
+            G[i] = u; dG[i] = du;
+        }
+    }
+    // inward
+    for (Long i = i_tp - 1; i >= 0; --i) {
+        Doub rho1 = k * r[i];
+        if (rho1 < coulomb_rho_min || i == N - 1) {
+            coulomb_cwf(Ftmp, G[i], dFtmp, dG[i], l, eta, rho1);
+            continue;
+        }
+        Doub rho = k * r[i + 1], u = G[i + 1], du = dG[i + 1];
+        while (rho > rho1) {
+            Doub h = MIN(rho - rho1, MIN(0.5 * rho, 2.));
+            coulomb_taylor(u, du, rho, -h, l, eta);
+            rho -= h;
+            if (rho - rho1 < 1e-14 * rho1)
+                break;
+        }
+        G[i] = u; dG[i] = du;
+    }
+}
+
+// F, G, dF, dG for N sorted points, chunk by chunk
+inline void coulombFGDG_sorted(Doub *F, Doub *G, Doub *dF, Doub *dG, Int_I l, Doub_I k,
+    const Doub *r, Long_I N, Doub_I Z)
+{
+    for (Long i = 0; i < N; i += coulomb_chunk)
+        coulombFGDG_chunk(F + i, G + i, dF + i, dG + i, l, k, r + i, MIN(coulomb_chunk, N - i), Z);
+}
+
+// F, G, dF, dG for a sorted r (ascending, r >= 0)
+template <class Tv, class Tv1, SLS_IF(is_dense<Tv>() && is_dense<Tv1>() &&
+    is_Doub<contain_type<Tv>>() && is_Doub<contain_type<Tv1>>())>
+inline void coulombFGDG(Tv &F, Tv &G, Tv &dF, Tv &dG, Int_I l, Doub_I k, const Tv1 &r, Doub_I Z = -1.)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (!shape_cmp(F, r) || !shape_cmp(G, r) || !shape_cmp(dF, r) || !shape_cmp(dG, r))
+        SLS_ERR("wrong shape!");
+#endif
+    if (r.size() > 0)
+        coulombFGDG_sorted(F.ptr(), G.ptr(), dF.ptr(), dG.ptr(), l, k, r.ptr(), r.size(), Z);
+}
+
+template <class Tv, class Tv1, SLS_IF(is_dense<Tv>() && is_dense<Tv1>() &&
+    is_Doub<contain_type<Tv>>() && is_Doub<contain_type<Tv1>>())>
+inline void coulombFG(Tv &F, Tv &G, Int_I l, Doub_I k, const Tv1 &r, Doub_I Z = -1.)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (!shape_cmp(F, r) || !shape_cmp(G, r))
+        SLS_ERR("wrong shape!");
+#endif
+    if (r.size() == 0)
+        return;
+    VecDoub dF(r.size()), dG(r.size());
+    coulombFGDG_sorted(F.ptr(), G.ptr(), dF.ptr(), dG.ptr(), l, k, r.ptr(), r.size(), Z);
+}
+
+template <class Tv, class Tv1, SLS_IF(is_dense<Tv>() && is_dense<Tv1>() &&
+    is_Doub<contain_type<Tv>>() && is_Doub<contain_type<Tv1>>())>
+inline void coulombG(Tv &G, Int_I l, Doub_I k, const Tv1 &r, Doub_I Z = -1.)
+{
+    VecDoub F(r.size());
+    coulombFG(F, G, l, k, r, Z);
+}
+
+// F(:, j), G(:, j), dF(:, j), dG(:, j) for channels (l[j], k[j]), sorted r
+// parallel over channels and chunks of r
+inline void coulombFGDG_par(CmatDoub_O F, CmatDoub_O G, CmatDoub_O dF, CmatDoub_O dG,
+    VecInt_I l, VecDoub_I k, VecDoub_I r, Doub_I Z = -1.)
+{
+    Long N = r.size(), Nch = l.size(), Nchunk = (N + coulomb_chunk - 1) / coulomb_chunk;
+#ifdef SLS_CHECK_SHAPE
+    if (k.size() != Nch || F.n1() != N || F.n2() != Nch || !shape_cmp(F, G) ||
+        !shape_cmp(F, dF) || !shape_cmp(F, dG))
+        SLS_ERR("wrong shape!");
+#endif
+#pragma omp parallel for schedule(dynamic)
+    for (Long m = 0; m < Nch * Nchunk; ++m) {
+        Long j = m / Nchunk, i = coulomb_chunk * (m % Nchunk);
+        coulombFGDG_chunk(&F(i, j), &G(i, j), &dF(i, j), &dG(i, j), l[j], k[j],
+            r.ptr() + i, MIN(coulomb_chunk, N - i), Z);
+    }
+}
+
 } // namespace slisc
@@ -1,6 +1,6 @@
 // solve eigen problem
 #pragma once
-#include "cmat.h"
+#include "arithmetic.h"
 
 namespace slisc {
 
@@ -45,4 +45,188 @@ void eig_her(VecDoub_O eigVal, CmatComp_O eigVec, CmatComp_I A)
         SLS_ERR("failed!");
 }
 
+
+// ============ divide and conquer, and partial spectrum (MRRR) ============
+
+// reusable workspace for eig_sym_dc(), eig_her_dc(), eig_her_range(), eig_her_interval()
+// grows on demand and is never shrunk, keep one per thread
+template <class T>
+class EigWsp
+{
+public:
+    Vector<T> work;
+    VecDoub rwork; // only for complex
+    Vector<Int> iwork, isuppz;
+    Cmat<T> a; // copy of the input matrix for ?syevr/?heevr
+    EigWsp() : work(0), rwork(0), iwork(0), isuppz(0), a(0, 0) {}
+    // make sure size is at least N
+    template <class T1>
+    static void reserve(Vector<T1> &v, Long_I N)
+    {
+        if (v.size() < N) v.resize(N);
+    }
+};
+
+// lapack drivers, only column major, only upper triangle is used
+inline Int eig_lapack_evd(Char_I jobz, Int_I N, Doub *a, Doub *w, EigWsp<Doub> &wsp)
+{
+    Doub lwork; Int liwork;
+    LAPACKE_dsyevd_work(LAPACK_COL_MAJOR, jobz, 'U', N, a, N, w, &lwork, -1, &liwork, -1);
+    wsp.reserve(wsp.work, (Long)lwork); wsp.reserve(wsp.iwork, liwork);
+    return LAPACKE_dsyevd_work(LAPACK_COL_MAJOR, jobz, 'U', N, a, N, w,
+        wsp.work.ptr(), wsp.work.size(), wsp.iwork.ptr(), wsp.iwork.size());
+}
+
+inline Int eig_lapack_evd(Char_I jobz, Int_I N, Comp *a, Doub *w, EigWsp<Comp> &wsp)
+{
+    Comp lwork; Doub lrwork; Int liwork;
+    LAPACKE_zheevd_work(LAPACK_COL_MAJOR, jobz, 'U', N, (double _Complex*)a, N, w,
+        (double _Complex*)&lwork, -1, &lrwork, -1, &liwork, -1);
+    wsp.reserve(wsp.work, (Long)real(lwork)); wsp.reserve(wsp.rwork, (Long)lrwork);
+    wsp.reserve(wsp.iwork, liwork);
+    return LAPACKE_zheevd_work(LAPACK_COL_MAJOR, jobz, 'U', N, (double _Complex*)a, N, w,
+        (double _Complex*)wsp.work.ptr(), wsp.work.size(), wsp.rwork.ptr(), wsp.rwork.size(),
+        wsp.iwork.ptr(), wsp.iwork.size());
+}
+
+// range = 'I': il, iu are 1-based indices; range = 'V': eigen values in (vl, vu]
+// z has leading dimension N, Nfound is output
+inline Int eig_lapack_evr(Char_I range, Int_I N, Doub *a, Doub_I vl, Doub_I vu, Int_I il, Int_I iu,
+    Int_O Nfound, Doub *w, Doub *z, EigWsp<Doub> &wsp)
+{
+    Doub lwork; Int liwork;
+    wsp.reserve(wsp.isuppz, 2 * N);
+    LAPACKE_dsyevr_work(LAPACK_COL_MAJOR, 'V', range, 'U', N, a, N, vl, vu, il, iu, 0, &Nfound,
+        w, z, N, wsp.isuppz.ptr(), &lwork, -1, &liwork, -1);
+    wsp.reserve(wsp.work, (Long)lwork); wsp.reserve(wsp.iwork, liwork);
+    return LAPACKE_dsyevr_work(LAPACK_COL_MAJOR, 'V', range, 'U', N, a, N, vl, vu, il, iu, 0, &Nfound,
+        w, z, N, wsp.isuppz.ptr(), wsp.work.ptr(), wsp.work.size(), wsp.iwork.ptr(), wsp.iwork.size());
+}
+
+inline Int eig_lapack_evr(Char_I range, Int_I N, Comp *a, Doub_I vl, Doub_I vu, Int_I il, Int_I iu,
+    Int_O Nfound, Doub *w, Comp *z, EigWsp<Comp> &wsp)
+{
+    Comp lwork; Doub lrwork; Int liwork;
+    wsp.reserve(wsp.isuppz, 2 * N);
+    LAPACKE_zheevr_work(LAPACK_COL_MAJOR, 'V', range, 'U', N, (double _Complex*)a, N, vl, vu, il, iu, 0,
+        &Nfound, w, (double _Complex*)z, N, wsp.isuppz.ptr(), (double _Complex*)&lwork, -1,
+        &lrwork, -1, &liwork, -1);
+    wsp.reserve(wsp.work, (Long)real(lwork)); wsp.reserve(wsp.rwork, (Long)lrwork);
+    wsp.reserve(wsp.iwork, liwork);
+    return LAPACKE_zheevr_work(LAPACK_COL_MAJOR, 'V', range, 'U', N, (double _Complex*)a, N, vl, vu, il, iu, 0,
+        &Nfound, w, (double _Complex*)z, N, wsp.isuppz.ptr(), (double _Complex*)wsp.work.ptr(),
+        wsp.work.size(), wsp.rwork.ptr(), wsp.rwork.size(), wsp.iwork.ptr(), wsp.iwork.size());
+}
+
+// all eigen values and vectors by divide and conquer (?syevd/?heevd)
+// much faster than eig_sym()/eig_her() for large matrices
+// only upper triangle is needed, eigen values in ascending order
+template <class Tv, class Tmat, class Tmat2, class T = contain_type<Tmat>, SLS_IF(
+    is_dense_vec<Tv>() && is_Doub<contain_type<Tv>>() &&
+    is_dense_mat<Tmat>() && is_cmajor<Tmat>() && is_dense_mat<Tmat2>() && is_cmajor<Tmat2>() &&
+    is_same<T, contain_type<Tmat2>>() && (is_Doub<T>() || is_Comp<T>()))>
+void eig_her_dc(Tv &eigVal, Tmat &eigVec, const Tmat2 &A, EigWsp<T> &wsp)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (A.n1() != A.n2() || !shape_cmp(eigVec, A) || eigVal.size() != A.n1())
+        SLS_ERR("wrong shape!");
+#endif
+    eigVec = A;
+    if (eig_lapack_evd('V', (Int)A.n1(), eigVec.ptr(), eigVal.ptr(), wsp) != 0)
+        SLS_ERR("failed!");
+}
+
+template <class Tv, class Tmat, class Tmat2, class T = contain_type<Tmat>, SLS_IF(
+    is_dense_vec<Tv>() && is_dense_mat<Tmat>() && is_dense_mat<Tmat2>())>
+void eig_her_dc(Tv &eigVal, Tmat &eigVec, const Tmat2 &A)
+{
+    EigWsp<T> wsp;
+    eig_her_dc(eigVal, eigVec, A, wsp);
+}
+
+template <class Tv, class Tmat, class Tmat2, SLS_IF(
+    is_dense_vec<Tv>() && is_dense_mat<Tmat>() && is_Doub<contain_type<Tmat>>() && is_dense_mat<Tmat2>())>
+void eig_sym_dc(Tv &eigVal, Tmat &eigVec, const Tmat2 &A, EigWsp<Doub> &wsp)
+{
+    eig_her_dc(eigVal, eigVec, A, wsp);
+}
+
+template <class Tv, class Tmat, class Tmat2, SLS_IF(
+    is_dense_vec<Tv>() && is_dense_mat<Tmat>() && is_Doub<contain_type<Tmat>>() && is_dense_mat<Tmat2>())>
+void eig_sym_dc(Tv &eigVal, Tmat &eigVec, const Tmat2 &A)
+{
+    EigWsp<Doub> wsp;
+    eig_her_dc(eigVal, eigVec, A, wsp);
+}
+
+// eigen values with (0-based) indices il to iu (inclusive), ascending order, and the eigen vectors (?syevr/?heevr)
+// eigVal.size() == iu-il+1, eigVec is (N, iu-il+1), only upper triangle of A is needed
+// A can be real symmetric or Hermitian
+template <class Tv, class Tmat, class Tmat2, class T = contain_type<Tmat>, SLS_IF(
+    is_dense_vec<Tv>() && is_Doub<contain_type<Tv>>() &&
+    is_dense_mat<Tmat>() && is_cmajor<Tmat>() && is_dense_mat<Tmat2>() && is_cmajor<Tmat2>() &&
+    is_same<T, contain_type<Tmat2>>() && (is_Doub<T>() || is_Comp<T>()))>
+void eig_her_range(Tv &eigVal, Tmat &eigVec, const Tmat2 &A, Long_I il, Long_I iu, EigWsp<T> &wsp)
+{
+    Long N = A.n1(), Nev = iu - il + 1;
+#ifdef SLS_CHECK_SHAPE
+    if (A.n2() != N || il < 0 || iu >= N || Nev < 1 ||
+        eigVec.n1() != N || eigVec.n2() != Nev || eigVal.size() != Nev)
+        SLS_ERR("wrong shape!");
+#endif
+    if (wsp.a.n1() != N || wsp.a.n2() != N)
+        wsp.a.resize(N, N);
+    wsp.a = A;
+    Int Nfound;
+    if (eig_lapack_evr('I', (Int)N, wsp.a.ptr(), 0, 0, (Int)il + 1, (Int)iu + 1,
+            Nfound, eigVal.ptr(), eigVec.ptr(), wsp) != 0 || Nfound != Nev)
+        SLS_ERR("failed!");
+}
+
+template <class Tv, class Tmat, class Tmat2, class T = contain_type<Tmat>, SLS_IF(
+    is_dense_vec<Tv>() && is_dense_mat<Tmat>() && is_dense_mat<Tmat2>())>
+void eig_her_range(Tv &eigVal, Tmat &eigVec, const Tmat2 &A, Long_I il, Long_I iu)
+{
+    EigWsp<T> wsp;
+    eig_her_range(eigVal, eigVec, A, il, iu, wsp);
+}
+
+// eigen values in (vl, vu] in ascending order, and the eigen vectors, return the number found
+// eigVal and eigVec are resized to (Nfound) and (N, Nfound)
+template <class Tv, class Tmat, class Tmat2, class T = contain_type<Tmat>, SLS_IF(
+    is_dense_vec<Tv>() && is_Doub<contain_type<Tv>>() &&
+    is_dense_mat<Tmat>() && is_cmajor<Tmat>() && is_dense_mat<Tmat2>() && is_cmajor<Tmat2>() &&
+    is_same<T, contain_type<Tmat2>>() && (is_Doub<T>() || is_Comp<T>()))>
+Long eig_her_interval(Tv &eigVal, Tmat &eigVec, const Tmat2 &A, Doub_I vl, Doub_I vu, EigWsp<T> &wsp)
+{
+    Long N = A.n1();
+#ifdef SLS_CHECK_SHAPE
+    if (A.n2() != N)
+        SLS_ERR("wrong shape!");
+#endif
+    if (wsp.a.n1() != N || wsp.a.n2() != N)
+        wsp.a.resize(N, N);
+    wsp.a = A;
+    // the number of eigen values is unknown, so need space for N of them
+    if (eigVal.size() < N)
+        eigVal.resize(N);
+    if (eigVec.n1() != N || eigVec.n2() < N)
+        eigVec.resize(N, N);
+    Int Nfound;
+    if (eig_lapack_evr('V', (Int)N, wsp.a.ptr(), vl, vu, 0, 0, Nfound,
+            eigVal.ptr(), eigVec.ptr(), wsp) != 0)
+        SLS_ERR("failed!");
+    eigVal.resize_cpy(Nfound);
+    eigVec.resize_cpy(N, Nfound);
+    return Nfound;
+}
+
+template <class Tv, class Tmat, class Tmat2, class T = contain_type<Tmat>, SLS_IF(
+    is_dense_vec<Tv>() && is_dense_mat<Tmat>() && is_dense_mat<Tmat2>())>
+Long eig_her_interval(Tv &eigVal, Tmat &eigVec, const Tmat2 &A, Doub_I vl, Doub_I vu)
+{
+    EigWsp<T> wsp;
+    return eig_her_interval(eigVal, eigVec, A, vl, vu, wsp);
+}
+
 } // namespace slisc
@@ -0,0 +1,88 @@
+// batched eigen decomposition of many small Hermitian (or real symmetric) matrices
+// matrices of size N <= Njac use eig_her_jacobi(), others use ?syevd/?heevd (if SLS_USE_LAPACKE)
+// Jacobi is faster than LAPACK up to about N = 8 (without the call overhead and allocation)
+#pragma once
+#include "cmat3d.h"
+#include "copy.h"
+#include "eig_jacobi.h"
+#ifdef SLS_USE_LAPACKE
+#include "eig.h"
+#endif
+
+namespace slisc {
+
+// workspace for one thread
+template <class T>
+class EigBatchWsp
+{
+public:
+    Cmat<T> a; // copy of one matrix for eig_her_jacobi()
+#ifdef SLS_USE_LAPACKE
+    EigWsp<T> lapack;
+#endif
+    EigBatchWsp(Long_I N) : a(N, N) {}
+};
+
+// one matrix a (N, N), column major, both triangles are needed for N <= Njac
+template <class T>
+inline void eig_her_batch1(Doub *eigVal, T *eigVec, const T *a, Long_I N, Long_I Njac, EigBatchWsp<T> &wsp)
+{
+#ifdef SLS_USE_LAPACKE
+    if (N > Njac) {
+        veccpy(eigVec, a, N * N);
+        if (eig_lapack_evd('V', (Int)N, eigVec, eigVal, wsp.lapack) != 0)
+            SLS_ERR("failed!");
+        return;
+    }
+#endif
+    veccpy(wsp.a.ptr(), a, N * N);
+    eig_her_jacobi(eigVal, eigVec, wsp.a.ptr(), N);
+}
+
+// a(:, :, k) are Hermitian, k = 0, ..., Nbatch-1
+// eigVal(:, k) are eigen values of a(:, :, k) in ascending order, eigVec(:, :, k) the eigen vectors
+template <class Tv, class T, SLS_IF(
+    is_dense_mat<Tv>() && is_cmajor<Tv>() && is_Doub<contain_type<Tv>>() && (is_Doub<T>() || is_Comp<T>()))>
+inline void eig_her_batch(Tv &eigVal, Cmat3d<T> &eigVec, const Cmat3d<T> &a, Long_I Njac = 8)
+{
+    Long N = a.n1(), Nbatch = a.n3();
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != N || !shape_cmp(eigVec, a) || eigVal.n1() != N || eigVal.n2() != Nbatch)
+        SLS_ERR("wrong shape!");
+#endif
+    EigBatchWsp<T> wsp(N);
+    for (Long k = 0; k < Nbatch; ++k)
+        eig_her_batch1(eigVal.ptr() + N * k, eigVec.ptr() + N * N * k, a.ptr() + N * N * k, N, Njac, wsp);
+}
+
+template <class Tv, class T, SLS_IF(
+    is_dense_mat<Tv>() && is_cmajor<Tv>() && is_Doub<contain_type<Tv>>() && (is_Doub<T>() || is_Comp<T>()))>
+inline void eig_her_batch_par(Tv &eigVal, Cmat3d<T> &eigVec, const Cmat3d<T> &a, Long_I Njac = 8)
+{
+    Long N = a.n1(), Nbatch = a.n3();
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != N || !shape_cmp(eigVec, a) || eigVal.n1() != N || eigVal.n2() != Nbatch)
+        SLS_ERR("wrong shape!");
+#endif
+#pragma omp parallel
+    {
+        EigBatchWsp<T> wsp(N); // one for each thread
+#pragma omp for schedule(dynamic, 16)
+        for (Long k = 0; k < Nbatch; ++k)
+            eig_her_batch1(eigVal.ptr() + N * k, eigVec.ptr() + N * N * k, a.ptr() + N * N * k, N, Njac, wsp);
+    }
+}
+
+template <class Tv, SLS_IF(is_dense_mat<Tv>() && is_cmajor<Tv>() && is_Doub<contain_type<Tv>>())>
+inline void eig_sym_batch(Tv &eigVal, Cmat3d<Doub> &eigVec, const Cmat3d<Doub> &a, Long_I Njac = 8)
+{
+    eig_her_batch(eigVal, eigVec, a, Njac);
+}
+
+template <class Tv, SLS_IF(is_dense_mat<Tv>() && is_cmajor<Tv>() && is_Doub<contain_type<Tv>>())>
+inline void eig_sym_batch_par(Tv &eigVal, Cmat3d<Doub> &eigVec, const Cmat3d<Doub> &a, Long_I Njac = 8)
+{
+    eig_her_batch_par(eigVal, eigVec, a, Njac);
+}
+
+} // namespace slisc
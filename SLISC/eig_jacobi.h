@@ -0,0 +1,130 @@
+// native eigen solver for small dense Hermitian (or real symmetric) matrices, cyclic Jacobi method
+// does not need LAPACK, accurate, and fast for small matrices
+// ref: Numerical Recipes 3rd ed., section 11.1
+#pragma once
+#include "cmat.h"
+#include "scalar_arith.h"
+
+namespace slisc {
+
+// utilities, avoid hypot() and the inf/nan checks of complex multiplication
+inline Doub eig_jac_abs(Doub_I x) { return abs(x); }
+
+inline Doub eig_jac_abs(Comp_I x) { return sqrt(real(x) * real(x) + imag(x) * imag(x)); }
+
+// x *= y
+inline void eig_jac_mul(Doub &x, Doub_I y) { x *= y; }
+
+inline void eig_jac_mul(Comp &x, Comp_I y)
+{
+    Doub xr = real(x), xi = imag(x), yr = real(y), yi = imag(y);
+    x = Comp(xr * yr - xi * yi, xr * yi + xi * yr);
+}
+
+// a (N, N) is column major and Hermitian (both triangles are used), a is destroyed
+// eigVec (N, N) column major, eigen values in ascending order
+template <class T, SLS_IF(is_Doub<T>() || is_Comp<T>())>
+void eig_her_jacobi(rm_comp<T> *eigVal, T *eigVec, T *a, Long_I N)
+{
+    typedef rm_comp<T> Tr;
+    const Long Nsweep_max = 60;
+    // eigVec = I
+    vecset(eigVec, T(0), N * N);
+    for (Long i = 0; i < N; ++i)
+        eigVec[i + N * i] = 1;
+    Tr norm_diag = 0;
+    for (Long i = 0; i < N; ++i)
+        norm_diag += abs(a[i + N * i]);
+    for (Long sweep = 0; sweep < Nsweep_max; ++sweep) {
+        Tr off = 0;
+        for (Long q = 1; q < N; ++q)
+            for (Long p = 0; p < q; ++p)
+                off += eig_jac_abs(a[p + N * q]);
+        if (off <= std::numeric_limits<Tr>::min() ||
+            off <= std::numeric_limits<Tr>::epsilon() * 1e-3 * norm_diag)
+            break;
+        for (Long q = 1; q < N; ++q) {
+            for (Long p = 0; p < q; ++p) {
+                T *ap = a + N * p, *aq = a + N * q;
+                Tr g = eig_jac_abs(aq[p]);
+                if (g == 0)
+                    continue;
+                Tr app = real(ap[p]), aqq = real(aq[q]);
+                // skip after a few sweeps if a(p,q) is negligible
+                if (sweep > 3 && abs(app) + 1e3 * g == abs(app) && abs(aqq) + 1e3 * g == abs(aqq)) {
+                    aq[p] = 0; ap[q] = 0;
+                    continue;
+                }
+                // a(p,q) = g * ph, rotate with U = diag(1, conj(ph)) * [c s; -s c]
+                // the phase is applied first so that the rotation is real
+                T ph = aq[p] / g, phc = CONJ(ph);
+                for (Long k = 0; k < N; ++k)
+                    eig_jac_mul(aq[k], phc);
+                for (Long k = 0; k < N; ++k)
+                    eig_jac_mul(a[q + N * k], ph);
+                Tr theta = (aqq - app) / (2 * g);
+                Tr t = 1 / (abs(theta) + sqrt(theta * theta + 1));
+                if (theta < 0) t = -t;
+                Tr c = 1 / sqrt(t * t + 1), s = t * c;
+                // a = a * R (columns p, q)
+                for (Long k = 0; k < N; ++k) {
+                    T x = ap[k], y = aq[k];
+                    ap[k] = c * x - s * y;
+                    aq[k] = s * x + c * y;
+                }
+                // a = R^T * a (rows p, q)
+                for (Long k = 0; k < N; ++k) {
+                    T *ak = a + N * k;
+                    T x = ak[p], y = ak[q];
+                    ak[p] = c * x - s * y;
+                    ak[q] = s * x + c * y;
+                }
+                ap[p] = app - t * g; aq[q] = aqq + t * g;
+                aq[p] = 0; ap[q] = 0;
+                // eigVec = eigVec * U
+                T *vp = eigVec + N * p, *vq = eigVec + N * q;
+                for (Long k = 0; k < N; ++k) {
+                    eig_jac_mul(vq[k], phc);
+                    T x = vp[k], y = vq[k];
+                    vp[k] = c * x - s * y;
+                    vq[k] = s * x + c * y;
+                }
+            }
+        }
+        if (sweep == Nsweep_max - 1)
+            SLS_WARN("eig_her_jacobi: not converged!");
+    }
+    // sort in ascending order (selection sort, swap columns)
+    for (Long i = 0; i < N; ++i)
+        eigVal[i] = real(a[i + N * i]);
+    for (Long i = 0; i < N - 1; ++i) {
+        Long k = i;
+        for (Long j = i + 1; j < N; ++j)
+            if (eigVal[j] < eigVal[k])
+                k = j;
+        if (k != i) {
+            swap(eigVal[i], eigVal[k]);
+            for (Long n = 0; n < N; ++n)
+                swap(eigVec[n + N * i], eigVec[n + N * k]);
+        }
+    }
+}
+
+// only real symmetric or Hermitian A is supported
+template <class Tv, class Tmat, class Tmat2, SLS_IF(
+    is_dense_vec<Tv>() && is_dense_mat<Tmat>() && is_cmajor<Tmat>() &&
+    is_dense_mat<Tmat2>() && is_cmajor<Tmat2>() &&
+    is_same<contain_type<Tmat>, contain_type<Tmat2>>() &&
+    is_same<contain_type<Tv>, rm_comp<contain_type<Tmat>>>())>
+void eig_her_jacobi(Tv &eigVal, Tmat &eigVec, const Tmat2 &A)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (A.n1() != A.n2() || !shape_cmp(eigVec, A) || eigVal.size() != A.n1())
+        SLS_ERR("wrong shape!");
+#endif
+    Cmat<contain_type<Tmat>> a(A.n1(), A.n2());
+    a = A;
+    eig_her_jacobi(eigVal.ptr(), eigVec.ptr(), a.ptr(), A.n1());
+}
+
+} // namespace slisc
@@ -0,0 +1,607 @@
+// iterative eigen solvers for a few eigen pairs of large sparse (or matrix-free) operators
+// eigs_her(): thick-restart Lanczos for Hermitian (or real symmetric) operators
+// eigs_gen(): implicitly restarted Arnoldi for general operators
+// the operator can be any class with mul(T *y, const Tmat &a, T *x) defined (y = a * x), see sparse_arith.h
+// which = 'S': smallest real part, 'L': largest real part, 'M': largest magnitude
+// for shift-invert, use eigs_her_si() or eigs_gen_si() with an operator that computes (A - sigma*I)^{-1} x,
+// such as LuBand<T> (band_lin_eq.h), or OpShiftInv<> which uses the Krylov solvers
+// return the number of restarts, or -1 if not converged
+// ref: K. Wu and H. Simon, SIAM J. Matrix Anal. Appl. 22, 602 (2000)
+// ref: R. B. Lehoucq and D. C. Sorensen, SIAM J. Matrix Anal. Appl. 17, 789 (1996)
+#pragma once
+#include "krylov.h"
+#include "eig_jacobi.h"
+#include "sort.h"
+
+namespace slisc {
+
+// ============ operators for shift-invert ============
+
+// y = (A - s*I) * x
+template <class T, class Tmat>
+class OpShift
+{
+private:
+    const Tmat &m_a;
+    T m_s;
+    Long m_N;
+public:
+    OpShift(const Tmat &a, const T &s, Long_I N) : m_a(a), m_s(s), m_N(N) {}
+    const Tmat &mat() const { return m_a; }
+    const T &shift() const { return m_s; }
+    Long n1() const { return m_N; }
+};
+
+template <class T, class Tmat>
+inline void mul(T *y, const OpShift<T, Tmat> &op, T *x)
+{
+    mul(y, op.mat(), x);
+    T s = op.shift();
+    for (Long i = 0; i < op.n1(); ++i)
+        y[i] -= s * x[i];
+}
+
+// y = (A - s*I)^{-1} * x, solved iteratively to tolerance tol
+// method = 'M': MINRES (Hermitian A and real s), 'G': GMRES(30), 'B': BiCGSTAB
+// M is a preconditioner for A - s*I, a and M are referenced and must outlive the operator
+template <class T, class Tmat, class Tprec = PrecIdent>
+class OpShiftInv
+{
+private:
+    OpShift<T, Tmat> m_op;
+    const Tprec &m_M;
+    Char m_method;
+    Doub m_tol;
+    Long m_Nmax;
+    mutable KrylovWsp<T> m_wsp;
+public:
+    OpShiftInv(const Tmat &a, const T &s, Long_I N, const Tprec &M, Char_I method = 'G',
+        Doub_I tol = 1e-12, Long_I Nmax = 10000)
+        : m_op(a, s, N), m_M(M), m_method(method), m_tol(tol), m_Nmax(Nmax) {}
+    Long n1() const { return m_op.n1(); }
+    void solve(T *y, T *x) const;
+};
+
+template <class T, class Tmat, class Tprec>
+inline void OpShiftInv<T, Tmat, Tprec>::solve(T *y, T *x) const
+{
+    Long N = n1(), ret = 0;
+    vecset(y, T(0), N);
+    if (m_method == 'M')
+        ret = minres(y, m_op, x, N, m_M, m_tol, m_Nmax, m_wsp);
+    else if (m_method == 'G')
+        ret = gmres(y, m_op, x, N, m_M, 30, m_tol, m_Nmax, m_wsp);
+    else if (m_method == 'B')
+        ret = bicgstab(y, m_op, x, N, m_M, m_tol, m_Nmax, m_wsp);
+    else
+        SLS_ERR("OpShiftInv: unknown method!");
+    if (ret < 0)
+        SLS_WARN("OpShiftInv: linear solver not converged!");
+}
+
+template <class T, class Tmat, class Tprec>
+inline void mul(T *y, const OpShiftInv<T, Tmat, Tprec> &op, T *x)
+{
+    op.solve(y, x);
+}
+
+// ============ internal utilities ============
+
+// sorting key of eigenvalues, the wanted ones first
+template <class T>
+inline Doub eigs_key(const T &s, Char_I which)
+{
+    if (which == 'S')
+        return real(s);
+    else if (which == 'L')
+        return -real(s);
+    else if (which == 'M')
+        return -abs(s);
+    SLS_ERR("unknown `which`!");
+    return 0;
+}
+
+// deterministic start vector
+template <class T>
+inline void eigs_start(T *v, Long_I N, Long_I seed)
+{
+    for (Long i = 0; i < N; ++i)
+        v[i] = sin(1. + i + 0.618 * seed * (i % 7));
+}
+
+// w -= V(:, 0:j) * c
+template <class T>
+inline void eigs_sub(T *w, const T *V, const T *c, Long_I N, Long_I j)
+{
+#pragma omp parallel for
+    for (Long n = 0; n < N; ++n) {
+        T s = 0;
+        for (Long i = 0; i < j; ++i)
+            s += V[n + N * i] * c[i];
+        w[n] -= s;
+    }
+}
+
+// c = V(:, 0:j)^H * w
+template <class T>
+inline void eigs_dot(T *c, const T *V, const T *w, Long_I N, Long_I j)
+{
+#pragma omp parallel for
+    for (Long i = 0; i < j; ++i) {
+        const T *vi = V + N * i;
+        T s = 0;
+        for (Long n = 0; n < N; ++n)
+            s += CONJ(vi[n]) * w[n];
+        c[i] = s;
+    }
+}
+
+// V(:, 0:k) = V(:, 0:m) * Q(:, 0:k), Q is (ldq, k), in place, row by row
+template <class T, class Tq>
+inline void eigs_rotate(T *V, const Tq *Q, Long_I N, Long_I m, Long_I k, Long_I ldq)
+{
+#pragma omp parallel
+    {
+        vector<T> tmp(k);
+#pragma omp for
+        for (Long n = 0; n < N; ++n) {
+            for (Long i = 0; i < k; ++i) {
+                T s = 0;
+                for (Long j = 0; j < m; ++j)
+                    s += V[n + N * j] * Q[j + ldq * i];
+                tmp[i] = s;
+            }
+            for (Long i = 0; i < k; ++i)
+                V[n + N * i] = tmp[i];
+        }
+    }
+}
+
+// extend the Krylov decomposition from column j0 to m, A * V(:,0:m) = V(:,0:m+1) * H(0:m+1, 0:m)
+// column j0 of V must be normalized and orthogonal to the previous columns
+// H is (m+1, m) column major, only columns [j0, m) are written
+// return the norm of the last residual (H(m, m-1)), V(:, m) is the normalized residual
+template <class T, class Tmat>
+Doub eigs_extend(T *V, T *H, const Tmat &a, Long_I N, Long_I j0, Long_I m)
+{
+    vector<T> c(m + 1);
+    Doub beta = 0;
+    for (Long j = j0; j < m; ++j) {
+        T *w = V + N * (j + 1), *hj = H + (m + 1) * j;
+        mul(w, a, V + N * j);
+        // orthogonalize twice
+        eigs_dot(hj, V, w, N, j + 1);
+        eigs_sub(w, V, hj, N, j + 1);
+        eigs_dot(c.data(), V, w, N, j + 1);
+        eigs_sub(w, V, c.data(), N, j + 1);
+        for (Long i = 0; i <= j; ++i)
+            hj[i] += c[i];
+        beta = norm_krylov(w, N);
+        Doub hnorm = 0;
+        for (Long i = 0; i <= j; ++i)
+            hnorm += abs(hj[i]);
+        if (beta <= 1e-13 * hnorm || beta == 0) {
+            // invariant subspace found, continue with a new vector orthogonal to V
+            hj[j + 1] = 0;
+            for (Long seed = 1; seed < 10; ++seed) {
+                eigs_start(w, N, seed + j);
+                for (Long pass = 0; pass < 2; ++pass) {
+                    eigs_dot(c.data(), V, w, N, j + 1);
+                    eigs_sub(w, V, c.data(), N, j + 1);
+                }
+                Doub nrm = norm_krylov(w, N);
+                if (nrm > 1e-8) {
+                    times_equals_vs(w, T(1 / nrm), N);
+                    break;
+                }
+            }
+            beta = 0;
+        }
+        else {
+            hj[j + 1] = beta;
+            times_equals_vs(w, T(1 / beta), N);
+        }
+    }
+    return beta;
+}
+
+// ============ Lanczos for Hermitian operators ============
+
+// eigVal(nev), eigVec(N, nev) column major
+// ncv is the dimension of Krylov subspace (nev < ncv <= N), 0 for default
+// if v0 is not null, it is used as the start vector
+template <class T, class Tmat, SLS_IF(is_Doub<T>() || is_Comp<T>())>
+Long eigs_her(Doub *eigVal, T *eigVec, const Tmat &a, Long_I N, Long_I nev, Char_I which = 'S',
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000, const T *v0 = nullptr)
+{
+    Long m = ncv > 0 ? ncv : MIN(N, MAX(2 * nev + 1, nev + 20));
+    if (nev < 1 || nev > m || m > N)
+        SLS_ERR("eigs_her: illegal nev or ncv!");
+    Vector<T> V(N * (m + 1)), H((m + 1) * m);
+    Vector<T> A(m * m), Y(m * m);
+    VecDoub theta(m), key(m);
+    VecLong ind(m);
+    H = 0;
+    if (v0) veccpy(V.ptr(), v0, N);
+    else eigs_start(V.ptr(), N, 0);
+    times_equals_vs(V.ptr(), T(1 / norm_krylov(V.ptr(), N)), N);
+
+    Long k = 0; // number of kept Ritz vectors
+    Long k_keep = MIN(m - 1, nev + (m - nev) / 2);
+    for (Long it = 0; ; ++it) {
+        Doub beta = eigs_extend(V.ptr(), H.ptr(), a, N, k, m);
+        // Rayleigh quotient is Hermitian, use the upper triangle
+        for (Long j = 0; j < m; ++j) {
+            for (Long i = 0; i <= j; ++i) {
+                T s = H[i + (m + 1) * j];
+                A[i + m * j] = s; A[j + m * i] = CONJ(s);
+            }
+            A[j + m * j] = real(A[j + m * j]);
+        }
+        eig_her_jacobi(theta.ptr(), Y.ptr(), A.ptr(), m);
+        // sort, the wanted first
+        for (Long i = 0; i < m; ++i) {
+            key[i] = eigs_key(theta[i], which); ind[i] = i;
+        }
+        sort2(key, ind);
+        // convergence test with residual estimates
+        Long Nconv = 0;
+        for (Long i = 0; i < nev; ++i) {
+            Long n = ind[i];
+            Doub res = beta * abs(Y[m - 1 + m * n]);
+            if (res <= tol * MAX(abs(theta[n]), 1e-10))
+                ++Nconv;
+        }
+        Bool done = Nconv == nev || beta == 0;
+        if (done || it >= Nrestart) {
+            for (Long i = 0; i < nev; ++i) {
+                eigVal[i] = theta[ind[i]];
+                veccpy(A.ptr() + m * i, Y.ptr() + m * ind[i], m);
+            }
+            eigs_rotate(V.ptr(), A.ptr(), N, m, nev, m);
+            veccpy(eigVec, V.ptr(), N * nev);
+            return done ? it : -1;
+        }
+        // thick restart: keep k Ritz vectors, the residual vector becomes column k
+        k = k_keep;
+        for (Long i = 0; i < k; ++i)
+            veccpy(A.ptr() + m * i, Y.ptr() + m * ind[i], m);
+        eigs_rotate(V.ptr(), A.ptr(), N, m, k, m);
+        veccpy(V.ptr() + N * k, V.ptr() + N * m, N);
+        // new Rayleigh quotient: diagonal of Ritz values, coupling is computed by eigs_extend()
+        H = 0;
+        for (Long i = 0; i < k; ++i)
+            H[i + (m + 1) * i] = theta[ind[i]];
+    }
+}
+
+// shift-invert: eigen values of A closest to sigma
+// op computes y = (A - sigma*I)^{-1} * x, eigen values are sorted in ascending order
+template <class T, class Top, SLS_IF(is_Doub<T>() || is_Comp<T>())>
+Long eigs_her_si(Doub *eigVal, T *eigVec, const Top &op, Doub_I sigma, Long_I N, Long_I nev,
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000)
+{
+    Long ret = eigs_her(eigVal, eigVec, op, N, nev, 'M', ncv, tol, Nrestart);
+    for (Long i = 0; i < nev; ++i)
+        eigVal[i] = sigma + 1 / eigVal[i];
+    // sort with vectors
+    for (Long i = 0; i < nev - 1; ++i) {
+        Long k = i;
+        for (Long j = i + 1; j < nev; ++j)
+            if (eigVal[j] < eigVal[k])
+                k = j;
+        if (k != i) {
+            swap(eigVal[i], eigVal[k]);
+            for (Long n = 0; n < N; ++n)
+                swap(eigVec[n + N * i], eigVec[n + N * k]);
+        }
+    }
+    return ret;
+}
+
+// ============ Arnoldi for general operators ============
+
+// Givens rotation G = [c s; -conj(s) c] so that G * [x; y] = [r; 0], c is real
+inline void eigs_givens(Doub &c, Comp &s, const Comp &x, const Comp &y)
+{
+    Doub ax = abs(x), ay = abs(y);
+    if (ay == 0) {
+        c = 1; s = 0;
+    }
+    else if (ax == 0) {
+        c = 0; s = conj(y) / ay;
+    }
+    else {
+        Doub r = sqrt(ax * ax + ay * ay);
+        c = ax / r;
+        s = x / ax * conj(y) / r;
+    }
+}
+
+// one single shift QR sweep on rows/columns [l, hi] of upper Hessenberg H (m, m), column major
+// H = G * H * G^H is applied to full rows and columns, Z = Z * G^H (Z can be null)
+inline void eigs_qr_sweep(Comp *H, Comp *Z, Long_I m, Long_I l, Long_I hi, Comp_I mu)
+{
+    for (Long k = l; k < hi; ++k) {
+        Comp x, y;
+        if (k == l) {
+            x = H[k + m * k] - mu; y = H[k + 1 + m * k];
+        }
+        else {
+            x = H[k + m * (k - 1)]; y = H[k + 1 + m * (k - 1)];
+        }
+        Doub c; Comp s;
+        eigs_givens(c, s, x, y);
+        // rows k, k+1
+        for (Long j = MAX(l, k - 1); j < m; ++j) {
+            Comp a = H[k + m * j], b = H[k + 1 + m * j];
+            H[k + m * j] = c * a + s * b;
+            H[k + 1 + m * j] = -conj(s) * a + c * b;
+        }
+        if (k > l)
+            H[k + 1 + m * (k - 1)] = 0;
+        // columns k, k+1
+        Long imax = MIN(k + 2, hi);
+        for (Long i = 0; i <= imax; ++i) {
+            Comp a = H[i + m * k], b = H[i + m * (k + 1)];
+            H[i + m * k] = c * a + conj(s) * b;
+            H[i + m * (k + 1)] = -s * a + c * b;
+        }
+        if (Z) {
+            for (Long i = 0; i < m; ++i) {
+                Comp a = Z[i + m * k], b = Z[i + m * (k + 1)];
+                Z[i + m * k] = c * a + conj(s) * b;
+                Z[i + m * (k + 1)] = -s * a + c * b;
+            }
+        }
+    }
+}
+
+// eigen values and eigen vectors of upper Hessenberg H (m, m), column major, H is destroyed
+// Schur decomposition by single shift QR iterations (Wilkinson shift), then back substitution
+inline void eigs_hess_eig(Comp *eigVal, Comp *eigVec, Comp *H, Long_I m)
+{
+    const Doub eps = std::numeric_limits<Doub>::epsilon();
+    vector<Comp> Z(m * m, 0.);
+    for (Long i = 0; i < m; ++i)
+        Z[i + m * i] = 1;
+    Long hi = m - 1, iter = 0;
+    while (hi >= 0) {
+        // find a negligible sub-diagonal element
+        Long l = hi;
+        for (; l > 0; --l) {
+            if (abs(H[l + m * (l - 1)]) <= eps * (abs(H[l - 1 + m * (l - 1)]) + abs(H[l + m * l]))) {
+                H[l + m * (l - 1)] = 0;
+                break;
+            }
+        }
+        if (l == hi) {
+            --hi; iter = 0;
+            continue;
+        }
+        ++iter;
+        if (iter > 100 * m)
+            SLS_ERR("eigs_hess_eig: not converged!");
+        // Wilkinson shift, or exceptional shift
+        Comp mu;
+        Comp a = H[hi - 1 + m * (hi - 1)], b = H[hi - 1 + m * hi], c = H[hi + m * (hi - 1)], d = H[hi + m * hi];
+        if (iter % 10 == 0)
+            mu = d + abs(c);
+        else {
+            Comp p = 0.5 * (a - d), disc = sqrt(p * p + b * c);
+            Comp mu1 = d - b * c / (p + disc), mu2 = d - b * c / (p - disc);
+            if (p + disc == 0.) mu = mu2;
+            else if (p - disc == 0.) mu = mu1;
+            else mu = abs(mu1 - d) < abs(mu2 - d) ? mu1 : mu2;
+        }
+        eigs_qr_sweep(H, Z.data(), m, l, hi, mu);
+    }
+    // eigen vectors of the triangular matrix
+    Doub hnorm = 0;
+    for (Long j = 0; j < m; ++j)
+        for (Long i = 0; i <= j; ++i)
+            hnorm = MAX(hnorm, abs(H[i + m * j]));
+    Doub small = MAX(eps * hnorm, std::numeric_limits<Doub>::min());
+    vector<Comp> x(m);
+    for (Long i = 0; i < m; ++i) {
+        Comp lam = H[i + m * i];
+        eigVal[i] = lam;
+        x[i] = 1;
+        for (Long j = i - 1; j >= 0; --j) {
+            Comp s = 0;
+            for (Long k = j + 1; k <= i; ++k)
+                s += H[j + m * k] * x[k];
+            Comp den = H[j + m * j] - lam;
+            if (abs(den) < small) den = small;
+            x[j] = -s / den;
+        }
+        // eigVec(:, i) = Z(:, 0:i+1) * x(0:i+1)
+        Comp *v = eigVec + m * i;
+        for (Long n = 0; n < m; ++n) {
+            Comp s = 0;
+            for (Long k = 0; k <= i; ++k)
+                s += Z[n + m * k] * x[k];
+            v[n] = s;
+        }
+        Doub nrm = 0;
+        for (Long n = 0; n < m; ++n)
+            nrm += std::norm(v[n]);
+        nrm = 1 / sqrt(nrm);
+        for (Long n = 0; n < m; ++n)
+            v[n] *= nrm;
+    }
+}
+
+// eigVal(nev), eigVec(N, nev) column major, the operator a can be real or complex
+// ncv is the dimension of Krylov subspace (nev < ncv <= N), 0 for default
+template <class Tmat>
+Long eigs_gen(Comp *eigVal, Comp *eigVec, const Tmat &a, Long_I N, Long_I nev, Char_I which = 'S',
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000, const Comp *v0 = nullptr)
+{
+    Long m = ncv > 0 ? ncv : MIN(N, MAX(2 * nev + 1, nev + 20));
+    if (nev < 1 || nev > m || m > N)
+        SLS_ERR("eigs_gen: illegal nev or ncv!");
+    Vector<Comp> V(N * (m + 1)), H((m + 1) * m);
+    Vector<Comp> Hm(m * m), Q(m * m), theta(m), Y(m * m);
+    VecDoub key(m);
+    VecLong ind(m);
+    H = 0;
+    if (v0) veccpy(V.ptr(), v0, N);
+    else eigs_start(V.ptr(), N, 0);
+    times_equals_vs(V.ptr(), Comp(1 / norm_krylov(V.ptr(), N)), N);
+
+    Long k = 0;
+    // keep a few more than nev to avoid stagnation
+    Long k_keep = MIN(m - 1, nev + (m - nev) / 3);
+    for (Long it = 0; ; ++it) {
+        Doub beta = eigs_extend(V.ptr(), H.ptr(), a, N, k, m);
+        for (Long j = 0; j < m; ++j)
+            veccpy(Hm.ptr() + m * j, H.ptr() + (m + 1) * j, m);
+        eigs_hess_eig(theta.ptr(), Y.ptr(), Hm.ptr(), m);
+        for (Long i = 0; i < m; ++i) {
+            key[i] = eigs_key(theta[i], which); ind[i] = i;
+        }
+        sort2(key, ind);
+        Long Nconv = 0;
+        for (Long i = 0; i < nev; ++i) {
+            Long n = ind[i];
+            Doub res = beta * abs(Y[m - 1 + m * n]);
+            if (res <= tol * MAX(abs(theta[n]), 1e-10))
+                ++Nconv;
+        }
+        Bool done = Nconv == nev || beta == 0;
+        if (done || it >= Nrestart) {
+            for (Long i = 0; i < nev; ++i) {
+                eigVal[i] = theta[ind[i]];
+                veccpy(Hm.ptr() + m * i, Y.ptr() + m * ind[i], m);
+            }
+            eigs_rotate(V.ptr(), Hm.ptr(), N, m, nev, m);
+            veccpy(eigVec, V.ptr(), N * nev);
+            // normalize
+            for (Long i = 0; i < nev; ++i)
+                times_equals_vs(eigVec + N * i, Comp(1 / norm_krylov(eigVec + N * i, N)), N);
+            return done ? it : -1;
+        }
+        // implicit restart with the unwanted Ritz values as exact shifts
+        k = k_keep;
+        for (Long j = 0; j < m; ++j)
+            veccpy(Hm.ptr() + m * j, H.ptr() + (m + 1) * j, m);
+        Q = 0;
+        for (Long i = 0; i < m; ++i)
+            Q[i + m * i] = 1;
+        for (Long i = k; i < m; ++i)
+            eigs_qr_sweep(Hm.ptr(), Q.ptr(), m, 0, m - 1, theta[ind[i]]);
+        // f = V * Q(:, k) * Hm(k, k-1) + f * Q(m-1, k-1)
+        Comp hk = Hm[k + m * (k - 1)], qk = Q[m - 1 + m * (k - 1)];
+        vector<Comp> f(N);
+        for (Long n = 0; n < N; ++n)
+            f[n] = V[n + N * m] * (beta * qk);
+        eigs_rotate(V.ptr(), Q.ptr(), N, m, k + 1, m);
+        for (Long n = 0; n < N; ++n)
+            f[n] += V[n + N * k] * hk;
+        Doub fnorm = norm_krylov(f.data(), N);
+        H = 0;
+        for (Long j = 0; j < k; ++j)
+            veccpy(H.ptr() + (m + 1) * j, Hm.ptr() + m * j, j + 2 > k ? k : j + 2);
+        if (fnorm == 0) {
+            eigs_start(V.ptr() + N * k, N, it + 1);
+            vector<Comp> c(k);
+            for (Long pass = 0; pass < 2; ++pass) {
+                eigs_dot(c.data(), V.ptr(), V.ptr() + N * k, N, k);
+                eigs_sub(V.ptr() + N * k, V.ptr(), c.data(), N, k);
+            }
+            fnorm = norm_krylov(V.ptr() + N * k, N);
+            times_equals_vs(V.ptr() + N * k, Comp(1 / fnorm), N);
+        }
+        else {
+            H[k + (m + 1) * (k - 1)] = fnorm;
+            for (Long n = 0; n < N; ++n)
+                V[n + N * k] = f[n] / fnorm;
+        }
+    }
+}
+
+// shift-invert: eigen values of A closest to sigma
+// op computes y = (A - sigma*I)^{-1} * x, eigen values are sorted by real part
+template <class Top>
+Long eigs_gen_si(Comp *eigVal, Comp *eigVec, const Top &op, Comp_I sigma, Long_I N, Long_I nev,
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000)
+{
+    Long ret = eigs_gen(eigVal, eigVec, op, N, nev, 'M', ncv, tol, Nrestart);
+    for (Long i = 0; i < nev; ++i)
+        eigVal[i] = sigma + 1. / eigVal[i];
+    for (Long i = 0; i < nev - 1; ++i) {
+        Long k = i;
+        for (Long j = i + 1; j < nev; ++j)
+            if (real(eigVal[j]) < real(eigVal[k]))
+                k = j;
+        if (k != i) {
+            swap(eigVal[i], eigVal[k]);
+            for (Long n = 0; n < N; ++n)
+                swap(eigVec[n + N * i], eigVec[n + N * k]);
+        }
+    }
+    return ret;
+}
+
+// ============ dense container interface ============
+
+// nev = eigVal.size(), N = eigVec.n1()
+// MatCooH is converted to MatSell for parallel matrix-vector multiplication
+template <class Tv, class Tvec, class Tmat, SLS_IF(
+    is_dense_vec<Tv>() && is_Doub<contain_type<Tv>>() &&
+    is_dense_mat<Tvec>() && is_cmajor<Tvec>())>
+Long eigs_her(Tv &eigVal, Tvec &eigVec, const Tmat &a, Char_I which = 'S',
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (eigVec.n2() != eigVal.size())
+        SLS_ERR("wrong shape!");
+#endif
+    return eigs_her(eigVal.ptr(), eigVec.ptr(), a, eigVec.n1(), eigVal.size(), which, ncv, tol, Nrestart);
+}
+
+template <class Tv, class Tvec, class T, class Tind, SLS_IF(
+    is_dense_vec<Tv>() && is_Doub<contain_type<Tv>>() &&
+    is_dense_mat<Tvec>() && is_cmajor<Tvec>())>
+Long eigs_her(Tv &eigVal, Tvec &eigVec, const MatCooH<T, Tind> &a, Char_I which = 'S',
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (eigVec.n2() != eigVal.size() || eigVec.n1() != a.n1())
+        SLS_ERR("wrong shape!");
+#endif
+    MatSell<T, Tind> b(a.n1(), a.n2());
+    b = a;
+    return eigs_her(eigVal.ptr(), eigVec.ptr(), b, eigVec.n1(), eigVal.size(), which, ncv, tol, Nrestart);
+}
+
+template <class Tv, class Tvec, class Tmat, SLS_IF(
+    is_dense_vec<Tv>() && is_Comp<contain_type<Tv>>() &&
+    is_dense_mat<Tvec>() && is_cmajor<Tvec>() && is_Comp<contain_type<Tvec>>())>
+Long eigs_gen(Tv &eigVal, Tvec &eigVec, const Tmat &a, Char_I which = 'S',
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (eigVec.n2() != eigVal.size())
+        SLS_ERR("wrong shape!");
+#endif
+    return eigs_gen(eigVal.ptr(), eigVec.ptr(), a, eigVec.n1(), eigVal.size(), which, ncv, tol, Nrestart);
+}
+
+template <class Tv, class Tvec, class T, class Tind, SLS_IF(
+    is_dense_vec<Tv>() && is_Comp<contain_type<Tv>>() &&
+    is_dense_mat<Tvec>() && is_cmajor<Tvec>() && is_Comp<contain_type<Tvec>>())>
+Long eigs_gen(Tv &eigVal, Tvec &eigVec, const MatCoo<T, Tind> &a, Char_I which = 'S',
+    Long_I ncv = 0, Doub_I tol = 1e-10, Long_I Nrestart = 1000)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (eigVec.n2() != eigVal.size() || eigVec.n1() != a.n1())
+        SLS_ERR("wrong shape!");
+#endif
+    MatSell<T, Tind> b(a.n1(), a.n2());
+    b = a;
+    return eigs_gen(eigVal.ptr(), eigVec.ptr(), b, eigVec.n1(), eigVal.size(), which, ncv, tol, Nrestart);
+}
+
+} // namespace slisc
@@ -1,6 +1,7 @@
 #pragma once
 #include "cmat.h"
 #include "matcooh.h"
+#include "sparse_arith.h"
 
 namespace slisc {
 
@@ -147,6 +148,72 @@ inline void legendre_interp_der(CmatDoub_O df, VecDoub_I x)
         }
 }
 
+// Gauss-Lobatto abscissas, weights and second derivative block in [-1, 1] for one Ngs
+// use fedvr_basis() to get the cached one
+class FedvrBasis
+{
+public:
+    Long Ngs;
+    VecDoub x0, w0; // GaussLobatto(x0, w0)
+    CmatDoub df; // df(i, j) = f'_j(x0[i]), f_j are the normalized basis (divided by sqrt(w0[j]))
+    CmatDoub block; // block(i, j) = sum_k w0[k] * df(k, i) * df(k, j), symmetric
+    VecDoub lw; // lw[j] = 1 / prod_{k != j} (x0[j] - x0[k]), for Lagrange interpolation
+    FedvrBasis(Long_I Ngs);
+    // L[j] = L_j(t), the Lagrange interpolation polynomials on x0, t in [-1, 1]
+    void lagrange(Doub *L, Doub_I t) const;
+};
+
+inline FedvrBasis::FedvrBasis(Long_I Ngs_) :
+    Ngs(Ngs_), x0(Ngs_), w0(Ngs_), df(Ngs_, Ngs_), block(Ngs_, Ngs_), lw(Ngs_)
+{
+    GaussLobatto(x0, w0);
+    for (Long j = 0; j < Ngs; ++j) {
+        Doub s = 1;
+        for (Long k = 0; k < Ngs; ++k)
+            if (k != j)
+                s *= x0[j] - x0[k];
+        lw[j] = 1 / s;
+    }
+    legendre_interp_der(df, x0);
+    for (Long j = 0; j < Ngs; ++j) {
+        Doub f0 = pow(w0[j], -0.5);
+        for (Long i = 0; i < Ngs; ++i)
+            df(i, j) *= f0;
+    }
+    for (Long j = 0; j < Ngs; ++j)
+        for (Long i = 0; i <= j; ++i) {
+            Doub s = 0;
+            for (Long k = 0; k < Ngs; ++k)
+                s += w0[k] * df(k, i) * df(k, j);
+            block(i, j) = block(j, i) = s;
+        }
+}
+
+inline void FedvrBasis::lagrange(Doub *L, Doub_I t) const
+{
+    for (Long j = 0; j < Ngs; ++j) {
+        Doub s = lw[j];
+        for (Long k = 0; k < Ngs; ++k)
+            if (k != j)
+                s *= t - x0[k];
+        L[j] = s;
+    }
+}
+
+// FedvrBasis is only computed once for each Ngs (thread safe)
+inline const FedvrBasis &fedvr_basis(Long_I Ngs)
+{
+#define SLS_FEDVR_BASIS_CASE(n) case n: { static const FedvrBasis b(n); return b; }
+    switch (Ngs) {
+    SLS_FEDVR_BASIS_CASE(4) SLS_FEDVR_BASIS_CASE(6) SLS_FEDVR_BASIS_CASE(8)
+    SLS_FEDVR_BASIS_CASE(10) SLS_FEDVR_BASIS_CASE(12) SLS_FEDVR_BASIS_CASE(14)
+    SLS_FEDVR_BASIS_CASE(16)
+    }
+#undef SLS_FEDVR_BASIS_CASE
+    SLS_ERR("no data!");
+    return fedvr_basis(4);
+}
+
 // calculate FEDVR global index from FE index i and DVR index j
 inline Long indFEDVR(Long_I i, Long_I j, Long_I Ngs)
 { return (Ngs-1) * i + j - 1; }
@@ -185,6 +252,8 @@ inline void FEDVR_grid(VecDoub_O x, VecDoub_O w, VecDoub_I wFE, VecDoub_I xFE, V
 // number of non-zero elements in fedvr second derivative matrix
 inline Long fedvr_d2_nnz(Long_I Ngs, Long_I Nfe)
 {
+    if (Nfe == 1)
+        return SQR(Ngs - 2);
     return (Ngs*Ngs - 1)*Nfe - 4 * Ngs + 3;
 }
 
@@ -267,6 +336,15 @@ inline void D2_matrix(McooDoub_O D2, VecDoub_I w0, VecDoub_I wFE, CmatDoub_I df)
     D2.sort_r();
 }
 
+// midpoints xFE and half widths wFE of finite elements from the boundaries
+inline void fedvr_elements(VecDoub_O xFE, VecDoub_O wFE, VecDoub_I bounds)
+{
+    for (Long i = 0; i < wFE.size(); ++i) {
+        wFE(i) = 0.5*(bounds(i + 1) - bounds(i));
+        xFE(i) = 0.5*(bounds(i) + bounds(i + 1));
+    }
+}
+
 // bounds: FE boundaries, size = Nfe + 1
 // Ngs: grid points per finite element (including boundaries)
 // `x`, `w` are the global grid points and weights
@@ -281,28 +359,369 @@ void D2_matrix(McooDoub_O D2, VecDoub_O x, VecDoub_O w, VecDoub_O u, VecDoub_I b
         SLS_ERR("wrong shape!");
 #endif
 
-    // grid points, weights, base function values in [-1, 1]
-    VecDoub x0(Ngs), w0(Ngs), f0(Ngs);
-    GaussLobatto(x0, w0);
-    pow(f0, w0, -0.5);
-    CmatDoub df(Ngs, Ngs); // df(i, j) = f_j(x_i)
-    legendre_interp_der(df, x0);
-    for (Long i = 0; i < Ngs; ++i)
-        for (Long j = 0; j < Ngs; ++j)
-            df(j, i) *= f0(i);
+    // grid points, weights, base function derivatives in [-1, 1]
+    const FedvrBasis &b = fedvr_basis(Ngs);
 
-    // midpoints, widths and bounds of finite elements
+    // midpoints and half widths of finite elements
     VecDoub xFE(Nfe), wFE(Nfe);
+    fedvr_elements(xFE, wFE, bounds);
+
+    FEDVR_grid(x, w, wFE, xFE, b.x0, b.w0);
+    pow(u, w, -0.5);
+
+    // Sparse Hamiltonian
+    D2_matrix(D2, b.w0, wFE, b.df);
+}
 
+// === assemble D2 without MatCoo, parallel over finite elements ===
+
+// normalization factor of the local basis m of finite element i
+// (the bridge functions are shared by two elements)
+inline Doub fedvr_norm(VecDoub_I wFE, Long_I i, Long_I m, Long_I Ngs)
+{
+    if (m == 0 && i > 0)
+        return 1 / sqrt(wFE[i - 1] + wFE[i]);
+    if (m == Ngs - 1 && i < wFE.size() - 1)
+        return 1 / sqrt(wFE[i] + wFE[i + 1]);
+    return 1 / sqrt(wFE[i]);
+}
+
+// D2 is resized to Nfe blocks of size Ngs, block i is finite element i
+// the overlapped diagonal element is stored in the later block (the same as `D2 = MatCoo`)
+inline void D2_matrix(CmobdDoub_O D2, VecDoub_I wFE, Long_I Ngs)
+{
+    const FedvrBasis &b = fedvr_basis(Ngs);
+    Long Nfe = wFE.size(), N = Ngs - 1;
+    D2.resize(Ngs, Nfe);
+#pragma omp parallel for
     for (Long i = 0; i < Nfe; ++i) {
-        wFE(i) = 0.5*(bounds(i + 1) - bounds(i));
-        xFE(i) = 0.5*(bounds(i) + bounds(i + 1));
+        Doub c[16];
+        for (Long m = 0; m < Ngs; ++m)
+            c[m] = fedvr_norm(wFE, i, m, Ngs);
+        Long m0 = i > 0 ? 0 : 1, m1 = i < Nfe - 1 ? N : N - 1; // valid local basis
+        Doub *a = D2.ptr() + Ngs * Ngs * i;
+        vecset(a, 0., Ngs * Ngs);
+        for (Long n = m0; n <= m1; ++n)
+            for (Long m = m0; m <= m1; ++m)
+                a[m + Ngs * n] = -b.block(m, n) / wFE[i] * c[m] * c[n];
+        if (i > 0) // add the overlapped element from the last finite element
+            a[0] -= b.block(N, N) / wFE[i - 1] * SQR(c[0]);
+        if (i < Nfe - 1) // moved to the next block
+            a[N + Ngs * N] = 0;
+    }
+}
+
+// D2 is resized, column indices of each row are sorted (the same as `D2 = MatCoo` after sort_r())
+template <class Tind>
+inline void D2_matrix(MatCsr<Doub, Tind> &D2, VecDoub_I wFE, Long_I Ngs)
+{
+    const FedvrBasis &b = fedvr_basis(Ngs);
+    Long Nfe = wFE.size(), N = Ngs - 1, Nx = Nfe * N - 1;
+    D2.resize(Nx, Nx, fedvr_d2_nnz(Ngs, Nfe));
+    Long *row = D2.row_ptr();
+    // row (N*i - 1 + m) for m = 1, ..., N belongs to finite element i
+    row[0] = 0;
+    for (Long i = 0; i < Nfe; ++i) {
+        Long Nint = Ngs - 2 + (i > 0) + (i < Nfe - 1); // interior row
+        for (Long m = 1; m < N; ++m)
+            row[N * i + m - 1 + 1] = row[N * i + m - 1] + Nint;
+        if (i < Nfe - 1) // bridge row
+            row[N * (i + 1)] = row[N * (i + 1) - 1] + 2 * Ngs - 3 + (i > 0) + (i < Nfe - 2);
+    }
+    Tind *col = D2.col_ptr();
+    Doub *val = D2.ptr();
+#pragma omp parallel for
+    for (Long i = 0; i < Nfe; ++i) {
+        Doub c[16];
+        for (Long m = 0; m < Ngs; ++m)
+            c[m] = fedvr_norm(wFE, i, m, Ngs);
+        Long m0 = i > 0 ? 0 : 1, m1 = i < Nfe - 1 ? N : N - 1; // valid local basis
+        Long g0 = N * i - 1; // global index of local basis 0
+        for (Long m = 1; m < N; ++m) {
+            Long k = row[g0 + m];
+            for (Long n = m0; n <= m1; ++n, ++k) {
+                col[k] = Tind(g0 + n);
+                val[k] = -b.block(m, n) / wFE[i] * c[m] * c[n];
+            }
+        }
+        if (i == Nfe - 1)
+            continue;
+        // bridge row, shared with finite element i + 1
+        Long k = row[g0 + N];
+        for (Long n = m0; n <= N; ++n, ++k) {
+            col[k] = Tind(g0 + n);
+            val[k] = -b.block(N, n) / wFE[i] * c[N] * c[n];
+        }
+        Long n1 = i + 1 < Nfe - 1 ? N : N - 1;
+        for (Long n = 0; n <= n1; ++n) {
+            Doub s = -b.block(0, n) / wFE[i + 1] * c[N] * fedvr_norm(wFE, i + 1, n, Ngs);
+            if (n == 0)
+                val[k - 1] += s;
+            else {
+                col[k] = Tind(g0 + N + n); val[k] = s; ++k;
+            }
+        }
     }
+}
 
-    FEDVR_grid(x, w, wFE, xFE, x0, w0);
+// same as D2_matrix(McooDoub_O, ...), but D2 is CmatObd or MatCsr (no sorting is needed)
+template <class Tmat, SLS_IF(is_CmatObd<Tmat>() || is_MatCsr<Tmat>())>
+inline void D2_matrix(Tmat &D2, VecDoub_O x, VecDoub_O w, VecDoub_O u, VecDoub_I bounds, Long_I Ngs)
+{
+    Long Nfe = bounds.size() - 1;
+#ifdef SLS_CHECK_SHAPE
+    Long Nx = Nfe * (Ngs - 1) - 1;
+    if (x.size() != Nx || w.size() != Nx || u.size() != Nx)
+        SLS_ERR("wrong shape!");
+#endif
+    const FedvrBasis &b = fedvr_basis(Ngs);
+    VecDoub xFE(Nfe), wFE(Nfe);
+    fedvr_elements(xFE, wFE, bounds);
+    FEDVR_grid(x, w, wFE, xFE, b.x0, b.w0);
     pow(u, w, -0.5);
+    D2_matrix(D2, wFE, Ngs);
+}
+// ======== transfer between grids ========
 
-    // Sparse Hamiltonian
-    D2_matrix(D2, w0, wFE, df);
+// interpolation matrix from values on a FEDVR grid to values at any points y
+// the FEDVR grid is given by `bounds` and `Ngs` (see D2_matrix()), T is resized to (y.size(), Nx)
+// psi(y[i]) = sum_j T(i, j) * psi(x[j]), each row only uses the finite element containing y[i]
+// rows are empty for y outside (bounds[0], bounds[Nfe]) where psi = 0
+// e.g. y is another FEDVR grid, or a uniform grid for FFT
+// for the coefficients in the normalized basis (psi(x)/u), use diag(1/u_y) * T * diag(u)
+template <class Tind>
+inline void fedvr_interp_matrix(MatCsr<Doub, Tind> &T, VecDoub_I bounds, Long_I Ngs, VecDoub_I y)
+{
+    const FedvrBasis &b = fedvr_basis(Ngs);
+    Long Nfe = bounds.size() - 1, N = Ngs - 1, Nx = Nfe * N - 1, Ny = y.size();
+    // finite element of each point, -1 if outside
+    VecLong ife(Ny);
+#pragma omp parallel for
+    for (Long i = 0; i < Ny; ++i) {
+        if (y[i] <= bounds[0] || y[i] >= bounds[Nfe])
+            ife[i] = -1;
+        else
+            ife[i] = MIN(Long(std::upper_bound(bounds.ptr(), bounds.ptr() + Nfe + 1, y[i]) - bounds.ptr()) - 1, Nfe - 1);
+    }
+    VecLong row(Ny + 1);
+    row[0] = 0;
+    for (Long i = 0; i < Ny; ++i) {
+        Long e = ife[i];
+        row[i + 1] = row[i] + (e < 0 ? 0 : Ngs - (e == 0) - (e == Nfe - 1));
+    }
+    T.resize(Ny, Nx, row[Ny]);
+    veccpy(T.row_ptr(), row.ptr(), Ny + 1);
+    Tind *col = T.col_ptr();
+    Doub *val = T.ptr();
+#pragma omp parallel for
+    for (Long i = 0; i < Ny; ++i) {
+        Long e = ife[i];
+        if (e < 0)
+            continue;
+        Doub L[16];
+        Doub wFE = 0.5 * (bounds[e + 1] - bounds[e]), xFE = 0.5 * (bounds[e] + bounds[e + 1]);
+        b.lagrange(L, (y[i] - xFE) / wFE);
+        Long m0 = e > 0 ? 0 : 1, m1 = e < Nfe - 1 ? N : N - 1, k = row[i];
+        for (Long m = m0; m <= m1; ++m, ++k) {
+            col[k] = Tind(N * e - 1 + m);
+            val[k] = L[m];
+        }
+    }
+}
+
+// interpolation matrix from values on a uniform grid x[j] = x0 + dx * j (j = 0, ..., Nx-1) to any points y
+// local Lagrange interpolation using Np grid points around y[i] (Np is the order plus one)
+// T is resized to (y.size(), Nx), rows are empty for y outside [x[0], x[Nx-1]]
+// e.g. from the uniform grid of FFT back to a FEDVR grid
+template <class Tind>
+inline void uniform_interp_matrix(MatCsr<Doub, Tind> &T, Doub_I x0, Doub_I dx, Long_I Nx, VecDoub_I y, Long_I Np)
+{
+    if (Np > Nx || Np < 1)
+        SLS_ERR("illegal Np!");
+    Long Ny = y.size();
+    VecLong row(Ny + 1);
+    row[0] = 0;
+    for (Long i = 0; i < Ny; ++i) {
+        Doub s = (y[i] - x0) / dx;
+        row[i + 1] = row[i] + ((s < 0 || s > Nx - 1) ? 0 : Np);
+    }
+    T.resize(Ny, Nx, row[Ny]);
+    veccpy(T.row_ptr(), row.ptr(), Ny + 1);
+    // denominators of the Lagrange polynomials on 0, 1, ..., Np-1
+    VecDoub lw(Np);
+    for (Long j = 0; j < Np; ++j) {
+        Doub s = 1;
+        for (Long k = 0; k < Np; ++k)
+            if (k != j)
+                s *= j - k;
+        lw[j] = 1 / s;
+    }
+    Tind *col = T.col_ptr();
+    Doub *val = T.ptr();
+#pragma omp parallel for
+    for (Long i = 0; i < Ny; ++i) {
+        Long k = row[i];
+        if (row[i + 1] == k)
+            continue;
+        Doub s = (y[i] - x0) / dx;
+        Long j0 = MIN(MAX(Long(floor(s)) - (Np - 1) / 2, Long(0)), Nx - Np); // first grid point used
+        s -= j0;
+        for (Long j = 0; j < Np; ++j, ++k) {
+            Doub L = lw[j];
+            for (Long m = 0; m < Np; ++m)
+                if (m != j)
+                    L *= s - m;
+            col[k] = Tind(j0 + j);
+            val[k] = L;
+        }
+    }
+}
+
+// ======== matrix-free tensor product operator ========
+
+// H = A_0 (x) I (x) I + I (x) A_1 (x) I + I (x) I (x) A_2 + diag(V) on a 1D, 2D or 3D FEDVR grid
+// A_d (n(d) x n(d)) are CmatObd matrices (e.g. -0.5*D2), V is an optional potential on the grid
+// data is stored like Cmat/Cmat3d: x(i0, i1, i2), i0 is the fastest index
+// H is never formed, mul() applies it dimension by dimension with the CmatObd block kernels,
+// so the extra memory is O(N) instead of O(N * nnz per row) for the Kronecker sum
+// A_d are referenced and must outlive the operator (the same A_d can be used for several dimensions)
+template <class T>
+class OpFedvr
+{
+private:
+    vector<const CmatObd<T> *> m_a;
+    Vector<T> m_V; // empty if there is no potential
+public:
+    typedef T value_type;
+    OpFedvr(const CmatObd<T> &a0);
+    OpFedvr(const CmatObd<T> &a0, const CmatObd<T> &a1);
+    OpFedvr(const CmatObd<T> &a0, const CmatObd<T> &a1, const CmatObd<T> &a2);
+    void set_diag(const Vector<T> &V); // V.size() == n1()
+    Long ndim() const { return m_a.size(); }
+    Long n(Long_I d) const { return m_a[d]->n1(); } // grid size in dimension d
+    Long n1() const;
+    Long n2() const { return n1(); }
+    const CmatObd<T> &a(Long_I d) const { return *m_a[d]; }
+    const Vector<T> &diag() const { return m_V; }
+    // y = H * x, x and y have n1() elements
+    template <class Tx, class Ty>
+    void mul(Ty *y, const Tx *x) const;
+    template <class Tx, class Ty>
+    void mul_par(Ty *y, const Tx *x) const;
+};
+
+template <class T>
+inline OpFedvr<T>::OpFedvr(const CmatObd<T> &a0) : m_V(0)
+{
+    m_a.push_back(&a0);
+}
+
+template <class T>
+inline OpFedvr<T>::OpFedvr(const CmatObd<T> &a0, const CmatObd<T> &a1) : m_V(0)
+{
+    m_a.push_back(&a0); m_a.push_back(&a1);
+}
+
+template <class T>
+inline OpFedvr<T>::OpFedvr(const CmatObd<T> &a0, const CmatObd<T> &a1, const CmatObd<T> &a2) : m_V(0)
+{
+    m_a.push_back(&a0); m_a.push_back(&a1); m_a.push_back(&a2);
+}
+
+template <class T>
+inline Long OpFedvr<T>::n1() const
+{
+    Long N = 1;
+    for (Long d = 0; d < ndim(); ++d)
+        N *= n(d);
+    return N;
+}
+
+template <class T>
+inline void OpFedvr<T>::set_diag(const Vector<T> &V)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (V.size() != n1())
+        SLS_ERR("wrong shape!");
+#endif
+    m_V.resize(V.size());
+    m_V = V;
+}
+
+template <class T>
+template <class Tx, class Ty>
+inline void OpFedvr<T>::mul(Ty *y, const Tx *x) const
+{
+    Long N = n1();
+    mul_cmat_cmatobd_cmat(y, a(0).ptr(), x, a(0).n0(), a(0).nblk(), n(0), N / n(0));
+    Long M = n(0);
+    for (Long d = 1; d < ndim(); ++d) {
+        mul_cmat_cmatobd_mid_add(y, a(d).ptr(), x, a(d).n0(), a(d).nblk(), M, n(d), N / (M * n(d)));
+        M *= n(d);
+    }
+    if (m_V.size() > 0)
+        for (Long i = 0; i < N; ++i)
+            y[i] += m_V[i] * x[i];
+}
+
+template <class T>
+template <class Tx, class Ty>
+inline void OpFedvr<T>::mul_par(Ty *y, const Tx *x) const
+{
+    Long N = n1();
+    mul_cmat_cmatobd_cmat_par(y, a(0).ptr(), x, a(0).n0(), a(0).nblk(), n(0), N / n(0));
+    Long M = n(0);
+    for (Long d = 1; d < ndim(); ++d) {
+        mul_cmat_cmatobd_mid_add_par(y, a(d).ptr(), x, a(d).n0(), a(d).nblk(), M, n(d), N / (M * n(d)));
+        M *= n(d);
+    }
+    if (m_V.size() > 0) {
+#pragma omp parallel for
+        for (Long i = 0; i < N; ++i)
+            y[i] += m_V[i] * x[i];
+    }
+}
+
+// for krylov.h, eigs.h and expokit.h (parallel)
+template <class T, class T1, SLS_IF(is_promo<T1, T>())>
+inline void mul(T1 *y, const OpFedvr<T> &op, T1 *x)
+{
+    op.mul_par(y, x);
+}
+
+// x, y can be vectors, or Cmat (2D), Cmat3d (3D) with the same shape as the grid
+template <class Ty, class T, class Tx, SLS_IF(
+    is_dense<Ty>() && is_dense<Tx>() && is_same<contain_type<Ty>, promo_type<T, contain_type<Tx>>>())>
+inline void mul(Ty &y, const OpFedvr<T> &op, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (y.size() != op.n1() || x.size() != op.n1())
+        SLS_ERR("wrong shape!");
+#endif
+    op.mul(y.ptr(), x.ptr());
 }
+
+template <class Ty, class T, class Tx, SLS_IF(
+    is_dense<Ty>() && is_dense<Tx>() && is_same<contain_type<Ty>, promo_type<T, contain_type<Tx>>>())>
+inline void mul_par(Ty &y, const OpFedvr<T> &op, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (y.size() != op.n1() || x.size() != op.n1())
+        SLS_ERR("wrong shape!");
+#endif
+    op.mul_par(y.ptr(), x.ptr());
+}
+
+// upper bound of the infinite norm, for expv()
+template <class T>
+inline rm_comp<T> norm_inf(const OpFedvr<T> &op)
+{
+    rm_comp<T> s = 0;
+    for (Long d = 0; d < op.ndim(); ++d)
+        s += norm_inf(op.a(d));
+    if (op.diag().size() > 0)
+        s += max_abs(op.diag());
+    return s;
+}
+
 } // namespace slisc
@@ -0,0 +1,118 @@
+// sparse table of Gaunt coefficients for angular coupling matrices between partial waves
+// G(l,m; L,M; l2,m2) = \int conj(Y_lm) Y_LM Y_l2m2 dOmega
+//   = (-1)^m sqrt((2l+1)(2L+1)(2l2+1)/(4pi)) (l L l2; 0 0 0) (l L l2; -m M m2)
+// only nonzero coefficients are stored, rows are the output channels (l, m)
+#pragma once
+#include "anglib.h"
+#include "ylm.h"
+#include "matt.h"
+
+namespace slisc {
+
+// l, l2 <= lmax, L <= Lmax, all indices use ylm_ind()
+// CSR like: entries of row ylm_ind(l,m) are k = row_ptr[i], ..., row_ptr[i+1]-1
+// with (L,M) = ind1[k], (l2,m2) = ind2[k], G = val[k], sorted by ind2 then ind1
+class GauntTable
+{
+public:
+    Int lmax, Lmax;
+    VecLong row_ptr;
+    VecInt ind1, ind2;
+    VecDoub val;
+
+    GauntTable() : lmax(-1), Lmax(-1), row_ptr(1, Long(0)), ind1(0), ind2(0), val(0) {}
+    // build in parallel
+    GauntTable(Int_I lmax, Int_I Lmax);
+    Long n1() const { return row_ptr.size() - 1; } // number of output channels
+    Long n2() const { return (Long)(lmax + 1) * (lmax + 1); } // number of input channels
+    Long nnz() const { return val.size(); }
+    // A(i, i2) = sum_{L,M} V[ylm_ind(L,M)] * G(i; L,M; i2), matrix of V(Omega) = sum_{L,M} V_LM Y_LM
+    void coupling(CmatComp_O A, VecComp_I V) const;
+};
+
+inline GauntTable::GauntTable(Int_I lmax_, Int_I Lmax_) :
+    lmax(lmax_), Lmax(Lmax_), row_ptr(ylm_ind(lmax_ + 1, -lmax_ - 1) + 1), ind1(0), ind2(0), val(0)
+{
+    Long N = n1();
+    vector<vector<Int>> i1(N), i2(N);
+    vector<vector<Doub>> v(N);
+#pragma omp parallel for schedule(dynamic)
+    for (Long i = 0; i < N; ++i) {
+        Int l = (Int)sqrt((Doub)i), m = Int(i - ylm_ind(l, 0));
+        VecDoub f0(0), f(0);
+        Long two_Lmin0, two_Lmin;
+        for (Int l2 = 0; l2 <= lmax; ++l2) {
+            // (L l2 l; 0 0 0), only L + l2 + l even is nonzero
+            threej_table(f0, two_Lmin0, 2 * l2, 2 * l, 0, 0);
+            for (Int m2 = -l2; m2 <= l2; ++m2) {
+                // (L l2 l; M m2 -m), M = m - m2
+                threej_table(f, two_Lmin, 2 * l2, 2 * l, 2 * m2, -2 * m);
+                for (Long k = 0; k < f.size(); ++k) {
+                    Int L = Int(two_Lmin / 2 + k);
+                    if (L > Lmax)
+                        break;
+                    if (isodd(L + l2 + l))
+                        continue;
+                    Doub g = f[k] * f0[L - two_Lmin0 / 2];
+                    if (abs(g) < 1e-15)
+                        continue; // accidental zero
+                    if (isodd(m))
+                        g = -g;
+                    i1[i].push_back((Int)ylm_ind(L, m - m2));
+                    i2[i].push_back((Int)ylm_ind(l2, m2));
+                    v[i].push_back(g * sqrt((2. * l + 1) * (2. * L + 1) * (2. * l2 + 1) / (4 * PI)));
+                }
+            }
+        }
+    }
+    row_ptr[0] = 0;
+    for (Long i = 0; i < N; ++i)
+        row_ptr[i + 1] = row_ptr[i] + v[i].size();
+    ind1.resize(row_ptr[N]); ind2.resize(row_ptr[N]); val.resize(row_ptr[N]);
+#pragma omp parallel for
+    for (Long i = 0; i < N; ++i) {
+        Long k0 = row_ptr[i];
+        for (Long k = 0; k < (Long)v[i].size(); ++k) {
+            ind1[k0 + k] = i1[i][k]; ind2[k0 + k] = i2[i][k]; val[k0 + k] = v[i][k];
+        }
+    }
+}
+
+inline void GauntTable::coupling(CmatComp_O A, VecComp_I V) const
+{
+#ifdef SLS_CHECK_SHAPE
+    if (A.n1() != n1() || A.n2() != n2() || V.size() != ylm_ind(Lmax + 1, -Lmax - 1))
+        SLS_ERR("wrong shape!");
+#endif
+    A = 0;
+#pragma omp parallel for
+    for (Long i = 0; i < n1(); ++i)
+        for (Long k = row_ptr[i]; k < row_ptr[i + 1]; ++k)
+            A(i, ind2[k]) += val[k] * V[ind1[k]];
+}
+
+// save to matt file as varname.lmax, varname.Lmax, varname.row_ptr, varname.ind1, varname.ind2, varname.val
+inline void save(const GauntTable &g, Str_I varname, Matt_IO matt)
+{
+    save(g.lmax, varname + ".lmax", matt);
+    save(g.Lmax, varname + ".Lmax", matt);
+    save(g.row_ptr, varname + ".row_ptr", matt);
+    save(g.ind1, varname + ".ind1", matt);
+    save(g.ind2, varname + ".ind2", matt);
+    save(g.val, varname + ".val", matt);
+}
+
+// return 0 if successful, -1 if variable not found
+inline Int load(GauntTable &g, Str_I varname, Matt_IO matt)
+{
+    if (load(g.lmax, varname + ".lmax", matt) || load(g.Lmax, varname + ".Lmax", matt) ||
+        load(g.row_ptr, varname + ".row_ptr", matt) || load(g.ind1, varname + ".ind1", matt) ||
+        load(g.ind2, varname + ".ind2", matt) || load(g.val, varname + ".val", matt))
+        return -1;
+    if (g.row_ptr.size() != ylm_ind(g.lmax + 1, -g.lmax - 1) + 1 || g.row_ptr[g.n1()] != g.nnz() ||
+        g.ind1.size() != g.nnz() || g.ind2.size() != g.nnz())
+        SLS_ERR("GauntTable " + varname + " is corrupted!");
+    return 0;
+}
+
+} // namespace slisc
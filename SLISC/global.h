@@ -160,11 +160,15 @@ template <class T> class Jcmat3d;
 template <class T> class Jcmat4d;
 template <class T> class Scmat3d;
 template <class T> class Diag;
-template <class T> class MatCoo;
-template <class T> class MatCooH;
+template <class T, class Tind = Long> class MatCoo;
+template <class T, class Tind = Long> class MatCooH;
 template <class T> class CmatObd;
+template <class T> class OpFedvr;
+template <class T, class Tind = Long> class MatCsr;
+template <class T, class Tind = Long> class MatSell;
 template <class T> class Flm;
 class Matt;
+class Matb;
 
 // For cuSLISC project
 #ifdef _CUSLISC_
@@ -699,6 +703,59 @@ typedef MatCooH<Comp> McoohComp;
 typedef const McoohComp &McoohComp_I;
 typedef McoohComp &McoohComp_O, &McoohComp_IO;
 
+typedef MatCsr<Int> McsrInt;
+typedef const McsrInt &McsrInt_I;
+typedef McsrInt &McsrInt_O, &McsrInt_IO;
+
+typedef MatCsr<Doub> McsrDoub;
+typedef const McsrDoub &McsrDoub_I;
+typedef McsrDoub &McsrDoub_O, &McsrDoub_IO;
+
+typedef MatCsr<Comp> McsrComp;
+typedef const McsrComp &McsrComp_I;
+typedef McsrComp &McsrComp_O, &McsrComp_IO;
+
+typedef MatSell<Doub> MsellDoub;
+typedef const MsellDoub &MsellDoub_I;
+typedef MsellDoub &MsellDoub_O, &MsellDoub_IO;
+
+typedef MatSell<Comp> MsellComp;
+typedef const MsellComp &MsellComp_I;
+typedef MsellComp &MsellComp_O, &MsellComp_IO;
+
+// sparse matrices with 32-bit indices
+typedef MatCoo<Doub, Int> Mcoo32Doub;
+typedef const Mcoo32Doub &Mcoo32Doub_I;
+typedef Mcoo32Doub &Mcoo32Doub_O, &Mcoo32Doub_IO;
+
+typedef MatCoo<Comp, Int> Mcoo32Comp;
+typedef const Mcoo32Comp &Mcoo32Comp_I;
+typedef Mcoo32Comp &Mcoo32Comp_O, &Mcoo32Comp_IO;
+
+typedef MatCooH<Doub, Int> Mcooh32Doub;
+typedef const Mcooh32Doub &Mcooh32Doub_I;
+typedef Mcooh32Doub &Mcooh32Doub_O, &Mcooh32Doub_IO;
+
+typedef MatCooH<Comp, Int> Mcooh32Comp;
+typedef const Mcooh32Comp &Mcooh32Comp_I;
+typedef Mcooh32Comp &Mcooh32Comp_O, &Mcooh32Comp_IO;
+
+typedef MatCsr<Doub, Int> Mcsr32Doub;
+typedef const Mcsr32Doub &Mcsr32Doub_I;
+typedef Mcsr32Doub &Mcsr32Doub_O, &Mcsr32Doub_IO;
+
+typedef MatCsr<Comp, Int> Mcsr32Comp;
+typedef const Mcsr32Comp &Mcsr32Comp_I;
+typedef Mcsr32Comp &Mcsr32Comp_O, &Mcsr32Comp_IO;
+
+typedef MatSell<Doub, Int> Msell32Doub;
+typedef const Msell32Doub &Msell32Doub_I;
+typedef Msell32Doub &Msell32Doub_O, &Msell32Doub_IO;
+
+typedef MatSell<Comp, Int> Msell32Comp;
+typedef const Msell32Comp &Msell32Comp_I;
+typedef Msell32Comp &Msell32Comp_O, &Msell32Comp_IO;
+
 typedef CmatObd<Int> CmobdInt;
 typedef const CmobdInt &CmobdInt_I;
 typedef CmobdInt &CmobdInt_O, &CmobdInt_IO;
@@ -726,6 +783,9 @@ typedef FlmComp &FlmComp_O, &FlmComp_IO;
 typedef const Matt &Matt_I;
 typedef Matt &Matt_O, &Matt_IO;
 
+typedef const Matb &Matb_I;
+typedef Matb &Matb_O, &Matb_IO;
+
 template <class T> using vector_I = const vector<T> &;
 template <class T> using vector_O = vector<T> &;
 template <class T> using vector_IO = vector<T> &;
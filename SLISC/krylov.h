@@ -0,0 +1,714 @@
+// Krylov subspace iterative solvers for A*x = b: CG, MINRES, GMRES(m), BiCGSTAB
+// A can be any class with mul(T *y, const Tmat &A, T *x) defined (y = A * x), see sparse_arith.h
+// a preconditioner M defines mul(T *y, const Tprec &M, T *x) to compute y = M^{-1} * x
+// x is used as the initial guess, tol is a relative tolerance (see each solver for the stopping rule)
+// return the number of iterations, or -1 if not converged
+#pragma once
+#include "sparse_arith.h"
+#include "band_lin_eq.h"
+
+namespace slisc {
+
+// workspace of Krylov solvers, reuse it to avoid allocation in each solve
+template <class T>
+class KrylovWsp
+{
+private:
+    Vector<T> m_v;
+public:
+    KrylovWsp() : m_v(0) {}
+    // get at least N elements, data will be lost if reallocated
+    T *get(Long_I N)
+    {
+        if (m_v.size() < N)
+            m_v.resize(N);
+        return m_v.ptr();
+    }
+};
+
+// ============ preconditioners ============
+
+// no preconditioning
+class PrecIdent
+{
+private:
+    Long m_N;
+public:
+    PrecIdent(Long_I N) : m_N(N) {}
+    Long n1() const { return m_N; }
+};
+
+template <class T>
+inline void mul(T *y, const PrecIdent &M, T *x)
+{
+    veccpy(y, x, M.n1());
+}
+
+// Jacobi (diagonal) preconditioner
+template <class T>
+class PrecJacobi
+{
+private:
+    Vector<T> m_inv_diag;
+    void invert();
+public:
+    template <class Tind>
+    PrecJacobi(const MatCoo<T, Tind> &a);
+    template <class Tind>
+    PrecJacobi(const MatCooH<T, Tind> &a);
+    template <class Tind>
+    PrecJacobi(const MatCsr<T, Tind> &a);
+    PrecJacobi(const CmatObd<T> &a);
+    Long n1() const;
+    const T *ptr() const; // inverse of diagonal elements
+};
+
+template <class T>
+inline void PrecJacobi<T>::invert()
+{
+    for (Long i = 0; i < m_inv_diag.size(); ++i) {
+        if (m_inv_diag[i] == T(0))
+            SLS_ERR("PrecJacobi: zero diagonal element!");
+        m_inv_diag[i] = T(1) / m_inv_diag[i];
+    }
+}
+
+template <class T>
+template <class Tind>
+PrecJacobi<T>::PrecJacobi(const MatCoo<T, Tind> &a) : m_inv_diag(a.n1(), T(0))
+{
+    for (Long k = 0; k < a.nnz(); ++k)
+        if (a.row(k) == a.col(k))
+            m_inv_diag[a.row(k)] += a(k);
+    invert();
+}
+
+template <class T>
+template <class Tind>
+PrecJacobi<T>::PrecJacobi(const MatCooH<T, Tind> &a) : m_inv_diag(a.n1(), T(0))
+{
+    for (Long k = 0; k < a.nnz(); ++k)
+        if (a.row(k) == a.col(k))
+            m_inv_diag[a.row(k)] += a(k);
+    invert();
+}
+
+template <class T>
+template <class Tind>
+PrecJacobi<T>::PrecJacobi(const MatCsr<T, Tind> &a) : m_inv_diag(a.n1(), T(0))
+{
+    const Long *row = a.row_ptr();
+    for (Long i = 0; i < a.n1(); ++i)
+        for (Long k = row[i]; k < row[i + 1]; ++k)
+            if (a.col(k) == i)
+                m_inv_diag[i] += a(k);
+    invert();
+}
+
+template <class T>
+PrecJacobi<T>::PrecJacobi(const CmatObd<T> &a) : m_inv_diag(a.n1())
+{
+    for (Long i = 0; i < a.n1(); ++i)
+        m_inv_diag[i] = a(i, i);
+    invert();
+}
+
+template <class T>
+inline Long PrecJacobi<T>::n1() const
+{
+    return m_inv_diag.size();
+}
+
+template <class T>
+inline const T *PrecJacobi<T>::ptr() const
+{
+    return m_inv_diag.ptr();
+}
+
+template <class T, class T1, SLS_IF(is_promo<T1, T>())>
+inline void mul(T1 *y, const PrecJacobi<T> &M, T1 *x)
+{
+    const T *d = M.ptr();
+    for (Long i = 0; i < M.n1(); ++i)
+        y[i] = d[i] * x[i];
+}
+
+// incomplete LU factorization with no fill-in, L*U has the sparsity pattern of A
+// all diagonal elements must exist in the pattern
+// for CmatObd, the exact LU (LuBand) has no fill-in either and can be used directly
+template <class T, class Tind = Long>
+class PrecIlu0
+{
+private:
+    Long m_N;
+    VecLong m_row; // CSR of L (unit diagonal not stored) and U
+    Vector<Tind> m_col;
+    Vector<T> m_a;
+    VecLong m_diag; // index of diagonal element of each row
+    void factor();
+public:
+    PrecIlu0(const MatCsr<T, Tind> &a);
+    PrecIlu0(const MatCoo<T, Tind> &a);
+    Long n1() const;
+    // y = (LU)^{-1} x
+    template <class T1>
+    void solve(T1 *y, const T1 *x) const;
+};
+
+template <class T, class Tind>
+PrecIlu0<T, Tind>::PrecIlu0(const MatCsr<T, Tind> &a)
+    : m_N(a.n1()), m_row(a.n1() + 1), m_col(a.nnz()), m_a(a.nnz()), m_diag(a.n1())
+{
+    veccpy(m_row.ptr(), a.row_ptr(), m_N + 1);
+    veccpy(m_col.ptr(), a.col_ptr(), a.nnz());
+    veccpy(m_a.ptr(), a.ptr(), a.nnz());
+    factor();
+}
+
+template <class T, class Tind>
+PrecIlu0<T, Tind>::PrecIlu0(const MatCoo<T, Tind> &a)
+    : m_N(a.n1()), m_row(0), m_col(0), m_a(0), m_diag(a.n1())
+{
+    MatCoo<T, Tind> b(a.n1(), a.n2(), a.nnz());
+    b = a; b.sum_dup();
+    MatCsr<T, Tind> c(a.n1(), a.n2());
+    c = b;
+    m_row.resize(m_N + 1); m_col.resize(c.nnz()); m_a.resize(c.nnz());
+    veccpy(m_row.ptr(), c.row_ptr(), m_N + 1);
+    veccpy(m_col.ptr(), c.col_ptr(), c.nnz());
+    veccpy(m_a.ptr(), c.ptr(), c.nnz());
+    factor();
+}
+
+template <class T, class Tind>
+void PrecIlu0<T, Tind>::factor()
+{
+    VecLong pos(m_N, Long(-1)); // position of each column in the current row
+    for (Long i = 0; i < m_N; ++i) {
+        m_diag[i] = -1;
+        for (Long q = m_row[i]; q < m_row[i + 1]; ++q) {
+            pos[m_col[q]] = q;
+            if (m_col[q] == i)
+                m_diag[i] = q;
+        }
+        if (m_diag[i] < 0)
+            SLS_ERR("PrecIlu0: diagonal element does not exist!");
+        for (Long p = m_row[i]; p < m_diag[i]; ++p) {
+            Long k = m_col[p];
+            m_a[p] /= m_a[m_diag[k]];
+            T s = m_a[p];
+            for (Long q = m_diag[k] + 1; q < m_row[k + 1]; ++q)
+                if (pos[m_col[q]] >= 0)
+                    m_a[pos[m_col[q]]] -= s * m_a[q];
+        }
+        for (Long q = m_row[i]; q < m_row[i + 1]; ++q)
+            pos[m_col[q]] = -1;
+        if (m_a[m_diag[i]] == T(0))
+            SLS_ERR("PrecIlu0: zero pivot!");
+    }
+}
+
+template <class T, class Tind>
+inline Long PrecIlu0<T, Tind>::n1() const
+{
+    return m_N;
+}
+
+template <class T, class Tind>
+template <class T1>
+void PrecIlu0<T, Tind>::solve(T1 *y, const T1 *x) const
+{
+    for (Long i = 0; i < m_N; ++i) {
+        T1 s = x[i];
+        for (Long p = m_row[i]; p < m_diag[i]; ++p)
+            s -= m_a[p] * y[m_col[p]];
+        y[i] = s;
+    }
+    for (Long i = m_N - 1; i >= 0; --i) {
+        T1 s = y[i];
+        for (Long p = m_diag[i] + 1; p < m_row[i + 1]; ++p)
+            s -= m_a[p] * y[m_col[p]];
+        y[i] = s / m_a[m_diag[i]];
+    }
+}
+
+template <class T, class Tind, class T1, SLS_IF(is_promo<T1, T>())>
+inline void mul(T1 *y, const PrecIlu0<T, Tind> &M, T1 *x)
+{
+    M.solve(y, x);
+}
+
+// block Jacobi preconditioner, diagonal blocks of size blk_size are inverted with LU decomposition
+// the last block can be smaller
+template <class T>
+class PrecBlockJacobi
+{
+private:
+    Long m_blk_size;
+    Band<T> m_band; // diagonal blocks in band storage
+    LuBand<T> m_lu;
+    static Long band_width(Long_I blk_size); // m_band.nup() = m_band.nlow()
+    void init(); // set m_band to 0
+    void add(const T &s, Long_I i, Long_I j); // add to block element if (i, j) is in a diagonal block
+public:
+    template <class Tind>
+    PrecBlockJacobi(const MatCoo<T, Tind> &a, Long_I blk_size);
+    template <class Tind>
+    PrecBlockJacobi(const MatCooH<T, Tind> &a, Long_I blk_size);
+    template <class Tind>
+    PrecBlockJacobi(const MatCsr<T, Tind> &a, Long_I blk_size);
+    PrecBlockJacobi(const CmatObd<T> &a, Long_I blk_size);
+    Long n1() const;
+    const LuBand<T> &lu() const;
+};
+
+template <class T>
+inline Long PrecBlockJacobi<T>::band_width(Long_I blk_size)
+{
+    if (blk_size < 1) {
+        SLS_ERR("PrecBlockJacobi: illegal block size!"); return 0;
+    }
+    return blk_size - 1;
+}
+
+template <class T>
+inline void PrecBlockJacobi<T>::init()
+{
+    Long N = m_band.n2() * (m_band.nup() + m_band.nlow() + 1);
+    if (N > 0)
+        vecset(m_band.ptr(), T(0), N);
+}
+
+// band storage: element (i, j) is at row nup() + i - j, column j, see mat2band()
+template <class T>
+inline void PrecBlockJacobi<T>::add(const T &s, Long_I i, Long_I j)
+{
+    if (i / m_blk_size == j / m_blk_size)
+        m_band.ptr()[m_blk_size - 1 + i - j + (2 * m_blk_size - 1) * j] += s;
+}
+
+template <class T>
+template <class Tind>
+PrecBlockJacobi<T>::PrecBlockJacobi(const MatCoo<T, Tind> &a, Long_I blk_size)
+    : m_blk_size(blk_size),
+    m_band(a.n1(), a.n1(), band_width(blk_size), band_width(blk_size))
+{
+    init();
+    for (Long k = 0; k < a.nnz(); ++k)
+        add(a(k), a.row(k), a.col(k));
+    m_lu.factor(m_band);
+}
+
+template <class T>
+template <class Tind>
+PrecBlockJacobi<T>::PrecBlockJacobi(const MatCooH<T, Tind> &a, Long_I blk_size)
+    : m_blk_size(blk_size),
+    m_band(a.n1(), a.n1(), band_width(blk_size), band_width(blk_size))
+{
+    init();
+    for (Long k = 0; k < a.nnz(); ++k) {
+        Long i = a.row(k), j = a.col(k);
+        add(a(k), i, j);
+        if (i != j)
+            add(CONJ(a(k)), j, i);
+    }
+    m_lu.factor(m_band);
+}
+
+template <class T>
+template <class Tind>
+PrecBlockJacobi<T>::PrecBlockJacobi(const MatCsr<T, Tind> &a, Long_I blk_size)
+    : m_blk_size(blk_size),
+    m_band(a.n1(), a.n1(), band_width(blk_size), band_width(blk_size))
+{
+    init();
+    const Long *row = a.row_ptr();
+    for (Long i = 0; i < a.n1(); ++i)
+        for (Long k = row[i]; k < row[i + 1]; ++k)
+            add(a(k), i, a.col(k));
+    m_lu.factor(m_band);
+}
+
+template <class T>
+PrecBlockJacobi<T>::PrecBlockJacobi(const CmatObd<T> &a, Long_I blk_size)
+    : m_blk_size(blk_size),
+    m_band(a.n1(), a.n1(), band_width(blk_size), band_width(blk_size))
+{
+    Long N = a.n1();
+    init();
+    for (Long j = 0; j < N; ++j) {
+        Long i0 = j / blk_size * blk_size, i1 = MIN(i0 + blk_size, N);
+        for (Long i = i0; i < i1; ++i)
+            add(a(i, j), i, j);
+    }
+    m_lu.factor(m_band);
+}
+
+template <class T>
+inline Long PrecBlockJacobi<T>::n1() const
+{
+    return m_lu.n1();
+}
+
+template <class T>
+inline const LuBand<T> &PrecBlockJacobi<T>::lu() const
+{
+    return m_lu;
+}
+
+// direct band solvers can also be used as preconditioners
+template <class T>
+inline void mul(T *y, const LuBand<T> &M, T *x)
+{
+    veccpy(y, x, M.n1());
+    M.solve(y);
+}
+
+template <class T>
+inline void mul(T *y, const LdlBand<T> &M, T *x)
+{
+    veccpy(y, x, M.n1());
+    M.solve(y);
+}
+
+template <class T>
+inline void mul(T *y, const PrecBlockJacobi<T> &M, T *x)
+{
+    mul(y, M.lu(), x);
+}
+
+// ============ solvers ============
+
+// 2-norm
+template <class T>
+inline rm_comp<T> norm_krylov(const T *v, Long_I N)
+{
+    return sqrt(real(dot_vv(v, v, N)));
+}
+
+// conjugate gradient, A and M must be Hermitian positive definite
+// stops when |b - A*x| <= tol * |b| (2-norm), one matrix-vector multiplication per iteration
+template <class T, class Tmat, class Tprec>
+Long cg(T *x, const Tmat &a, const T *b, Long_I N, const Tprec &M,
+    Doub_I tol, Long_I Nmax, KrylovWsp<T> &wsp)
+{
+    T *r = wsp.get(4 * N), *z = r + N, *p = z + N, *q = p + N;
+    rm_comp<T> bnorm = norm_krylov(b, N);
+    if (bnorm == 0) {
+        vecset(x, T(0), N); return 0;
+    }
+    mul(q, a, x);
+    for (Long i = 0; i < N; ++i)
+        r[i] = b[i] - q[i];
+    if (norm_krylov(r, N) <= tol * bnorm)
+        return 0;
+    mul(z, M, r);
+    veccpy(p, z, N);
+    T rz = dot_vv(r, z, N);
+    for (Long it = 1; it <= Nmax; ++it) {
+        mul(q, a, p);
+        T alpha = rz / dot_vv(p, q, N);
+        for (Long i = 0; i < N; ++i) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+        if (norm_krylov(r, N) <= tol * bnorm)
+            return it;
+        mul(z, M, r);
+        T rz_new = dot_vv(r, z, N);
+        T beta = rz_new / rz;
+        rz = rz_new;
+        for (Long i = 0; i < N; ++i)
+            p[i] = z[i] + beta * p[i];
+    }
+    return -1;
+}
+
+// MINRES for Hermitian (possibly indefinite) A, M must be Hermitian positive definite
+// ref: C. C. Paige and M. A. Saunders, SIAM J. Numer. Anal. 12, 617 (1975)
+// stops when the preconditioned residual norm sqrt(r^H * M^{-1} * r) <= tol times its initial value,
+// or if |b - A*x| <= tol * |b| for the initial guess, one matrix-vector multiplication per iteration
+template <class T, class Tmat, class Tprec>
+Long minres(T *x, const Tmat &a, const T *b, Long_I N, const Tprec &M,
+    Doub_I tol, Long_I Nmax, KrylovWsp<T> &wsp)
+{
+    typedef rm_comp<T> Tr;
+    T *r1 = wsp.get(7 * N), *r2 = r1 + N, *y = r2 + N, *v = y + N,
+        *w = v + N, *w1 = w + N, *w2 = w1 + N;
+    mul(y, a, x);
+    for (Long i = 0; i < N; ++i)
+        r1[i] = b[i] - y[i];
+    mul(y, M, r1);
+    Tr beta1 = real(dot_vv(r1, y, N));
+    if (beta1 < 0)
+        SLS_ERR("minres: preconditioner is not positive definite!");
+    beta1 = sqrt(beta1);
+    if (beta1 == 0)
+        return 0;
+    Tr bnorm = sqrt(real(dot_vv(b, b, N))); // for the first residual test only
+    if (norm_krylov(r1, N) <= tol * bnorm)
+        return 0;
+    veccpy(r2, r1, N);
+    vecset(w, T(0), N); vecset(w2, T(0), N);
+    Tr oldb = 0, beta = beta1, dbar = 0, epsln = 0, phibar = beta1, cs = -1, sn = 0;
+    for (Long it = 1; it <= Nmax; ++it) {
+        Tr s = 1 / beta;
+        for (Long i = 0; i < N; ++i)
+            v[i] = s * y[i];
+        mul(y, a, v);
+        if (it >= 2) {
+            Tr t = beta / oldb;
+            for (Long i = 0; i < N; ++i)
+                y[i] -= t * r1[i];
+        }
+        Tr alfa = real(dot_vv(v, y, N));
+        Tr t = alfa / beta;
+        for (Long i = 0; i < N; ++i)
+            y[i] -= t * r2[i];
+        swap(r1, r2); veccpy(r2, y, N);
+        mul(y, M, r2);
+        oldb = beta;
+        beta = real(dot_vv(r2, y, N));
+        if (beta < 0)
+            SLS_ERR("minres: preconditioner is not positive definite!");
+        beta = sqrt(beta);
+
+        // apply previous rotation, then compute and apply the new one
+        Tr oldeps = epsln;
+        Tr delta = cs * dbar + sn * alfa;
+        Tr gbar = sn * dbar - cs * alfa;
+        epsln = sn * beta;
+        dbar = -cs * beta;
+        Tr gamma = MAX(sqrt(gbar * gbar + beta * beta), std::numeric_limits<Tr>::min());
+        cs = gbar / gamma; sn = beta / gamma;
+        Tr phi = cs * phibar;
+        phibar = sn * phibar;
+
+        // update solution
+        swap(w1, w2); swap(w2, w); // w1 <- w2, w2 <- w
+        Tr denom = 1 / gamma;
+        for (Long i = 0; i < N; ++i) {
+            w[i] = (v[i] - oldeps * w1[i] - delta * w2[i]) * denom;
+            x[i] += phi * w[i];
+        }
+        if (phibar <= tol * beta1 || beta == 0)
+            return it;
+    }
+    return -1;
+}
+
+// restarted GMRES(m) for general A, with right preconditioning
+// stops when the true (unpreconditioned) residual |b - A*x| <= tol * |b|
+// one matrix-vector multiplication per iteration, plus one for each restart
+// ref: Y. Saad, Iterative Methods for Sparse Linear Systems, 2nd ed., Algorithm 9.5
+template <class T, class Tmat, class Tprec>
+Long gmres(T *x, const Tmat &a, const T *b, Long_I N, const Tprec &M, Long_I m,
+    Doub_I tol, Long_I Nmax, KrylovWsp<T> &wsp)
+{
+    typedef rm_comp<T> Tr;
+    // V(N, m+1), H(m+1, m), sn(m), g(m+1), cs(m), z(N), u(N)
+    Long Nh = (m + 1) * m;
+    T *V = wsp.get(N * (m + 1) + Nh + 3 * (m + 1) + 2 * N), *H = V + N * (m + 1),
+        *sn = H + Nh, *g = sn + m + 1, *csT = g + m + 1, *z = csT + m + 1, *u = z + N;
+    Tr bnorm = norm_krylov(b, N);
+    if (bnorm == 0) {
+        vecset(x, T(0), N); return 0;
+    }
+    Long it = 0;
+    while (true) {
+        // r = b - A*x
+        T *r = V;
+        mul(z, a, x);
+        for (Long i = 0; i < N; ++i)
+            r[i] = b[i] - z[i];
+        Tr beta = norm_krylov(r, N);
+        if (beta <= tol * bnorm)
+            return it;
+        if (it >= Nmax)
+            return -1;
+        times_equals_vs(r, T(1 / beta), N);
+        vecset(g, T(0), m + 1); g[0] = beta;
+        Long k = 0; // dimension of Krylov subspace
+        for (Long j = 0; j < m && it < Nmax; ++j) {
+            ++it; k = j + 1;
+            T *vj = V + N * j, *w = vj + N, *hj = H + (m + 1) * j;
+            mul(z, M, vj);
+            mul(w, a, z);
+            // modified Gram-Schmidt
+            for (Long i = 0; i <= j; ++i) {
+                T *vi = V + N * i;
+                T h = dot_vv(vi, w, N);
+                hj[i] = h;
+                for (Long n = 0; n < N; ++n)
+                    w[n] -= h * vi[n];
+            }
+            Tr hnext = norm_krylov(w, N);
+            hj[j + 1] = hnext;
+            if (hnext != 0)
+                times_equals_vs(w, T(1 / hnext), N);
+            // apply previous Givens rotations to the new column
+            for (Long i = 0; i < j; ++i) {
+                T t = csT[i] * hj[i] + sn[i] * hj[i + 1];
+                hj[i + 1] = -CONJ(sn[i]) * hj[i] + csT[i] * hj[i + 1];
+                hj[i] = t;
+            }
+            // new rotation to eliminate hj[j+1]
+            Tr aa = abs(hj[j]), rr = sqrt(aa * aa + hnext * hnext);
+            if (aa == 0) {
+                csT[j] = 0; sn[j] = 1;
+            }
+            else {
+                csT[j] = aa / rr;
+                sn[j] = hj[j] / aa * hnext / rr;
+            }
+            hj[j] = csT[j] * hj[j] + sn[j] * hj[j + 1];
+            hj[j + 1] = 0;
+            g[j + 1] = -CONJ(sn[j]) * g[j];
+            g[j] = csT[j] * g[j];
+            if (abs(g[j + 1]) <= tol * bnorm || hnext == 0)
+                break;
+        }
+        // solve upper triangular H(0:k, 0:k) * y = g, y is stored in g
+        for (Long i = k - 1; i >= 0; --i) {
+            T s = g[i];
+            for (Long j = i + 1; j < k; ++j)
+                s -= H[(m + 1) * j + i] * g[j];
+            g[i] = s / H[(m + 1) * i + i];
+        }
+        // x += M^{-1} * V * y
+        vecset(u, T(0), N);
+        for (Long j = 0; j < k; ++j) {
+            T *vj = V + N * j;
+            for (Long n = 0; n < N; ++n)
+                u[n] += g[j] * vj[n];
+        }
+        mul(z, M, u);
+        for (Long n = 0; n < N; ++n)
+            x[n] += z[n];
+    }
+}
+
+// BiCGSTAB for general A, with right preconditioning
+// ref: H. A. van der Vorst, SIAM J. Sci. Stat. Comput. 13, 631 (1992)
+// stops when |b - A*x| <= tol * |b|, two matrix-vector multiplications per iteration
+// (one in the last iteration if it converges after the first half step)
+template <class T, class Tmat, class Tprec>
+Long bicgstab(T *x, const Tmat &a, const T *b, Long_I N, const Tprec &M,
+    Doub_I tol, Long_I Nmax, KrylovWsp<T> &wsp)
+{
+    typedef rm_comp<T> Tr;
+    T *r = wsp.get(7 * N), *r0 = r + N, *p = r0 + N, *v = p + N,
+        *ph = v + N, *sh = ph + N, *t = sh + N; // s is stored in r
+    Tr bnorm = norm_krylov(b, N);
+    if (bnorm == 0) {
+        vecset(x, T(0), N); return 0;
+    }
+    mul(t, a, x);
+    for (Long i = 0; i < N; ++i)
+        r[i] = b[i] - t[i];
+    if (norm_krylov(r, N) <= tol * bnorm)
+        return 0;
+    veccpy(r0, r, N);
+    vecset(p, T(0), N); vecset(v, T(0), N);
+    T rho = 1, alpha = 1, omega = 1;
+    for (Long it = 1; it <= Nmax; ++it) {
+        T rho_new = dot_vv(r0, r, N);
+        if (rho_new == T(0))
+            SLS_ERR("bicgstab: breakdown!");
+        T beta = (rho_new / rho) * (alpha / omega);
+        rho = rho_new;
+        for (Long i = 0; i < N; ++i)
+            p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        mul(ph, M, p);
+        mul(v, a, ph);
+        alpha = rho / dot_vv(r0, v, N);
+        for (Long i = 0; i < N; ++i)
+            r[i] -= alpha * v[i];
+        if (norm_krylov(r, N) <= tol * bnorm) {
+            for (Long i = 0; i < N; ++i)
+                x[i] += alpha * ph[i];
+            return it;
+        }
+        mul(sh, M, r);
+        mul(t, a, sh);
+        Tr tt = real(dot_vv(t, t, N));
+        omega = tt == 0 ? T(0) : dot_vv(t, r, N) / tt;
+        for (Long i = 0; i < N; ++i) {
+            x[i] += alpha * ph[i] + omega * sh[i];
+            r[i] -= omega * t[i];
+        }
+        if (norm_krylov(r, N) <= tol * bnorm)
+            return it;
+        if (omega == T(0))
+            SLS_ERR("bicgstab: breakdown!");
+    }
+    return -1;
+}
+
+// ============ dense vector interface ============
+
+template <class Tx, class Tmat, class Tb, class Tprec, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long cg(Tx &x, const Tmat &a, const Tb &b, const Tprec &M,
+    Doub_I tol, Long_I Nmax, KrylovWsp<contain_type<Tx>> &wsp)
+{
+    return cg(x.ptr(), a, b.ptr(), x.size(), M, tol, Nmax, wsp);
+}
+
+template <class Tx, class Tmat, class Tb, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long cg(Tx &x, const Tmat &a, const Tb &b, Doub_I tol, Long_I Nmax)
+{
+    KrylovWsp<contain_type<Tx>> wsp;
+    return cg(x.ptr(), a, b.ptr(), x.size(), PrecIdent(x.size()), tol, Nmax, wsp);
+}
+
+template <class Tx, class Tmat, class Tb, class Tprec, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long minres(Tx &x, const Tmat &a, const Tb &b, const Tprec &M,
+    Doub_I tol, Long_I Nmax, KrylovWsp<contain_type<Tx>> &wsp)
+{
+    return minres(x.ptr(), a, b.ptr(), x.size(), M, tol, Nmax, wsp);
+}
+
+template <class Tx, class Tmat, class Tb, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long minres(Tx &x, const Tmat &a, const Tb &b, Doub_I tol, Long_I Nmax)
+{
+    KrylovWsp<contain_type<Tx>> wsp;
+    return minres(x.ptr(), a, b.ptr(), x.size(), PrecIdent(x.size()), tol, Nmax, wsp);
+}
+
+template <class Tx, class Tmat, class Tb, class Tprec, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long gmres(Tx &x, const Tmat &a, const Tb &b, const Tprec &M, Long_I m,
+    Doub_I tol, Long_I Nmax, KrylovWsp<contain_type<Tx>> &wsp)
+{
+    return gmres(x.ptr(), a, b.ptr(), x.size(), M, m, tol, Nmax, wsp);
+}
+
+template <class Tx, class Tmat, class Tb, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long gmres(Tx &x, const Tmat &a, const Tb &b, Long_I m, Doub_I tol, Long_I Nmax)
+{
+    KrylovWsp<contain_type<Tx>> wsp;
+    return gmres(x.ptr(), a, b.ptr(), x.size(), PrecIdent(x.size()), m, tol, Nmax, wsp);
+}
+
+template <class Tx, class Tmat, class Tb, class Tprec, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long bicgstab(Tx &x, const Tmat &a, const Tb &b, const Tprec &M,
+    Doub_I tol, Long_I Nmax, KrylovWsp<contain_type<Tx>> &wsp)
+{
+    return bicgstab(x.ptr(), a, b.ptr(), x.size(), M, tol, Nmax, wsp);
+}
+
+template <class Tx, class Tmat, class Tb, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Tb>() && is_same<contain_type<Tx>, contain_type<Tb>>())>
+inline Long bicgstab(Tx &x, const Tmat &a, const Tb &b, Doub_I tol, Long_I Nmax)
+{
+    KrylovWsp<contain_type<Tx>> wsp;
+    return bicgstab(x.ptr(), a, b.ptr(), x.size(), PrecIdent(x.size()), tol, Nmax, wsp);
+}
+
+} // namespace slisc
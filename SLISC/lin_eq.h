@@ -1,10 +1,13 @@
 #pragma once
 #include "global.h"
 #include "cmat.h"
+#include "copy.h"
+#include "scalar_arith.h"
 
 namespace slisc {
 
 #ifdef SLS_USE_LAPACKE
+// for solving linear equations, use Lu<T> instead, which is faster and more accurate
 template<class Tmat, SLS_IF(
     is_dense_mat<Tmat>() && is_Doub<contain_type<Tmat>>())>
 inline void inv_mat(Tmat &A)
@@ -19,5 +22,372 @@ inline void inv_mat(Tmat &A)
     LAPACKE_dgetri(LAPACK_COL_MAJOR, N, A.ptr(), N, ipiv.ptr());
 }
 #endif
-    
+
+// ============ dense LU and Cholesky factorization ============
+// factorize once, then solve for any number of right hand sides, O(N^2) for each
+// uses ?getrf/?getrs, ?potrf/?potrs if SLS_USE_LAPACKE, otherwise the native blocked algorithms below
+
+// block size of the native algorithms
+const Long lin_eq_blk = 64;
+
+// native blocked LU decomposition with partial pivoting, same output as ?getrf()
+// a (N, N) column major is overwritten by L and U, ipiv is 1-based (LAPACK convention)
+template <class T>
+inline void lu_native(T *a, Int *ipiv, Long_I N)
+{
+    for (Long j0 = 0; j0 < N; j0 += lin_eq_blk) {
+        Long j1 = MIN(j0 + lin_eq_blk, N);
+        // factor the panel a(j0:N, j0:j1), with row interchanges on the whole rows
+        for (Long j = j0; j < j1; ++j) {
+            T *aj = a + N * j;
+            Long p = j;
+            Doub amax = abs(aj[j]);
+            for (Long i = j + 1; i < N; ++i) {
+                if (abs(aj[i]) > amax) {
+                    amax = abs(aj[i]); p = i;
+                }
+            }
+            ipiv[j] = Int(p + 1);
+            if (aj[p] == T(0))
+                SLS_ERR("Lu: matrix is singular!");
+            if (p != j) {
+                for (Long c = 0; c < N; ++c)
+                    swap(a[j + N * c], a[p + N * c]);
+            }
+            T s = T(1) / aj[j];
+            for (Long i = j + 1; i < N; ++i)
+                aj[i] *= s;
+            // update the rest of the panel
+            for (Long c = j + 1; c < j1; ++c) {
+                T *ac = a + N * c, t = ac[j];
+                if (t == T(0))
+                    continue;
+                for (Long i = j + 1; i < N; ++i)
+                    ac[i] -= aj[i] * t;
+            }
+        }
+        // U12 = L11^{-1} * A12, A22 -= L21 * U12, one column at a time
+        for (Long c = j1; c < N; ++c) {
+            T *ac = a + N * c;
+            for (Long k = j0; k < j1; ++k) {
+                T t = ac[k];
+                if (t == T(0))
+                    continue;
+                const T *ak = a + N * k;
+                for (Long i = k + 1; i < N; ++i)
+                    ac[i] -= ak[i] * t;
+            }
+        }
+    }
+}
+
+// solve A*X = B using the output of lu_native() or ?getrf(), x (N, Ncol) is overwritten
+template <class T>
+inline void lu_solve_native(T *x, const T *lu, const Int *ipiv, Long_I N, Long_I Ncol)
+{
+    for (Long c = 0; c < Ncol; ++c) {
+        T *xc = x + N * c;
+        for (Long j = 0; j < N; ++j)
+            if (ipiv[j] - 1 != j)
+                swap(xc[j], xc[ipiv[j] - 1]);
+        for (Long j = 0; j < N; ++j) {
+            T s = xc[j];
+            if (s == T(0))
+                continue;
+            const T *lj = lu + N * j;
+            for (Long i = j + 1; i < N; ++i)
+                xc[i] -= lj[i] * s;
+        }
+        for (Long j = N - 1; j >= 0; --j) {
+            const T *uj = lu + N * j;
+            T s = (xc[j] /= uj[j]);
+            for (Long i = 0; i < j; ++i)
+                xc[i] -= uj[i] * s;
+        }
+    }
+}
+
+// native blocked Cholesky decomposition A = L*L^H, same output as ?potrf('L')
+// only the lower triangle of a (N, N) is used and overwritten by L
+template <class T>
+inline void chol_native(T *a, Long_I N)
+{
+    for (Long j0 = 0; j0 < N; j0 += lin_eq_blk) {
+        Long j1 = MIN(j0 + lin_eq_blk, N);
+        // factor the panel a(j0:N, j0:j1), left looking inside the panel
+        for (Long j = j0; j < j1; ++j) {
+            T *aj = a + N * j;
+            for (Long k = j0; k < j; ++k) {
+                const T *ak = a + N * k;
+                T t = CONJ(ak[j]);
+                for (Long i = j; i < N; ++i)
+                    aj[i] -= ak[i] * t;
+            }
+            Doub d = real(aj[j]);
+            if (d <= 0)
+                SLS_ERR("Cholesky: matrix is not positive definite!");
+            d = sqrt(d);
+            aj[j] = d;
+            for (Long i = j + 1; i < N; ++i)
+                aj[i] /= d;
+        }
+        // A22 -= L21 * L21^H (lower triangle)
+        for (Long c = j1; c < N; ++c) {
+            T *ac = a + N * c;
+            for (Long k = j0; k < j1; ++k) {
+                const T *ak = a + N * k;
+                T t = CONJ(ak[c]);
+                for (Long i = c; i < N; ++i)
+                    ac[i] -= ak[i] * t;
+            }
+        }
+    }
+}
+
+// solve A*X = B using the output of chol_native() or ?potrf('L'), x (N, Ncol) is overwritten
+template <class T>
+inline void chol_solve_native(T *x, const T *l, Long_I N, Long_I Ncol)
+{
+    for (Long c = 0; c < Ncol; ++c) {
+        T *xc = x + N * c;
+        // L * Y = B
+        for (Long j = 0; j < N; ++j) {
+            const T *lj = l + N * j;
+            T s = (xc[j] /= real(lj[j]));
+            for (Long i = j + 1; i < N; ++i)
+                xc[i] -= lj[i] * s;
+        }
+        // L^H * X = Y
+        for (Long j = N - 1; j >= 0; --j) {
+            const T *lj = l + N * j;
+            T s = xc[j];
+            for (Long i = j + 1; i < N; ++i)
+                s -= CONJ(lj[i]) * xc[i];
+            xc[j] = s / real(lj[j]);
+        }
+    }
+}
+
+#ifdef SLS_USE_LAPACKE
+inline Int lapack_getrf(Doub *a, Int *ipiv, Int_I N)
+{ return LAPACKE_dgetrf(LAPACK_COL_MAJOR, N, N, a, N, ipiv); }
+
+inline Int lapack_getrf(Comp *a, Int *ipiv, Int_I N)
+{ return LAPACKE_zgetrf(LAPACK_COL_MAJOR, N, N, (double _Complex*)a, N, ipiv); }
+
+inline Int lapack_getrs(Doub *x, const Doub *lu, const Int *ipiv, Int_I N, Int_I Ncol)
+{ return LAPACKE_dgetrs(LAPACK_COL_MAJOR, 'N', N, Ncol, lu, N, ipiv, x, N); }
+
+inline Int lapack_getrs(Comp *x, const Comp *lu, const Int *ipiv, Int_I N, Int_I Ncol)
+{
+    return LAPACKE_zgetrs(LAPACK_COL_MAJOR, 'N', N, Ncol, (const double _Complex*)lu, N, ipiv,
+        (double _Complex*)x, N);
+}
+
+inline Int lapack_potrf(Doub *a, Int_I N)
+{ return LAPACKE_dpotrf(LAPACK_COL_MAJOR, 'L', N, a, N); }
+
+inline Int lapack_potrf(Comp *a, Int_I N)
+{ return LAPACKE_zpotrf(LAPACK_COL_MAJOR, 'L', N, (double _Complex*)a, N); }
+
+inline Int lapack_potrs(Doub *x, const Doub *l, Int_I N, Int_I Ncol)
+{ return LAPACKE_dpotrs(LAPACK_COL_MAJOR, 'L', N, Ncol, l, N, x, N); }
+
+inline Int lapack_potrs(Comp *x, const Comp *l, Int_I N, Int_I Ncol)
+{
+    return LAPACKE_zpotrs(LAPACK_COL_MAJOR, 'L', N, Ncol, (const double _Complex*)l, N,
+        (double _Complex*)x, N);
+}
+#endif
+
+// LU decomposition with partial pivoting, A = P*L*U
+// e.g. Lu<Doub> lu(A); then lu.solve(x) for each right hand side
+template <class T>
+class Lu
+{
+private:
+    Cmat<T> m_lu;
+    Vector<Int> m_ipiv; // row i was interchanged with row m_ipiv[i]-1
+public:
+    Lu();
+    template <class Tmat, SLS_IF(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+    Lu(const Tmat &a);
+    template <class Tmat, SLS_IF(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+    void factor(const Tmat &a);
+    Long n1() const;
+    Long n2() const;
+    // solve A*X = B, B is column major (n1(), Ncol), overwritten by X
+    void solve(T *x, Long_I Ncol = 1) const;
+    template <class Tx, SLS_IF(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+    void solve(Tx &x) const;
+};
+
+typedef Lu<Doub> LuDoub;
+typedef Lu<Comp> LuComp;
+
+template <class T>
+Lu<T>::Lu() : m_lu(0, 0), m_ipiv(0) {}
+
+template <class T>
+template <class Tmat, SLS_IF0(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+Lu<T>::Lu(const Tmat &a) : Lu()
+{
+    factor(a);
+}
+
+template <class T>
+template <class Tmat, SLS_IF0(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+void Lu<T>::factor(const Tmat &a)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n1() != a.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    Long N = a.n1();
+    m_lu.resize(N, N); m_ipiv.resize(N);
+    veccpy(m_lu.ptr(), a.ptr(), N * N);
+#ifdef SLS_USE_LAPACKE
+    if (lapack_getrf(m_lu.ptr(), m_ipiv.ptr(), (Int)N) != 0)
+        SLS_ERR("Lu: matrix is singular!");
+#else
+    lu_native(m_lu.ptr(), m_ipiv.ptr(), N);
+#endif
+}
+
+template <class T>
+Long Lu<T>::n1() const
+{
+    return m_lu.n1();
+}
+
+template <class T>
+Long Lu<T>::n2() const
+{
+    return m_lu.n1();
+}
+
+template <class T>
+void Lu<T>::solve(T *x, Long_I Ncol) const
+{
+#ifdef SLS_USE_LAPACKE
+    lapack_getrs(x, m_lu.ptr(), m_ipiv.ptr(), (Int)n1(), (Int)Ncol);
+#else
+    lu_solve_native(x, m_lu.ptr(), m_ipiv.ptr(), n1(), Ncol);
+#endif
+}
+
+template <class T>
+template <class Tx, SLS_IF0(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+void Lu<T>::solve(Tx &x) const
+{
+    static_assert(is_same<contain_type<Tx>, T>(), "type mismatch!");
+#ifdef SLS_CHECK_SHAPE
+    if (x.size() % n1() != 0)
+        SLS_ERR("wrong shape!");
+#endif
+    solve(x.ptr(), n1() == 0 ? 0 : x.size() / n1());
+}
+
+// Cholesky decomposition A = L*L^H for a real symmetric or Hermitian positive definite A
+// only the lower triangle of A is used
+template <class T>
+class Chol
+{
+private:
+    Cmat<T> m_l; // lower triangle is L
+public:
+    Chol();
+    template <class Tmat, SLS_IF(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+    Chol(const Tmat &a);
+    template <class Tmat, SLS_IF(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+    void factor(const Tmat &a);
+    Long n1() const;
+    Long n2() const;
+    // solve A*X = B, B is column major (n1(), Ncol), overwritten by X
+    void solve(T *x, Long_I Ncol = 1) const;
+    template <class Tx, SLS_IF(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+    void solve(Tx &x) const;
+};
+
+typedef Chol<Doub> CholDoub;
+typedef Chol<Comp> CholComp;
+
+template <class T>
+Chol<T>::Chol() : m_l(0, 0) {}
+
+template <class T>
+template <class Tmat, SLS_IF0(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+Chol<T>::Chol(const Tmat &a) : Chol()
+{
+    factor(a);
+}
+
+template <class T>
+template <class Tmat, SLS_IF0(is_dense_mat<Tmat>() && is_cmajor<Tmat>())>
+void Chol<T>::factor(const Tmat &a)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n1() != a.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    Long N = a.n1();
+    m_l.resize(N, N);
+    veccpy(m_l.ptr(), a.ptr(), N * N);
+#ifdef SLS_USE_LAPACKE
+    if (lapack_potrf(m_l.ptr(), (Int)N) != 0)
+        SLS_ERR("Cholesky: matrix is not positive definite!");
+#else
+    chol_native(m_l.ptr(), N);
+#endif
+}
+
+template <class T>
+Long Chol<T>::n1() const
+{
+    return m_l.n1();
+}
+
+template <class T>
+Long Chol<T>::n2() const
+{
+    return m_l.n1();
+}
+
+template <class T>
+void Chol<T>::solve(T *x, Long_I Ncol) const
+{
+#ifdef SLS_USE_LAPACKE
+    lapack_potrs(x, m_l.ptr(), (Int)n1(), (Int)Ncol);
+#else
+    chol_solve_native(x, m_l.ptr(), n1(), Ncol);
+#endif
+}
+
+template <class T>
+template <class Tx, SLS_IF0(is_dense_vec<Tx>() || (is_dense_mat<Tx>() && is_cmajor<Tx>()))>
+void Chol<T>::solve(Tx &x) const
+{
+    static_assert(is_same<contain_type<Tx>, T>(), "type mismatch!");
+#ifdef SLS_CHECK_SHAPE
+    if (x.size() % n1() != 0)
+        SLS_ERR("wrong shape!");
+#endif
+    solve(x.ptr(), n1() == 0 ? 0 : x.size() / n1());
+}
+
+// for Krylov solvers, e.g. as a preconditioner or in OpShiftInv
+template <class T>
+inline void mul(T *y, const Lu<T> &lu, T *x)
+{
+    veccpy(y, x, lu.n1());
+    lu.solve(y);
+}
+
+template <class T>
+inline void mul(T *y, const Chol<T> &chol, T *x)
+{
+    veccpy(y, x, chol.n1());
+    chol.solve(y);
+}
+
 } // namespace slisc
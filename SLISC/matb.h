@@ -0,0 +1,507 @@
+// save vectors and matrices to binary ".matb" files, the binary version of ".matt" files
+// data can be compressed in chunks with a byte-shuffle filter and a fast codec (see "compress.h")
+// chunks are compressed and decompressed in parallel with OpenMP
+//
+// file format (all integers are Long unless specified):
+// for each variable:
+//     name length, name characters (Char), type (Int), number of dimensions (Int), dimensions
+//     number of chunks, then for each chunk: raw bytes, stored bytes, method (Char)
+//     stored data of all chunks
+// at the end of file: positions of each variable, number of variables
+// data is in column major order, complex numbers are stored as (real, imag) pairs
+
+#pragma once
+#include "file.h"
+#include "compress.h"
+
+namespace slisc {
+
+// Matb class for binary mode
+class Matb {
+public:
+    Matb();
+    // comp: compression method for writing, see "compress.h"
+    Matb(Str_I fname, Char_I *rw, Int_I comp = 0);
+    Char m_rw; // 'r' for read 'w' for write
+    ifstream m_in; // read file
+    ofstream m_out; // write file
+    Int m_n; // variable numbers
+    Str fname; // name of the opened file
+    Int m_comp; // compression method for writing
+    Long m_chunk; // chunk size in bytes for writing
+    vector<Str> m_name; // variable names
+    vector<Int> m_type; // variable types
+    vector<vector<Long>> m_size; // variable dimensions
+    vector<Long> m_ind; // variable positions (the number of chunks)
+
+    // open a file, return 0 if success
+    // return -1 if reading failed (e.g. file is not finished, wrong format)
+    Int open(Str_I fname, Char_I *rw, Int_I comp = 0);
+
+    Bool isopen();
+
+    // close a file, if not called, will be called in destructor
+    void close();
+
+    // ===== internal functions =====
+
+    // get var names and positions from the end of the file
+    // return 0 if successful, return -1 if failed
+    Int get_profile();
+
+    // search a variable by name, return index to m_name[i]
+    // return -1 if not found
+    Int search(Str_I name);
+
+    // write a variable, data has N elements of elm_size bytes, in column major order
+    // for complex types, elm_size is the size of the real part
+    void write(Str_I varname, Int_I type, const vector<Long> &size,
+        const Uchar *data, Long_I N, Int_I elm_size);
+
+    // read the data of the i-th variable to data (m_size[i] determines the size)
+    void read(Uchar *data, Int_I i, Int_I elm_size);
+
+    template <class T>
+    void write_bin(const T &s);
+
+    template <class T>
+    void read_bin(T &s);
+
+    ~Matb();
+};
+
+inline Matb::Matb() : m_rw('\0'), m_n(0), m_comp(0), m_chunk(1 << 20) {}
+
+inline Matb::Matb(Str_I fname, Char_I *rw, Int_I comp) : Matb()
+{ open(fname, rw, comp); }
+
+template <class T>
+inline void Matb::write_bin(const T &s)
+{
+    m_out.write((const Char *)&s, sizeof(T));
+}
+
+template <class T>
+inline void Matb::read_bin(T &s)
+{
+    m_in.read((Char *)&s, sizeof(T));
+}
+
+inline Int Matb::open(Str_I fname, Char_I *rw, Int_I comp)
+{
+    if (isopen())
+        close();
+    this->fname = fname;
+    m_comp = comp;
+    if (rw[0] == 'w') {
+#ifndef SLS_MATT_REPLACE
+        if (file_exist(fname)) {
+            while (true) {
+                if (file_exist(fname)) {
+                    SLS_WARN("\n\nfile [" + fname + "] already exist! delete file to continue...\n"
+                        "  (define SLS_MATT_REPLACE to replace file by default)\n\n");
+                }
+                else {
+                    break;
+                }
+                pause(10);
+            }
+        }
+#endif
+        m_rw = 'w';
+        m_n = 0;
+        m_out = ofstream(fname, std::ios::binary);
+        if (!m_out.good())
+            SLS_ERR("error: file not created (directory does not exist ?): " + fname);
+    }
+    else {
+        m_rw = 'r';
+        m_in = ifstream(fname, std::ios::binary);
+        if (!m_in.good())
+            SLS_ERR("error: file not found: " + fname);
+        return get_profile(); // get var names
+    }
+    return 0;
+}
+
+inline Bool Matb::isopen()
+{
+    return m_in.is_open() != m_out.is_open();
+}
+
+inline void Matb::close()
+{
+    if (m_rw == 'w') {
+        // write position of variables
+        for (Long i = 0; i < (Long)m_ind.size(); ++i)
+            write_bin(m_ind[i]);
+        // write number of variables
+        write_bin((Long)m_n);
+        m_out.close();
+    }
+    else {
+        m_in.close();
+    }
+    m_rw = '\0';
+    m_n = 0;
+    m_name.clear();
+    m_type.clear();
+    m_size.clear();
+    m_ind.clear();
+}
+
+inline Int Matb::get_profile()
+{
+    Int i, j, type, ndim;
+    Long n, temp;
+    Str name;
+    ifstream &fin = m_in;
+
+    // read number of variables and their positions
+    fin.seekg(0, fin.end);
+    Long gmax = fin.tellg();
+    if (gmax < (Long)sizeof(Long))
+        return -1;
+    fin.seekg(gmax - sizeof(Long));
+    read_bin(n);
+    if (n < 1 || (n + 1) * (Long)sizeof(Long) > gmax)
+        return -1;
+    m_n = (Int)n;
+    m_ind.resize(m_n);
+    fin.seekg(gmax - (m_n + 1) * sizeof(Long));
+    for (i = 0; i < m_n; ++i) {
+        read_bin(m_ind[i]);
+        if (m_ind[i] >= gmax || m_ind[i] < 0)
+            return -1;
+        if (i > 0 && m_ind[i] <= m_ind[i - 1])
+            return -1;
+    }
+
+    // loop through each variable
+    for (i = 0; i < m_n; ++i) {
+        fin.seekg(m_ind[i]);
+        // read var name
+        read_bin(n);
+        if (n < 0 || n > 1000)
+            return -1;
+        name.resize(n);
+        if (n > 0)
+            fin.read(&name[0], n);
+        m_name.push_back(name);
+        // read var type
+        read_bin(type);
+        if (type < 0 || type > 100)
+            return -1;
+        m_type.push_back(type);
+        // read var dim
+        read_bin(ndim);
+        if (ndim < 0 || ndim > 10)
+            return -1;
+        m_size.push_back(vector<Long>(ndim));
+        for (j = 0; j < ndim; ++j) {
+            read_bin(temp);
+            if (temp < 0)
+                return -1;
+            m_size[i][j] = temp;
+        }
+        if (!fin.good())
+            return -1;
+        m_ind[i] = fin.tellg();
+    }
+    return 0;
+}
+
+inline Int Matb::search(Str_I name)
+{
+    for (Int i = 0; i < m_n; ++i)
+        if (name == m_name[i])
+            return i;
+    SLS_WARN("variable name not found: " + name + ", file : " + fname);
+    return -1;
+}
+
+inline void Matb::write(Str_I varname, Int_I type, const vector<Long> &size,
+    const Uchar *data, Long_I N, Int_I elm_size)
+{
+    Long i, Nbyte = N * elm_size;
+    ofstream &fout = m_out;
+    if (!fout.is_open())
+        SLS_ERR("matb file not open: " + fname);
+    ++m_n; m_ind.push_back(fout.tellp());
+    // write variable name info
+    write_bin((Long)varname.size());
+    fout.write(varname.data(), varname.size());
+    // write data type info
+    write_bin(type);
+    // write dimension info
+    write_bin((Int)size.size());
+    for (i = 0; i < (Long)size.size(); ++i)
+        write_bin(size[i]);
+    // compress chunks in parallel
+    Long chunk = MAX(m_chunk / elm_size, (Long)1) * elm_size;
+    Long Nchunk = (Nbyte + chunk - 1) / chunk;
+    vector<vector<Uchar>> stored(Nchunk);
+    vector<Char> method(Nchunk);
+#pragma omp parallel for schedule(dynamic)
+    for (i = 0; i < Nchunk; ++i) {
+        Long Nraw = MIN(chunk, Nbyte - chunk*i);
+        method[i] = (Char)compress_buf(stored[i], data + chunk*i, Nraw, elm_size, m_comp);
+    }
+    // write chunk table and data
+    write_bin(Nchunk);
+    for (i = 0; i < Nchunk; ++i) {
+        write_bin(MIN(chunk, Nbyte - chunk*i));
+        write_bin((Long)stored[i].size());
+        write_bin(method[i]);
+    }
+    for (i = 0; i < Nchunk; ++i)
+        fout.write((const Char *)stored[i].data(), stored[i].size());
+}
+
+inline void Matb::read(Uchar *data, Int_I ivar, Int_I elm_size)
+{
+    Long i, Nchunk;
+    ifstream &fin = m_in;
+    fin.seekg(m_ind[ivar]);
+    read_bin(Nchunk);
+    if (Nchunk < 0)
+        SLS_ERR("wrong format: " + fname);
+    // read chunk table and data
+    vector<Long> Nraw(Nchunk), Nstored(Nchunk), raw_ind(Nchunk + 1), stored_ind(Nchunk + 1);
+    vector<Char> method(Nchunk);
+    raw_ind[0] = stored_ind[0] = 0;
+    for (i = 0; i < Nchunk; ++i) {
+        read_bin(Nraw[i]); read_bin(Nstored[i]); read_bin(method[i]);
+        raw_ind[i + 1] = raw_ind[i] + Nraw[i];
+        stored_ind[i + 1] = stored_ind[i] + Nstored[i];
+    }
+    Long Nbyte = elm_size;
+    for (i = 0; i < (Long)m_size[ivar].size(); ++i)
+        Nbyte *= m_size[ivar][i];
+    if (is_comp(m_type[ivar]))
+        Nbyte *= 2;
+    if (raw_ind[Nchunk] != Nbyte)
+        SLS_ERR("wrong format: " + fname);
+    vector<Uchar> stored(stored_ind[Nchunk]);
+    fin.read((Char *)stored.data(), stored.size());
+    if (!fin.good())
+        SLS_ERR("file is not complete: " + fname);
+    // decompress chunks in parallel
+    Int ret = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:ret)
+    for (i = 0; i < Nchunk; ++i) {
+        ret += decompress_buf(data + raw_ind[i], Nraw[i], stored.data() + stored_ind[i],
+            Nstored[i], elm_size, method[i]);
+    }
+    if (ret != 0)
+        SLS_ERR("corrupted data: " + fname);
+}
+
+inline Matb::~Matb()
+{
+    if (isopen())
+        close();
+    else if (m_in.is_open() && m_out.is_open())
+        SLS_ERR("unknown!");
+}
+
+// convert data read from file to type T
+template <class T, class T1, SLS_IF(is_promo<T, T1>())>
+inline void matb_cast(T *v, const Uchar *data, Long_I N)
+{
+    T1 s;
+    for (Long i = 0; i < N; ++i) {
+        memcpy(&s, data + i * sizeof(T1), sizeof(T1));
+        v[i] = (T)s;
+    }
+}
+
+template <class T, class T1, SLS_IF(!is_promo<T, T1>())>
+inline void matb_cast(T *v, const Uchar *data, Long_I N)
+{
+    SLS_ERR("wrong type!");
+}
+
+// read the i-th variable of matb to v (N elements), convert type if necessary
+template <class T>
+inline void matb_read(T *v, Long_I N, Int_I i, Matb_IO matb)
+{
+    Int type = matb.m_type[i];
+    if (!is_promo(type_num<T>(), type))
+        SLS_ERR("wrong type!");
+    if (type == type_num<T>()) {
+        matb.read((Uchar *)v, i, sizeof(rm_comp<T>));
+        return;
+    }
+    Long elm_size = 0;
+    if (type == type_num<Char>()) elm_size = sizeof(Char);
+    else if (type == type_num<Int>()) elm_size = sizeof(Int);
+    else if (type == type_num<Llong>()) elm_size = sizeof(Llong);
+    else if (type == type_num<Doub>()) elm_size = sizeof(Doub);
+    else if (type == type_num<Comp>()) elm_size = sizeof(Doub);
+    else {
+        SLS_ERR("unhandled type!"); return;
+    }
+    vector<Uchar> data(N * sizeof(Comp)); // large enough for any stored type
+    matb.read(data.data(), i, elm_size);
+    if (type == type_num<Char>()) matb_cast<T, Char>(v, data.data(), N);
+    else if (type == type_num<Int>()) matb_cast<T, Int>(v, data.data(), N);
+    else if (type == type_num<Llong>()) matb_cast<T, Llong>(v, data.data(), N);
+    else if (type == type_num<Doub>()) matb_cast<T, Doub>(v, data.data(), N);
+    else matb_cast<T, Comp>(v, data.data(), N);
+}
+
+// save() functions
+
+template <class T, SLS_IF(
+    is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>())>
+inline void save(const T &s, Str_I varname, Matb_IO matb)
+{
+    matb.write(varname, type_num<T>(), {}, (const Uchar *)&s,
+        sizeof(T) / sizeof(rm_comp<T>), sizeof(rm_comp<T>));
+}
+
+template <class Tv, class T = contain_type<Tv>, SLS_IF(
+    ndims<Tv>() == 1 &&
+    (is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>()))>
+inline void save(const Tv &v, Str_I varname, Matb_IO matb)
+{
+    Long i, N = v.size();
+    if (is_dense_vec<Tv>() || N == 0) { // contiguous, write directly
+        matb.write(varname, type_num<T>(), { N }, N == 0 ? nullptr : (const Uchar *)v.ptr(),
+            N * sizeof(T) / sizeof(rm_comp<T>), sizeof(rm_comp<T>));
+        return;
+    }
+    vector<T> data(N);
+    for (i = 0; i < N; ++i)
+        data[i] = v[i];
+    matb.write(varname, type_num<T>(), { N }, (const Uchar *)data.data(),
+        N * sizeof(T) / sizeof(rm_comp<T>), sizeof(rm_comp<T>));
+}
+
+template <class Tm, class T = contain_type<Tm>, SLS_IF(
+    (is_Matrix<Tm>() || is_Cmat<Tm>()) &&
+    (is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>())
+)>
+inline void save(const Tm &a, Str_I varname, Matb_IO matb)
+{
+    Long i, j, m = a.n1(), n = a.n2();
+    if (is_cmajor<Tm>() || m * n == 0) { // contiguous, write directly
+        matb.write(varname, type_num<T>(), { m, n }, m * n == 0 ? nullptr : (const Uchar *)a.ptr(),
+            m * n * sizeof(T) / sizeof(rm_comp<T>), sizeof(rm_comp<T>));
+        return;
+    }
+    vector<T> data(m * n);
+    for (j = 0; j < n; ++j)
+        for (i = 0; i < m; ++i)
+            data[i + m*j] = a(i, j);
+    matb.write(varname, type_num<T>(), { m, n }, (const Uchar *)data.data(),
+        m * n * sizeof(T) / sizeof(rm_comp<T>), sizeof(rm_comp<T>));
+}
+
+template <class Tmat, class T = contain_type<Tmat>, SLS_IF(
+    is_dense<Tmat>() && ndims<Tmat>() == 3 &&
+    (is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>()))>
+inline void save(const Tmat &a, Str_I varname, Matb_IO matb)
+{
+    Long i, j, k, m = a.n1(), n = a.n2(), q = a.n3();
+    if (is_cmajor<Tmat>() || m * n * q == 0) { // contiguous, write directly
+        matb.write(varname, type_num<T>(), { m, n, q }, m * n * q == 0 ? nullptr : (const Uchar *)a.ptr(),
+            m * n * q * sizeof(T) / sizeof(rm_comp<T>), sizeof(rm_comp<T>));
+        return;
+    }
+    vector<T> data(m * n * q);
+    for (k = 0; k < q; ++k)
+        for (j = 0; j < n; ++j)
+            for (i = 0; i < m; ++i)
+                data[i + m*j + m*n*k] = a(i, j, k);
+    matb.write(varname, type_num<T>(), { m, n, q }, (const Uchar *)data.data(),
+        m * n * q * sizeof(T) / sizeof(rm_comp<T>), sizeof(rm_comp<T>));
+}
+
+// ===== read matb files =====
+// return 0 if successful, -1 if variable not found
+
+template <class T, SLS_IF(
+    is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>())>
+inline Int load(T &s, Str_I varname, Matb_IO matb)
+{
+    Int i = matb.search(varname);
+    if (i < 0)
+        return -1;
+    if (matb.m_size[i].size() != 0)
+        SLS_ERR("wrong dimension!");
+    matb_read(&s, 1, i, matb);
+    return 0;
+}
+
+template <class T, SLS_IF(
+    is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>())>
+inline Int load(Vector<T> &v, Str_I varname, Matb_IO matb)
+{
+    Int i = matb.search(varname);
+    if (i < 0)
+        return -1;
+    if (matb.m_size[i].size() != 1)
+        SLS_ERR("wrong dimension!");
+    v.resize(matb.m_size[i][0]);
+    if (v.size() > 0)
+        matb_read(v.ptr(), v.size(), i, matb);
+    return 0;
+}
+
+template <class Tm, class T = contain_type<Tm>, SLS_IF(
+    is_dense_mat<Tm>() && (is_Char<T>() || is_Int<T>() || is_Llong<T>() ||
+        is_Doub<T>() || is_Comp<T>()))>
+inline Int load(Tm &a, Str_I varname, Matb_IO matb)
+{
+    Long i, j, m, n;
+    Int ivar = matb.search(varname);
+    if (ivar < 0)
+        return -1;
+    if (matb.m_size[ivar].size() != 2)
+        SLS_ERR("wrong dimension!");
+    m = matb.m_size[ivar][0]; n = matb.m_size[ivar][1]; a.resize(m, n);
+    if (m * n == 0)
+        return 0;
+    if (is_cmajor<Tm>()) {
+        matb_read(a.ptr(), m * n, ivar, matb);
+        return 0;
+    }
+    vector<T> data(m * n);
+    matb_read(data.data(), m * n, ivar, matb);
+    for (j = 0; j < n; ++j)
+        for (i = 0; i < m; ++i)
+            a(i, j) = data[i + m*j];
+    return 0;
+}
+
+template <class Tmat, class T = contain_type<Tmat>, SLS_IF(
+    is_dense<Tmat>() && ndims<Tmat>() == 3 &&
+    (is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>()))>
+inline Int load(Tmat &a, Str_I varname, Matb_IO matb)
+{
+    Long i, j, k, m, n, q;
+    Int ivar = matb.search(varname);
+    if (ivar < 0)
+        return -1;
+    if (matb.m_size[ivar].size() != 3)
+        SLS_ERR("wrong dimension!");
+    m = matb.m_size[ivar][0]; n = matb.m_size[ivar][1]; q = matb.m_size[ivar][2];
+    a.resize(m, n, q);
+    if (m * n * q == 0)
+        return 0;
+    if (is_cmajor<Tmat>()) {
+        matb_read(a.ptr(), m * n * q, ivar, matb);
+        return 0;
+    }
+    vector<T> data(m * n * q);
+    matb_read(data.data(), m * n * q, ivar, matb);
+    for (k = 0; k < q; ++k)
+        for (j = 0; j < n; ++j)
+            for (i = 0; i < m; ++i)
+                a(i, j, k) = data[i + m*j + m*n*k];
+    return 0;
+}
+
+} // namespace slisc
@@ -3,9 +3,10 @@
 #include "sort.h"
 #include "svector.h"
 #include "arithmetic.h"
+#include <unordered_map>
 
 namespace slisc {
-template <class T>
+template <class T, class Tind>
 class MatCoo : public Vbase<T>
 {
 private:
@@ -13,32 +14,48 @@ private:
     using Base::m_p;
     using Base::m_N;
     Long m_Nr, m_Nc, m_Nnz;
-    VecLong m_row, m_col;
+    Vector<Tind> m_row, m_col; // Tind is Int or Long
     T m_zero = (T)0; // TODO: this could be static inline variable for c++17
+    // index for find(): hash table (if use_hash()) or binary search (if sorted())
+    Bool m_sorted = true; // elements are in row major order
+    Bool m_use_hash = false;
+    // m_hash is only modified by non-const members, find() const never rebuilds it
+    Bool m_hash_ok = false; // m_hash is up to date
+    std::unordered_map<Long, Long> m_hash; // m_Nc*i+j -> single index
     MatCoo() {} // default constructor: uninitialized
+    void push_nocheck(const T &s, Long_I i, Long_I j);
+    void grow(Long_I N); // increase capacity to at least N, keep data
+    void build_hash();
+    void update_hash(); // build_hash() if use_hash() and m_hash is out of date
+    void check_shape() const; // Nr, Nc must fit in Tind
 public:
     using Base::ptr;
     MatCoo(Long_I Nr, Long_I Nc);
     MatCoo(Long_I Nr, Long_I Nc, Long_I Ncap); // reserve Ncap elements
     MatCoo(const MatCoo &rhs);        // Copy constructor
-    Long *row_ptr();
-    const Long *row_ptr() const;
-    Long *col_ptr();
-    const Long *col_ptr() const;
+    Tind *row_ptr(); // index will be rebuilt when needed
+    const Tind *row_ptr() const;
+    Tind *col_ptr(); // index will be rebuilt when needed
+    const Tind *col_ptr() const;
     MatCoo & operator=(const MatCoo &rhs);
-    template <class T1, SLS_IF(is_promo<T, T1>())>
-    MatCoo & operator=(const MatCoo<T1> &rhs);    // copy assignment (do resize(rhs))
+    template <class T1, class Tind1, SLS_IF(is_promo<T, T1>())>
+    MatCoo & operator=(const MatCoo<T1, Tind1> &rhs);    // copy assignment (do resize(rhs))
     template <class T1, SLS_IF(is_promo<T, T1>())>
     MatCoo & operator=(const CmatObd<T1> &rhs);
     // inline void operator<<(MatCoo &rhs); // move data and rhs.resize(0, 0); rhs.resize(0)
     void push(const T &s, Long_I i, Long_I j); // add one nonzero element
+    // add N elements (no check for repeated elements, see sum_dup())
+    void push(const T *s, const Tind *i, const Tind *j, Long_I N);
+    void push(const Vector<T> &s, const Vector<Tind> &i, const Vector<Tind> &j);
     void set(const T &s, Long_I i, Long_I j); // change existing element or push new element
+    void add(const T &s, Long_I i, Long_I j); // add to existing element or push new element
     Long n1() const;
     Long n2() const;
     Long size() const; // return m_Nr * m_Nc
     Long nnz() const; // return number of non-zero elements
     Long capacity() const;
     // get single index using double index, return -1 if not found
+    // uses the hash table only if it is up to date (see use_hash())
     Long find(Long_I i, Long_I j) const;
     // reference to an element (element must exist)
     T& ref(Long_I i, Long_I j);
@@ -52,80 +69,138 @@ public:
     void resize(Long_I N); // set m_Nz
     void reserve(Long_I N); // reallocate memory, data will be lost m_Nz = 0
     void reshape(Long_I Nr, Long_I Nc); // change matrix shape
-    template <class T1>
-    void reserve(const MatCoo<T1> &a);
-    template <class T1>
-    void reshape(const MatCoo<T1> &a);
-    void sort_r(); // sort to row major
+    template <class T1, class Tind1>
+    void reserve(const MatCoo<T1, Tind1> &a);
+    template <class T1, class Tind1>
+    void reshape(const MatCoo<T1, Tind1> &a);
+    void sort_r(); // sort to row major (stable radix sort)
+    void sum_dup(); // sort_r() if needed, then sum repeated elements
+    Bool sorted() const; // elements are known to be in row major order
+    Bool update_sorted(); // check sorted() again after using row_ptr() or col_ptr()
+    // use a hash table for find(), set() and add(), for assembling in random order
+    // the table is (re)built by non-const members only, so const find() is thread-safe
+    // otherwise find() uses binary search if sorted(), or linear search
+    void use_hash(Bool_I on = true);
 };
 
-template <class T>
-MatCoo<T>::MatCoo(Long_I Nr, Long_I Nc)
+template <class T, class Tind>
+MatCoo<T, Tind>::MatCoo(Long_I Nr, Long_I Nc)
     : m_Nr(Nr), m_Nc(Nc), m_Nnz(0), m_row(0), m_col(0)
 {
     m_N = 0;
+    check_shape();
+}
+
+template <class T, class Tind>
+MatCoo<T, Tind>::MatCoo(Long_I Nr, Long_I Nc, Long_I Ncap) :
+    Base(Ncap), m_Nr(Nr), m_Nc(Nc), m_Nnz(0), m_row(Ncap), m_col(Ncap)
+{
+    check_shape();
 }
 
-template <class T>
-MatCoo<T>::MatCoo(Long_I Nr, Long_I Nc, Long_I Ncap) :
-    Base(Ncap), m_Nr(Nr), m_Nc(Nc), m_Nnz(0), m_row(Ncap), m_col(Ncap) {}
+template <class T, class Tind>
+void MatCoo<T, Tind>::check_shape() const
+{
+#ifdef SLS_CHECK_SHAPE
+    if (MAX(m_Nr, m_Nc) - 1 > Long(std::numeric_limits<Tind>::max()))
+        SLS_ERR("MatCoo: matrix too large for the index type!");
+#endif
+}
 
-template <class T>
-MatCoo<T>::MatCoo(const MatCoo<T> &rhs)
+template <class T, class Tind>
+MatCoo<T, Tind>::MatCoo(const MatCoo<T, Tind> &rhs)
 {
     SLS_ERR("Copy constructor or move constructor is forbidden, use reference "
          "argument for function input or output, and use \"=\" to copy!");
 }
 
-template<class T>
-Long * MatCoo<T>::row_ptr()
+template <class T, class Tind>
+Tind * MatCoo<T, Tind>::row_ptr()
 {
+    m_sorted = false; m_hash_ok = false;
     return m_row.ptr();
 }
 
-template <class T>
-const Long *MatCoo<T>::row_ptr() const
+template <class T, class Tind>
+const Tind *MatCoo<T, Tind>::row_ptr() const
 {
     return m_row.ptr();
 }
 
-template<class T>
-Long * MatCoo<T>::col_ptr()
+template <class T, class Tind>
+Tind * MatCoo<T, Tind>::col_ptr()
 {
+    m_sorted = false; m_hash_ok = false;
     return m_col.ptr();
 }
 
-template <class T>
-const Long *MatCoo<T>::col_ptr() const
+template <class T, class Tind>
+const Tind *MatCoo<T, Tind>::col_ptr() const
 {
     return m_col.ptr();
 }
 
-template <class T>
-MatCoo<T> & MatCoo<T>::operator=(const MatCoo<T> &rhs)
+template <class T, class Tind>
+MatCoo<T, Tind> & MatCoo<T, Tind>::operator=(const MatCoo<T, Tind> &rhs)
 {
     return operator=<T>(rhs);
 }
 
-template<class T>
+template <class T, class Tind>
 template<class T1, SLS_IF0(is_promo<T, T1>())>
-MatCoo<T> & MatCoo<T>::operator=(const CmatObd<T1>& rhs)
+MatCoo<T, Tind> & MatCoo<T, Tind>::operator=(const CmatObd<T1>& rhs)
 {
     copy(*this, rhs);
     return *this;
 }
 
-template <class T>
-template <class T1, SLS_IF0(is_promo<T, T1>())>
-MatCoo<T> & MatCoo<T>::operator=(const MatCoo<T1> &rhs)
+template <class T, class Tind>
+template <class T1, class Tind1, SLS_IF0(is_promo<T, T1>())>
+MatCoo<T, Tind> & MatCoo<T, Tind>::operator=(const MatCoo<T1, Tind1> &rhs)
 {
     copy(*this, rhs);
     return *this;
 }
 
-template <class T>
-Long MatCoo<T>::find(Long_I i, Long_I j) const
+template <class T, class Tind>
+void MatCoo<T, Tind>::build_hash()
 {
+    m_hash.clear();
+    m_hash.reserve(m_Nnz);
+    // keep the first one of repeated elements, same as linear search
+    for (Long n = 0; n < m_Nnz; ++n)
+        m_hash.emplace(m_Nc * m_row[n] + m_col[n], n);
+    m_hash_ok = true;
+}
+
+template <class T, class Tind>
+void MatCoo<T, Tind>::update_hash()
+{
+    if (m_use_hash && !m_hash_ok)
+        build_hash();
+}
+
+template <class T, class Tind>
+Long MatCoo<T, Tind>::find(Long_I i, Long_I j) const
+{
+    if (m_use_hash && m_hash_ok) {
+        auto it = m_hash.find(m_Nc * i + j);
+        return it == m_hash.end() ? -1 : it->second;
+    }
+    if (m_sorted) {
+        // binary search for the first element not less than (i,j)
+        Long n1 = 0, n2 = m_Nnz, n;
+        while (n1 < n2) {
+            n = (n1 + n2) / 2;
+            if (m_row[n] < i || (m_row[n] == i && m_col[n] < j))
+                n1 = n + 1;
+            else
+                n2 = n;
+        }
+        if (n1 < m_Nnz && m_row[n1] == i && m_col[n1] == j)
+            return n1;
+        return -1;
+    }
     for (Long n = 0; n < m_Nnz; ++n) {
         if (row(n) == i && col(n) == j)
             return n;
@@ -133,21 +208,22 @@ Long MatCoo<T>::find(Long_I i, Long_I j) const
     return -1;
 }
 
-template <class T>
-T& MatCoo<T>::ref(Long_I i, Long_I j)
+template <class T, class Tind>
+T& MatCoo<T, Tind>::ref(Long_I i, Long_I j)
 {
 #ifdef SLS_CHECK_BOUNDS
     if (i < 0 || i >= m_Nr || j < 0 || j >= m_Nc)
         SLS_ERR("MatCoo::operator()(i,j): index out of bounds!");
 #endif
+    update_hash();
     Long n = find(i, j);
     if (n < 0)
         SLS_ERR("MatCoo::operator()(i,j): element does not exist!");
     return m_p[n];
 }
 
-template <class T>
-const T &MatCoo<T>::operator()(Long_I i, Long_I j) const
+template <class T, class Tind>
+const T &MatCoo<T, Tind>::operator()(Long_I i, Long_I j) const
 {
 #ifdef SLS_CHECK_BOUNDS
     if (i < 0 || i >= m_Nr || j < 0 || j >= m_Nc)
@@ -159,73 +235,139 @@ const T &MatCoo<T>::operator()(Long_I i, Long_I j) const
     return m_p[n];
 }
 
-template <class T>
-void MatCoo<T>::push(const T &s, Long_I i, Long_I j)
+template <class T, class Tind>
+void MatCoo<T, Tind>::push(const T &s, Long_I i, Long_I j)
 {
 #ifdef SLS_CHECK_BOUNDS
     if (i<0 || i>=m_Nr || j<0 || j>=m_Nc)
         SLS_ERR("MatCoo::push(): index out of bounds!");
 #endif
 #ifdef SLS_CHECK_COO_REPEAT
-    Long n;
-    for (n = 0; n < m_Nnz; ++n) {
-        if (row(n) == i && col(n) == j)
-            SLS_ERR("MatCoo::push(s,i,j): element already exists!");
-    }
+    update_hash();
+    if (find(i, j) >= 0)
+        SLS_ERR("MatCoo::push(s,i,j): element already exists!");
 #endif
-    if (m_Nnz == m_N) SLS_ERR("MatCoo::add(): out of memory, please reserve!");
-    m_p[m_Nnz] = s; m_row[m_Nnz] = i; m_col[m_Nnz] = j;
-    ++m_Nnz;
+    push_nocheck(s, i, j);
 }
 
-template <class T>
-void MatCoo<T>::set(const T &s, Long_I i, Long_I j)
+template <class T, class Tind>
+void MatCoo<T, Tind>::grow(Long_I N)
 {
-    Long n;
-    // change
-    for (n = 0; n < m_Nnz; ++n) {
-        if (row(n) == i && col(n) == j) {
-            m_p[n] = s; m_row[n] = i; m_col[n] = j; return;
-        }
+    if (N <= m_N) return;
+    Long Ncap = MAX(MAX(N, 2*m_N), Long(16));
+    Base::resize_cpy(Ncap);
+    m_row.resize_cpy(Ncap);
+    m_col.resize_cpy(Ncap);
+}
+
+template <class T, class Tind>
+void MatCoo<T, Tind>::push_nocheck(const T &s, Long_I i, Long_I j)
+{
+    if (m_Nnz == m_N) grow(m_Nnz + 1);
+    if (m_sorted && m_Nnz > 0) {
+        Long i0 = m_row[m_Nnz-1];
+        if (i < i0 || (i == i0 && j < m_col[m_Nnz-1]))
+            m_sorted = false;
     }
-    // push
-    if (m_Nnz == m_N) SLS_ERR("MatCoo::add(): out of memory, please reserve!");
-    m_p[m_Nnz] = s; m_row[m_Nnz] = i; m_col[m_Nnz] = j;
+    if (m_hash_ok)
+        m_hash.emplace(m_Nc * i + j, m_Nnz);
+    m_p[m_Nnz] = s; m_row[m_Nnz] = Tind(i); m_col[m_Nnz] = Tind(j);
     ++m_Nnz;
 }
 
-template <class T>
-Long MatCoo<T>::n1() const
+template <class T, class Tind>
+void MatCoo<T, Tind>::push(const T *s, const Tind *i, const Tind *j, Long_I N)
+{
+    if (N <= 0) return;
+#ifdef SLS_CHECK_BOUNDS
+    for (Long n = 0; n < N; ++n)
+        if (i[n] < 0 || i[n] >= m_Nr || j[n] < 0 || j[n] >= m_Nc)
+            SLS_ERR("MatCoo::push(): index out of bounds!");
+#endif
+    grow(m_Nnz + N);
+    if (m_sorted) {
+        Long n0 = 0;
+        if (m_Nnz > 0 && (i[0] < m_row[m_Nnz-1] ||
+            (i[0] == m_row[m_Nnz-1] && j[0] < m_col[m_Nnz-1])))
+            m_sorted = false;
+        for (Long n = 1; n < N && m_sorted; ++n, ++n0)
+            if (i[n] < i[n0] || (i[n] == i[n0] && j[n] < j[n0]))
+                m_sorted = false;
+    }
+    veccpy(m_p + m_Nnz, s, N);
+    veccpy(m_row.ptr() + m_Nnz, i, N);
+    veccpy(m_col.ptr() + m_Nnz, j, N);
+    if (m_hash_ok)
+        for (Long n = 0; n < N; ++n)
+            m_hash.emplace(m_Nc * i[n] + j[n], m_Nnz + n);
+    m_Nnz += N;
+    update_hash();
+}
+
+template <class T, class Tind>
+void MatCoo<T, Tind>::push(const Vector<T> &s, const Vector<Tind> &i, const Vector<Tind> &j)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (i.size() != s.size() || j.size() != s.size())
+        SLS_ERR("wrong shape!");
+#endif
+    push(s.ptr(), i.ptr(), j.ptr(), s.size());
+}
+
+template <class T, class Tind>
+void MatCoo<T, Tind>::set(const T &s, Long_I i, Long_I j)
+{
+    update_hash();
+    Long n = find(i, j);
+    if (n >= 0)
+        m_p[n] = s;
+    else
+        push_nocheck(s, i, j);
+}
+
+template <class T, class Tind>
+void MatCoo<T, Tind>::add(const T &s, Long_I i, Long_I j)
+{
+    update_hash();
+    Long n = find(i, j);
+    if (n >= 0)
+        m_p[n] += s;
+    else
+        push_nocheck(s, i, j);
+}
+
+template <class T, class Tind>
+Long MatCoo<T, Tind>::n1() const
 {
     return m_Nr;
 }
 
-template <class T>
-Long MatCoo<T>::n2() const
+template <class T, class Tind>
+Long MatCoo<T, Tind>::n2() const
 {
     return m_Nc;
 }
 
-template <class T>
-Long MatCoo<T>::size() const
+template <class T, class Tind>
+Long MatCoo<T, Tind>::size() const
 {
     return m_Nr * m_Nc;
 }
 
-template <class T>
-Long MatCoo<T>::nnz() const
+template <class T, class Tind>
+Long MatCoo<T, Tind>::nnz() const
 {
     return m_Nnz;
 }
 
-template <class T>
-Long MatCoo<T>::capacity() const
+template <class T, class Tind>
+Long MatCoo<T, Tind>::capacity() const
 {
     return Base::size();
 }
 
-template <class T>
-T & MatCoo<T>::operator()(Long_I ind)
+template <class T, class Tind>
+T & MatCoo<T, Tind>::operator()(Long_I ind)
 {
 #ifdef SLS_CHECK_BOUNDS
     if (ind<0 || ind>=m_Nnz)
@@ -234,8 +376,8 @@ T & MatCoo<T>::operator()(Long_I ind)
     return m_p[ind];
 }
 
-template <class T>
-const T & MatCoo<T>::operator()(Long_I ind) const
+template <class T, class Tind>
+const T & MatCoo<T, Tind>::operator()(Long_I ind) const
 {
 #ifdef SLS_CHECK_BOUNDS
     if (ind<0 || ind>=m_Nnz)
@@ -244,8 +386,8 @@ const T & MatCoo<T>::operator()(Long_I ind) const
     return m_p[ind];
 }
 
-template <class T>
-Long MatCoo<T>::row(Long_I ind) const
+template <class T, class Tind>
+Long MatCoo<T, Tind>::row(Long_I ind) const
 {
 #ifdef SLS_CHECK_BOUNDS
     if (ind<0 || ind>=m_Nnz)
@@ -254,8 +396,8 @@ Long MatCoo<T>::row(Long_I ind) const
     return m_row[ind];
 }
 
-template <class T>
-Long MatCoo<T>::col(Long_I ind) const
+template <class T, class Tind>
+Long MatCoo<T, Tind>::col(Long_I ind) const
 {
 #ifdef SLS_CHECK_BOUNDS
     if (ind < 0 || ind >= m_Nnz)
@@ -264,71 +406,127 @@ Long MatCoo<T>::col(Long_I ind) const
     return m_col[ind];
 }
 
-template <class T>
-void MatCoo<T>::trim(Long_I Nnz)
+template <class T, class Tind>
+void MatCoo<T, Tind>::trim(Long_I Nnz)
 {
 #ifdef SLS_CHECK_SHAPE
     if (Nnz < 0)
         SLS_ERR("MatCoo::trim() negative input!");
 #endif
-    if (Nnz < m_Nnz) m_Nnz = Nnz;
+    if (Nnz < m_Nnz) {
+        m_Nnz = Nnz; m_hash_ok = false;
+    }
     else if (Nnz > m_Nnz) SLS_ERR("MatCoo::trim(): Nnz > m_Nnz!");
 }
 
-template <class T>
-void MatCoo<T>::resize(Long_I N)
+template <class T, class Tind>
+void MatCoo<T, Tind>::resize(Long_I N)
 {
 #ifdef SLS_CHECK_BOUNDS
     if (N > m_N)
         SLS_ERR("not enough capacity!");
 #endif
-    m_Nnz = N;
+    if (N > m_Nnz)
+        m_sorted = false;
+    m_Nnz = N; m_hash_ok = false;
 }
 
-template <class T>
-void MatCoo<T>::reserve(Long_I N)
+template <class T, class Tind>
+void MatCoo<T, Tind>::reserve(Long_I N)
 {
     Base::resize(N);
     m_row.resize(N);
     m_col.resize(N);
     m_Nnz = 0;
+    m_sorted = true; m_hash_ok = false;
 }
 
-template <class T>
-void MatCoo<T>::reshape(Long_I Nr, Long_I Nc)
+template <class T, class Tind>
+void MatCoo<T, Tind>::reshape(Long_I Nr, Long_I Nc)
 {
     m_Nr = Nr; m_Nc = Nc;
+    check_shape();
+    m_hash_ok = false;
+}
+
+// sort the single index m_Nc*i+j together with the elements, then recover (i,j)
+template <class T, class Tind>
+inline void MatCoo<T, Tind>::sort_r()
+{
+    if (m_Nnz > 1) {
+        VecLong inds(m_Nnz);
+        Tind *row = m_row.ptr(), *col = m_col.ptr();
+#pragma omp parallel for
+        for (Long i = 0; i < m_Nnz; ++i)
+            inds[i] = m_Nc * row[i] + col[i];
+        sort2_radix_vv_par(inds.ptr(), m_p, m_Nnz, m_Nr * m_Nc - 1);
+#pragma omp parallel for
+        for (Long i = 0; i < m_Nnz; ++i) {
+            row[i] = Tind(inds[i] / m_Nc); col[i] = Tind(inds[i] % m_Nc);
+        }
+    }
+    m_sorted = true; m_hash_ok = false;
+    update_hash();
+}
+
+template <class T, class Tind>
+inline void MatCoo<T, Tind>::sum_dup()
+{
+    if (!m_sorted)
+        sort_r();
+    if (m_Nnz < 2) return;
+    Long k = 0;
+    for (Long n = 1; n < m_Nnz; ++n) {
+        if (m_row[n] == m_row[k] && m_col[n] == m_col[k])
+            m_p[k] += m_p[n];
+        else {
+            ++k;
+            m_p[k] = m_p[n]; m_row[k] = m_row[n]; m_col[k] = m_col[n];
+        }
+    }
+    m_Nnz = k + 1; m_hash_ok = false;
+    update_hash();
+}
+
+template <class T, class Tind>
+Bool MatCoo<T, Tind>::sorted() const
+{
+    return m_sorted;
+}
+
+template <class T, class Tind>
+Bool MatCoo<T, Tind>::update_sorted()
+{
+    m_sorted = true;
+    for (Long n = 1; n < m_Nnz; ++n) {
+        if (m_row[n] < m_row[n-1] || (m_row[n] == m_row[n-1] && m_col[n] < m_col[n-1])) {
+            m_sorted = false; break;
+        }
+    }
+    return m_sorted;
 }
 
-template<class T>
-inline void MatCoo<T>::sort_r()
+template <class T, class Tind>
+void MatCoo<T, Tind>::use_hash(Bool_I on)
 {
-    VecLong inds(m_Nnz), order(m_Nnz);
-    linspace(order, 0, m_Nnz - 1);
-    for (Long i = 0; i < m_Nnz; ++i) {
-        inds[i] = m_Nc * m_row[i] + m_col[i];
+    m_use_hash = on;
+    if (!on) {
+        m_hash.clear(); m_hash_ok = false;
     }
-    sort2(inds, order);
-    Svector<T> sli(m_p, m_Nnz);
-    reorder(sli, order);
-    Svector<Long> sli1;
-    sli1.set_size(m_Nnz);
-    sli1.set_ptr(m_row.ptr());
-    reorder(sli1, order);
-    sli1.set_ptr(m_col.ptr());
-    reorder(sli1, order);
+    else
+        update_hash();
 }
 
-template <class T>
-template <class T1>
-void MatCoo<T>::reshape(const MatCoo<T1> &a)
+template <class T, class Tind>
+template <class T1, class Tind1>
+void MatCoo<T, Tind>::reshape(const MatCoo<T1, Tind1> &a)
 {
     reshape(a.n1(), a.n2());
 }
 
-template <class T>
-template <class T1>
-void MatCoo<T>::reserve(const MatCoo<T1> &a)
+template <class T, class Tind>
+template <class T1, class Tind1>
+void MatCoo<T, Tind>::reserve(const MatCoo<T1, Tind1> &a)
 {
     reserve(a.capacity());
 }
@@ -12,11 +12,11 @@ namespace slisc {
 // sparse Hermitian / symmetric
 // only stores the upper triangle
 // nnz() is the actual # of non-zero elem. stored
-template <class T>
-class MatCooH : public MatCoo<T>
+template <class T, class Tind>
+class MatCooH : public MatCoo<T, Tind>
 {
 private:
-    typedef MatCoo<T> Base;
+    typedef MatCoo<T, Tind> Base;
     MatCooH() : Base() {} // default constructor : uninitialized
 public:
     MatCooH(Long_I Nr, Long_I Nc);
@@ -26,23 +26,24 @@ public:
     const T operator()(Long_I i, Long_I j) const; // double indexing (element need not exist)
     void push(const T &s, Long_I i, Long_I j); // add one nonzero element
     void set(const T &s, Long_I i, Long_I j); // change existing element or push new element
+    void add(const T &s, Long_I i, Long_I j); // add to existing element or push new element
     void reshape(Long_I Nr, Long_I Nc); // change matrix shape
-    template <class T1>
-    void reshape(const MatCoo<T1> &a);
-    template <class T1>
-    MatCooH &operator=(const MatCooH<T1> &rhs);
+    template <class T1, class Tind1>
+    void reshape(const MatCoo<T1, Tind1> &a);
+    template <class T1, class Tind1>
+    MatCooH &operator=(const MatCooH<T1, Tind1> &rhs);
 };
 
-template <class T>
-MatCooH<T>::MatCooH(Long_I Nr, Long_I Nc) : Base(Nr, Nc)
+template <class T, class Tind>
+MatCooH<T, Tind>::MatCooH(Long_I Nr, Long_I Nc) : Base(Nr, Nc)
 {
 #ifdef SLS_CHECK_SHAPE
     if (Nr != Nc) SLS_ERR("must be square matrix!");
 #endif
 }
 
-template <class T>
-MatCooH<T>::MatCooH(Long_I Nr, Long_I Nc, Long_I Nnz) : Base(Nr, Nc, Nnz)
+template <class T, class Tind>
+MatCooH<T, Tind>::MatCooH(Long_I Nr, Long_I Nc, Long_I Nnz) : Base(Nr, Nc, Nnz)
 {
 #ifdef SLS_CHECK_SHAPE
     if (Nr != Nc) SLS_ERR("must be square matrix!");
@@ -50,8 +51,8 @@ MatCooH<T>::MatCooH(Long_I Nr, Long_I Nc, Long_I Nnz) : Base(Nr, Nc, Nnz)
 }
 
 // cannot return a const reference since conj() might create a temporary
-template <class T>
-const T MatCooH<T>::operator()(Long_I i, Long_I j) const
+template <class T, class Tind>
+const T MatCooH<T, Tind>::operator()(Long_I i, Long_I j) const
 {
     if (i > j) {
         return CONJ(Base::operator()(j, i));
@@ -59,8 +60,8 @@ const T MatCooH<T>::operator()(Long_I i, Long_I j) const
     return Base::operator()(i, j);
 }
 
-template <class T>
-T &MatCooH<T>::ref(Long_I i, Long_I j)
+template <class T, class Tind>
+T &MatCooH<T, Tind>::ref(Long_I i, Long_I j)
 {
     if (i > j) {
         SLS_ERR("lower triangle is empty!");
@@ -70,8 +71,8 @@ T &MatCooH<T>::ref(Long_I i, Long_I j)
         return Base::ref(i, j);
 }
 
-template <class T>
-void MatCooH<T>::push(const T &s, Long_I i, Long_I j)
+template <class T, class Tind>
+void MatCooH<T, Tind>::push(const T &s, Long_I i, Long_I j)
 {
     if (i > j)
         Base::push(CONJ(s), j, i);
@@ -79,8 +80,8 @@ void MatCooH<T>::push(const T &s, Long_I i, Long_I j)
         Base::push(s, i, j);
 }
 
-template <class T>
-void MatCooH<T>::set(const T &s, Long_I i, Long_I j)
+template <class T, class Tind>
+void MatCooH<T, Tind>::set(const T &s, Long_I i, Long_I j)
 {
     if (i > j)
         Base::set(s, j, i);
@@ -88,8 +89,17 @@ void MatCooH<T>::set(const T &s, Long_I i, Long_I j)
         Base::set(s, i, j);
 }
 
-template <class T>
-void MatCooH<T>::reshape(Long_I Nr, Long_I Nc)
+template <class T, class Tind>
+void MatCooH<T, Tind>::add(const T &s, Long_I i, Long_I j)
+{
+    if (i > j)
+        Base::add(CONJ(s), j, i);
+    else
+        Base::add(s, i, j);
+}
+
+template <class T, class Tind>
+void MatCooH<T, Tind>::reshape(Long_I Nr, Long_I Nc)
 {
 #ifdef SLS_CHECK_SHAPE
     if (Nr != Nc) SLS_ERR("must be a square matrix!");
@@ -97,8 +107,8 @@ void MatCooH<T>::reshape(Long_I Nr, Long_I Nc)
     Base::reshape(Nr, Nc);
 }
 
-template <class T> template <class T1>
-void MatCooH<T>::reshape(const MatCoo<T1> &a)
+template <class T, class Tind> template <class T1, class Tind1>
+void MatCooH<T, Tind>::reshape(const MatCoo<T1, Tind1> &a)
 {
 #ifdef SLS_CHECK_SHAPE
     if (a.n1() != a.n2())
@@ -107,10 +117,11 @@ void MatCooH<T>::reshape(const MatCoo<T1> &a)
     reshape(a.n1());
 }
 
-template <class T> template <class T1>
-MatCooH<T> &MatCooH<T>::operator=(const MatCooH<T1> &rhs)
+template <class T, class Tind> template <class T1, class Tind1>
+MatCooH<T, Tind> &MatCooH<T, Tind>::operator=(const MatCooH<T1, Tind1> &rhs)
 {
-    Base(*this) = Base(rhs);
+    Base::operator=(rhs);
+    return *this;
 }
 
 } // namespace slisc
@@ -0,0 +1,226 @@
+// CSR (compressed sparse row) matrix
+// converted from a row major sorted MatCoo, see MatCoo::sort_r(), MatCoo::sum_dup()
+#pragma once
+#include "matcoo.h"
+
+namespace slisc {
+template <class T, class Tind>
+class MatCsr : public Vbase<T>
+{
+private:
+    typedef Vbase<T> Base;
+    using Base::m_p;
+    using Base::m_N;
+    Long m_Nr, m_Nc;
+    VecLong m_row; // m_row[i] is the index of the first element of row i, m_row[m_Nr] = nnz
+    Vector<Tind> m_col; // column index of each element, Tind is Int or Long
+    T m_zero = (T)0;
+    MatCsr() {} // default constructor: uninitialized
+public:
+    using Base::ptr;
+    MatCsr(Long_I Nr, Long_I Nc); // empty matrix
+    MatCsr(Long_I Nr, Long_I Nc, Long_I Nnz); // uninitialized row_ptr() and col_ptr()
+    MatCsr(const MatCsr &rhs); // Copy constructor
+    Long *row_ptr();
+    const Long *row_ptr() const;
+    Tind *col_ptr();
+    const Tind *col_ptr() const;
+    MatCsr &operator=(const MatCsr &rhs);
+    template <class T1, class Tind1, SLS_IF(is_promo<T, T1>())>
+    MatCsr &operator=(const MatCoo<T1, Tind1> &rhs); // rhs must be sorted
+    Long n1() const;
+    Long n2() const;
+    Long size() const; // return m_Nr * m_Nc
+    Long nnz() const;
+    T &operator()(Long_I ind); // return element
+    const T &operator()(Long_I ind) const;
+    Long col(Long_I ind) const; // column index
+    // get single index using double index, return -1 if not found
+    Long find(Long_I i, Long_I j) const;
+    // double indexing (element need not exist)
+    const T &operator()(Long_I i, Long_I j) const;
+    void resize(Long_I Nr, Long_I Nc, Long_I Nnz); // data will be lost
+};
+
+template <class T, class Tind>
+MatCsr<T, Tind>::MatCsr(Long_I Nr, Long_I Nc)
+    : m_Nr(Nr), m_Nc(Nc), m_row(Nr + 1, Long(0)), m_col(0)
+{
+    m_N = 0;
+}
+
+template <class T, class Tind>
+MatCsr<T, Tind>::MatCsr(Long_I Nr, Long_I Nc, Long_I Nnz)
+    : Base(Nnz), m_Nr(Nr), m_Nc(Nc), m_row(Nr + 1), m_col(Nnz) {}
+
+template <class T, class Tind>
+MatCsr<T, Tind>::MatCsr(const MatCsr<T, Tind> &rhs)
+{
+    SLS_ERR("Copy constructor or move constructor is forbidden, use reference "
+         "argument for function input or output, and use \"=\" to copy!");
+}
+
+template <class T, class Tind>
+Long *MatCsr<T, Tind>::row_ptr()
+{
+    return m_row.ptr();
+}
+
+template <class T, class Tind>
+const Long *MatCsr<T, Tind>::row_ptr() const
+{
+    return m_row.ptr();
+}
+
+template <class T, class Tind>
+Tind *MatCsr<T, Tind>::col_ptr()
+{
+    return m_col.ptr();
+}
+
+template <class T, class Tind>
+const Tind *MatCsr<T, Tind>::col_ptr() const
+{
+    return m_col.ptr();
+}
+
+template <class T, class Tind>
+MatCsr<T, Tind> &MatCsr<T, Tind>::operator=(const MatCsr<T, Tind> &rhs)
+{
+    if (this == &rhs) return *this;
+    resize(rhs.n1(), rhs.n2(), rhs.nnz());
+    veccpy(m_p, rhs.ptr(), m_N);
+    veccpy(m_row.ptr(), rhs.row_ptr(), m_Nr + 1);
+    veccpy(m_col.ptr(), rhs.col_ptr(), m_N);
+    return *this;
+}
+
+template <class T, class Tind>
+template <class T1, class Tind1, SLS_IF0(is_promo<T, T1>())>
+MatCsr<T, Tind> &MatCsr<T, Tind>::operator=(const MatCoo<T1, Tind1> &rhs)
+{
+    coo2csr(*this, rhs);
+    return *this;
+}
+
+template <class T, class Tind>
+Long MatCsr<T, Tind>::n1() const
+{
+    return m_Nr;
+}
+
+template <class T, class Tind>
+Long MatCsr<T, Tind>::n2() const
+{
+    return m_Nc;
+}
+
+template <class T, class Tind>
+Long MatCsr<T, Tind>::size() const
+{
+    return m_Nr * m_Nc;
+}
+
+template <class T, class Tind>
+Long MatCsr<T, Tind>::nnz() const
+{
+    return m_N;
+}
+
+template <class T, class Tind>
+T &MatCsr<T, Tind>::operator()(Long_I ind)
+{
+#ifdef SLS_CHECK_BOUNDS
+    if (ind < 0 || ind >= m_N)
+        SLS_ERR("MatCsr::operator(): subscript out of bounds!");
+#endif
+    return m_p[ind];
+}
+
+template <class T, class Tind>
+const T &MatCsr<T, Tind>::operator()(Long_I ind) const
+{
+#ifdef SLS_CHECK_BOUNDS
+    if (ind < 0 || ind >= m_N)
+        SLS_ERR("MatCsr::operator(): subscript out of bounds!");
+#endif
+    return m_p[ind];
+}
+
+template <class T, class Tind>
+Long MatCsr<T, Tind>::col(Long_I ind) const
+{
+#ifdef SLS_CHECK_BOUNDS
+    if (ind < 0 || ind >= m_N)
+        SLS_ERR("MatCsr::col(): subscript out of bounds!");
+#endif
+    return m_col[ind];
+}
+
+template <class T, class Tind>
+Long MatCsr<T, Tind>::find(Long_I i, Long_I j) const
+{
+#ifdef SLS_CHECK_BOUNDS
+    if (i < 0 || i >= m_Nr || j < 0 || j >= m_Nc)
+        SLS_ERR("MatCsr::find(i,j): index out of bounds!");
+#endif
+    // binary search in row i
+    Long n1 = m_row[i], n2 = m_row[i + 1], n;
+    while (n1 < n2) {
+        n = (n1 + n2) / 2;
+        if (m_col[n] < j)
+            n1 = n + 1;
+        else
+            n2 = n;
+    }
+    if (n1 < m_row[i + 1] && m_col[n1] == j)
+        return n1;
+    return -1;
+}
+
+template <class T, class Tind>
+const T &MatCsr<T, Tind>::operator()(Long_I i, Long_I j) const
+{
+    Long n = find(i, j);
+    if (n < 0)
+        return m_zero;
+    return m_p[n];
+}
+
+template <class T, class Tind>
+void MatCsr<T, Tind>::resize(Long_I Nr, Long_I Nc, Long_I Nnz)
+{
+    m_Nr = Nr; m_Nc = Nc;
+    Base::resize(Nnz);
+    m_row.resize(Nr + 1);
+    m_col.resize(Nnz);
+}
+
+// convert row major sorted MatCoo to MatCsr
+// repeated elements are kept, use a.sum_dup() first to remove them
+template <class T, class Tind, class T1, class Tind1, SLS_IF(is_promo<T, T1>())>
+void coo2csr(MatCsr<T, Tind> &b, const MatCoo<T1, Tind1> &a)
+{
+    if (!a.sorted())
+        SLS_ERR("MatCoo must be sorted, use sort_r() or sum_dup()!");
+    Long Nr = a.n1(), Nnz = a.nnz();
+    b.resize(Nr, a.n2(), Nnz);
+    const Tind1 *row = a.row_ptr(), *col = a.col_ptr();
+    const T1 *pa = a.ptr();
+    Long *b_row = b.row_ptr();
+    Tind *b_col = b.col_ptr();
+    T *pb = b.ptr();
+#pragma omp parallel for
+    for (Long k = 0; k < Nnz; ++k) {
+        pb[k] = pa[k]; b_col[k] = Tind(col[k]);
+    }
+    // row i starts at the first element with row >= i
+    Long k = 0;
+    for (Long i = 0; i <= Nr; ++i) {
+        while (k < Nnz && row[k] < i)
+            ++k;
+        b_row[i] = k;
+    }
+}
+
+} // namespace slisc
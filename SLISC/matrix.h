@@ -6,11 +6,11 @@ namespace slisc {
 // Matrix Class
 
 // convert MatCoo to dense matrix
-template <class T, class T1, SLS_IF(
+template <class T, class T1, class Tind, SLS_IF(
     is_dense<T>() && is_scalar<T1>() &&
     is_promo<contain_type<T>, T1>()
 )>
-inline T &coo2dense(T &lhs, const MatCoo<T1> &rhs)
+inline T &coo2dense(T &lhs, const MatCoo<T1, Tind> &rhs)
 {
 #ifdef SLS_CHECK_SHAPE
     if (!shape_cmp(lhs, rhs))
@@ -24,11 +24,11 @@ inline T &coo2dense(T &lhs, const MatCoo<T1> &rhs)
 }
 
 // convert MatCooH to dense matrix
-template <class T, class T1, SLS_IF(
+template <class T, class T1, class Tind, SLS_IF(
     is_dense<T>() && is_scalar<T1>() &&
     is_promo<contain_type<T>, T1>()
 )>
-inline T &cooh2dense(T &lhs, const MatCooH<T1> &rhs)
+inline T &cooh2dense(T &lhs, const MatCooH<T1, Tind> &rhs)
 {
     lhs.resize(rhs.n1(), rhs.n2());
     lhs = contain_type<T>(0);
@@ -64,10 +64,10 @@ public:
     Matrix & operator=(const Matrix &rhs);
     template <class Tmat, SLS_IF(is_dense_mat<Tmat>())>
     Matrix & operator=(const Tmat &rhs);    // copy assignment
-    template <class T1>
-    Matrix & operator=(const MatCoo<T1> &rhs);
-    template <class T1>
-    Matrix & operator=(const MatCooH<T1> &rhs);
+    template <class T1, class Tind>
+    Matrix & operator=(const MatCoo<T1, Tind> &rhs);
+    template <class T1, class Tind>
+    Matrix & operator=(const MatCooH<T1, Tind> &rhs);
 #ifdef _CUSLISC_
     Matrix & operator=(const Gmatrix<T> &rhs) // copy from GPU vector
     { rhs.get(*this); return *this; }
@@ -116,14 +116,14 @@ inline Matrix<T> & Matrix<T>::operator=(const Tmat &rhs)
     return *this;
 }
 
-template <class T> template <class T1>
-inline Matrix<T> & Matrix<T>::operator=(const MatCoo<T1> &rhs)
+template <class T> template <class T1, class Tind>
+inline Matrix<T> & Matrix<T>::operator=(const MatCoo<T1, Tind> &rhs)
 {
     return coo2dense(*this, rhs);
 }
 
-template <class T> template <class T1>
-inline Matrix<T> & Matrix<T>::operator=(const MatCooH<T1> &rhs)
+template <class T> template <class T1, class Tind>
+inline Matrix<T> & Matrix<T>::operator=(const MatCooH<T1, Tind> &rhs)
 {
     return cooh2dense(*this, rhs);
 }
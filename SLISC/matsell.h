@@ -0,0 +1,260 @@
+// SELL-C-sigma (sliced ELLPACK) sparse matrix
+// rows are grouped into slices of C rows, each slice is stored column major and padded to its longest row
+// so that matrix-vector multiplication processes C rows at a time with vector instructions
+// to reduce padding, rows are sorted by length (descending) within each window of sigma rows
+// converted from MatCoo or MatCooH (both triangles are stored)
+#pragma once
+#include "matcooh.h"
+
+namespace slisc {
+template <class T, class Tind>
+class MatSell : public Vbase<T>
+{
+private:
+    typedef Vbase<T> Base;
+    using Base::m_p;
+    using Base::m_N;
+    Long m_Nr, m_Nc, m_Nnz;
+    Long m_C, m_sigma; // slice height, sorting window
+    VecLong m_slice; // m_slice[s] is the index of the first element of slice s, m_slice[Nslice] = m_N
+    Vector<Tind> m_col; // column index of each element (including padding), Tind is Int or Long
+    Vector<Tind> m_perm; // m_perm[k] is the original row of the k-th stored row
+    MatSell() {} // default constructor: uninitialized
+public:
+    using Base::ptr;
+    // C should be a multiple of the vector width
+    MatSell(Long_I Nr, Long_I Nc, Long_I C = 8, Long_I sigma = 256);
+    MatSell(const MatSell &rhs); // Copy constructor
+    template <class T1, class Tind1, SLS_IF(is_promo<T, T1>())>
+    MatSell &operator=(const MatCoo<T1, Tind1> &rhs);
+    template <class T1, class Tind1, SLS_IF(is_promo<T, T1>())>
+    MatSell &operator=(const MatCooH<T1, Tind1> &rhs);
+    Long n1() const;
+    Long n2() const;
+    Long size() const; // return m_Nr * m_Nc
+    Long nnz() const; // number of non-zero elements (without padding)
+    Long capacity() const; // number of stored elements (with padding)
+    Long C() const;
+    Long sigma() const;
+    Long nslice() const;
+    Long *slice_ptr();
+    const Long *slice_ptr() const;
+    Tind *col_ptr();
+    const Tind *col_ptr() const;
+    Tind *perm_ptr();
+    const Tind *perm_ptr() const;
+    // allocate for Nnz non-zero elements and Ncap stored elements, data will be lost
+    void resize(Long_I Nnz, Long_I Ncap);
+};
+
+template <class T, class Tind>
+MatSell<T, Tind>::MatSell(Long_I Nr, Long_I Nc, Long_I C, Long_I sigma)
+    : m_Nr(Nr), m_Nc(Nc), m_Nnz(0), m_C(C), m_sigma(MAX(sigma, Long(1))),
+    m_slice((Nr + C - 1) / C + 1, Long(0)), m_col(0), m_perm(Nr)
+{
+    m_N = 0;
+    for (Long i = 0; i < Nr; ++i)
+        m_perm[i] = Tind(i);
+}
+
+template <class T, class Tind>
+MatSell<T, Tind>::MatSell(const MatSell<T, Tind> &rhs)
+{
+    SLS_ERR("Copy constructor or move constructor is forbidden, use reference "
+         "argument for function input or output, and use \"=\" to copy!");
+}
+
+template <class T, class Tind>
+template <class T1, class Tind1, SLS_IF0(is_promo<T, T1>())>
+MatSell<T, Tind> &MatSell<T, Tind>::operator=(const MatCoo<T1, Tind1> &rhs)
+{
+    coo2sell(*this, rhs, false);
+    return *this;
+}
+
+template <class T, class Tind>
+template <class T1, class Tind1, SLS_IF0(is_promo<T, T1>())>
+MatSell<T, Tind> &MatSell<T, Tind>::operator=(const MatCooH<T1, Tind1> &rhs)
+{
+    coo2sell(*this, rhs, true);
+    return *this;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::n1() const
+{
+    return m_Nr;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::n2() const
+{
+    return m_Nc;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::size() const
+{
+    return m_Nr * m_Nc;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::nnz() const
+{
+    return m_Nnz;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::capacity() const
+{
+    return m_N;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::C() const
+{
+    return m_C;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::sigma() const
+{
+    return m_sigma;
+}
+
+template <class T, class Tind>
+Long MatSell<T, Tind>::nslice() const
+{
+    return m_slice.size() - 1;
+}
+
+template <class T, class Tind>
+Long *MatSell<T, Tind>::slice_ptr()
+{
+    return m_slice.ptr();
+}
+
+template <class T, class Tind>
+const Long *MatSell<T, Tind>::slice_ptr() const
+{
+    return m_slice.ptr();
+}
+
+template <class T, class Tind>
+Tind *MatSell<T, Tind>::col_ptr()
+{
+    return m_col.ptr();
+}
+
+template <class T, class Tind>
+const Tind *MatSell<T, Tind>::col_ptr() const
+{
+    return m_col.ptr();
+}
+
+template <class T, class Tind>
+Tind *MatSell<T, Tind>::perm_ptr()
+{
+    return m_perm.ptr();
+}
+
+template <class T, class Tind>
+const Tind *MatSell<T, Tind>::perm_ptr() const
+{
+    return m_perm.ptr();
+}
+
+template <class T, class Tind>
+void MatSell<T, Tind>::resize(Long_I Nnz, Long_I Ncap)
+{
+    m_Nnz = Nnz;
+    Base::resize(Ncap);
+    m_col.resize(Ncap);
+}
+
+// convert MatCoo to MatSell (shape, C and sigma of b are used)
+// if herm, a only has the upper triangle, and the lower triangle is also stored in b
+template <class T, class Tind, class T1, class Tind1, SLS_IF(is_promo<T, T1>())>
+void coo2sell(MatSell<T, Tind> &b, const MatCoo<T1, Tind1> &a, Bool_I herm)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (!shape_cmp(a, b))
+        SLS_ERR("wrong shape!");
+#endif
+    Long Nr = a.n1(), Nnz = a.nnz(), C = b.C(), sigma = b.sigma();
+    Long Nslice = b.nslice();
+    const T1 *pa = a.ptr();
+    const Tind1 *row = a.row_ptr(), *col = a.col_ptr();
+
+    // group the elements by row (counting sort)
+    VecLong row_beg(Nr + 1, Long(0));
+    for (Long k = 0; k < Nnz; ++k) {
+        ++row_beg[row[k] + 1];
+        if (herm && row[k] != col[k])
+            ++row_beg[col[k] + 1];
+    }
+    for (Long i = 0; i < Nr; ++i)
+        row_beg[i + 1] += row_beg[i];
+    Long Nnz1 = row_beg[Nr];
+    Vector<T> val1(Nnz1); Vector<Tind> col1(Nnz1);
+    {
+        VecLong pos(Nr); veccpy(pos.ptr(), row_beg.ptr(), Nr);
+        for (Long k = 0; k < Nnz; ++k) {
+            Long r = row[k], c = col[k], n = pos[r]++;
+            val1[n] = pa[k]; col1[n] = Tind(c);
+            if (herm && r != c) {
+                n = pos[c]++;
+                val1[n] = CONJ(pa[k]); col1[n] = Tind(r);
+            }
+        }
+    }
+
+    // sort rows by length (descending) in each window of sigma rows
+    Tind *perm = b.perm_ptr();
+    VecLong len(sigma), ind(sigma);
+    for (Long i0 = 0; i0 < Nr; i0 += sigma) {
+        Long N = MIN(sigma, Nr - i0);
+        for (Long i = 0; i < N; ++i) {
+            len[i] = row_beg[i0 + i] - row_beg[i0 + i + 1];
+            ind[i] = i0 + i;
+        }
+        if (sigma > 1)
+            sort2_vv(len.ptr(), ind.ptr(), N);
+        for (Long i = 0; i < N; ++i)
+            perm[i0 + i] = Tind(ind[i]);
+    }
+
+    // slice widths and offsets
+    Long *slice = b.slice_ptr();
+    slice[0] = 0;
+    for (Long s = 0; s < Nslice; ++s) {
+        Long width = 0;
+        for (Long r = s * C; r < MIN((s + 1) * C, Nr); ++r)
+            width = MAX(width, row_beg[perm[r] + 1] - row_beg[perm[r]]);
+        slice[s + 1] = slice[s] + width * C;
+    }
+
+    // fill slices, padded with zeros
+    b.resize(Nnz1, slice[Nslice]);
+    T *pb = b.ptr();
+    Tind *b_col = b.col_ptr();
+#pragma omp parallel for schedule(dynamic, 16)
+    for (Long s = 0; s < Nslice; ++s) {
+        Long width = (slice[s + 1] - slice[s]) / C;
+        for (Long r = 0; r < C; ++r) {
+            Long k = slice[s] + r, n = 0, beg = 0, N = 0;
+            if (s * C + r < Nr) {
+                beg = row_beg[perm[s * C + r]];
+                N = row_beg[perm[s * C + r] + 1] - beg;
+            }
+            for (; n < N; ++n, k += C) {
+                pb[k] = val1[beg + n]; b_col[k] = col1[beg + n];
+            }
+            for (; n < width; ++n, k += C) {
+                pb[k] = 0; b_col[k] = 0;
+            }
+        }
+    }
+}
+
+} // namespace slisc
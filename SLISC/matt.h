@@ -7,6 +7,9 @@
 //#define MATFILE_DUAL
 
 #include "file.h"
+#include "mat3d.h"
+#include "svector.h"
+#include <unordered_map>
 
 namespace slisc {
 
@@ -31,6 +34,12 @@ public:
     vector<Int> m_type; // variable types
     vector<vector<Long>> m_size; // variable dimensions
     vector<Long> m_ind; // variable positions (line indices)
+    // positions of each record of a variable written by append() (empty for other variables)
+    // read mode: position of the data of each record; write mode: position of the header of each record
+    // in write mode, m_type, m_size are only used for appended variables
+    vector<vector<Long>> m_ind_rec;
+    // write mode: index of the first variable of each name
+    std::unordered_map<Str, Int> m_name_ind;
 
     // open a file, return 0 if success
     // return -2 if reading failed (e.g. file is not finished, wrong format)
@@ -48,6 +57,23 @@ public:
     // return 0 if successful, return -1 if failed
     Int get_profile();
 
+    // get var names and positions by scanning the file from the beginning
+    // used when the profile at the end of the file is missing
+    // (e.g. the program crashed before close()), an incomplete last variable is dropped
+    // return 0 if successful, return -1 if failed
+    Int scan_profile();
+
+    // read a variable header (name, type, dimensions) at the current position of m_in
+    // `rec` is true for a record written by append() (number of dimensions written as negative)
+    // return 0 if successful, return -1 if failed
+    Int read_header(Str_O name, Int_O type, vector<Long> &size, Bool_O rec);
+
+    // register a new variable for save() at the current position of m_out
+    void add_var(Str_I varname);
+
+    // check and write the header of a record for append()
+    void append_header(Str_I varname, Int_I type, const vector<Long> &size);
+
     // search a variable by name, return index to m_name[i]
     // return -1 if not found
     Int search(Str_I name);
@@ -87,11 +113,55 @@ Long scanInverse(ifstream &fin)
     return N;
 }
 
+inline Int Matt::read_header(Str_O name, Int_O type, vector<Long> &size, Bool_O rec)
+{
+    Long j, n, temp;
+    ifstream &fin = m_in;
+    // read var name
+    fin >> n;
+    if (!fin.good() || n < 0)
+        return -1;
+    name.resize(0);
+    for (j = 0; j < n; ++j) {
+        fin >> temp;
+        if (temp <= 0 || temp > 127)
+            return -1;
+        name.push_back((Char)temp);
+    }
+    // read var type
+    fin >> temp;
+    if (temp < 0 || temp > 100)
+        return -1;
+    type = (Int)temp;
+    // read var dim
+    fin >> n;
+    rec = n < 0;
+    if (rec)
+        n = -n;
+    if (n > 10)
+        return -1;
+    size.resize(0);
+    for (j = 0; j < n; ++j) {
+        fin >> temp;
+        if (temp < 0)
+            return -1;
+        size.push_back(temp);
+    }
+    if (!fin.good())
+        return -1;
+    return 0;
+}
+
+// profile at the end of the file (read backward): number of variables, then for each variable
+// either the position of its header, or (written by append()) minus the number of records,
+// the header position of the first record, and the increments of the header positions
 inline Int Matt::get_profile()
 {
-    Int i, j, n, temp;
+    Int i, type;
+    Long k, Nrec, hlen;
     vector<Long> size;
     Str name;
+    Bool rec;
     ifstream &fin = m_in;
 
     // read number of variables and their positions
@@ -101,47 +171,100 @@ inline Int Matt::get_profile()
     if (m_n < 1)
         return -1;
     m_ind.resize(m_n);
+    m_ind_rec.clear(); m_ind_rec.resize(m_n);
     for (i = 0; i < m_n; ++i) {
         m_ind[i] = scanInverse(fin);
+        if (m_ind[i] < 0) {
+            Nrec = -m_ind[i];
+            vector<Long> &ind_rec = m_ind_rec[i];
+            ind_rec.resize(Nrec);
+            m_ind[i] = ind_rec[0] = scanInverse(fin);
+            for (k = 1; k < Nrec; ++k) {
+                ind_rec[k] = ind_rec[k - 1] + scanInverse(fin);
+                if (ind_rec[k] <= ind_rec[k - 1] || ind_rec[k] >= gmax)
+                    return -1;
+            }
+        }
         if (m_ind[i] >= gmax || m_ind[i] < 0)
             return -1;
         if (i > 0 && m_ind[i] <= m_ind[i - 1])
             return -1;
     }
 
-    // loop through each variable
+    // loop through each variable, only the first header of appended variables is read
     for (i = 0; i < m_n; ++i) {
         fin.seekg(m_ind[i]);
-        // read var name
-        fin >> n;
-        name.resize(0);
-        for (j = 0; j < n; ++j) {
-            fin >> temp;
-            if (temp <= 0 || temp > 127)
-                return -1;
-            name.push_back((Char)temp);
-        }
-        m_name.push_back(name);
-        // read var type
-        fin >> temp;
-        if (temp < 0 || temp > 100)
+        if (read_header(name, type, size, rec))
             return -1;
-        m_type.push_back(temp);
-        // read var dim
-        fin >> n;
-        if (n < 0 || n > 10)
+        hlen = (Long)fin.tellg() - m_ind[i];
+        m_ind[i] += hlen;
+        if (rec != !m_ind_rec[i].empty())
             return -1;
-        size.resize(0);
-        for (j = 0; j < n; ++j) {
-            fin >> temp;
-            if (temp < 0)
+        if (rec) {
+            // records have the same header, so the data follows each header at the same offset
+            if (size.empty())
                 return -1;
-            size.push_back(temp);
+            size.back() = m_ind_rec[i].size();
+            for (k = 0; k < (Long)m_ind_rec[i].size(); ++k)
+                m_ind_rec[i][k] += hlen;
+        }
+        m_name.push_back(name);
+        m_type.push_back(type);
+        m_size.push_back(size);
+    }
+    return 0;
+}
+
+inline Int Matt::scan_profile()
+{
+    Int type;
+    Long i, N, ind;
+    vector<Long> size;
+    Str name, str;
+    Bool rec;
+    ifstream &fin = m_in;
+    std::unordered_map<Str, Int> rec_ind; // index of appended variables
+
+    m_n = 0;
+    m_name.clear(); m_type.clear(); m_size.clear(); m_ind.clear(); m_ind_rec.clear();
+    fin.clear(); fin.seekg(0);
+    while (true) {
+        if (read_header(name, type, size, rec))
+            break;
+        ind = fin.tellg();
+        // skip var data, every number is followed by a delimiter
+        N = 1;
+        for (i = 0; i < (Long)size.size(); ++i)
+            N *= size[i];
+        for (i = 0; i < N; ++i)
+            fin >> str;
+        if (fin.get() != dlm)
+            break;
+        if (rec) {
+            // another record of an appended variable
+            auto it = rec_ind.find(name);
+            if (it != rec_ind.end()) {
+                Int j = it->second;
+                if (m_type[j] != type || m_size[j].size() != size.size() ||
+                    !std::equal(size.begin(), size.end() - 1, m_size[j].begin()))
+                    break;
+                ++m_size[j].back();
+                m_ind_rec[j].push_back(ind);
+                continue;
+            }
+            rec_ind[name] = m_n;
         }
+        m_name.push_back(name);
+        m_type.push_back(type);
         m_size.push_back(size);
-        m_ind[i] = fin.tellg();
+        m_ind.push_back(ind);
+        m_ind_rec.push_back(rec ? vector<Long>{ ind } : vector<Long>());
+        ++m_n;
     }
-	return 0;
+    fin.clear();
+    if (m_n < 1)
+        return -1;
+    return 0;
 }
 
 // search variable in file by name
@@ -193,7 +316,9 @@ Int Matt::open(Str_I fname, Char_I *rw, Int_I precision)
         if (!m_in.good())
             SLS_ERR("error: file not found: " + fname);
         m_in.precision(17);
-        return get_profile(); // get var names
+        if (get_profile() == 0) // get var names
+            return 0;
+        return scan_profile(); // profile missing, try to recover
     }
     return 0;
 }
@@ -207,9 +332,17 @@ inline void Matt::close()
 {
     if (m_rw == 'w') {
         ofstream &fout = m_out;
-        // write position of variables
-        for (Long i = m_ind.size() - 1; i >= 0; --i)
-            fout << m_ind[i] << dlm;
+        // write position of variables (see get_profile())
+        for (Long i = m_ind.size() - 1; i >= 0; --i) {
+            const vector<Long> &ind_rec = m_ind_rec[i];
+            if (ind_rec.empty()) {
+                fout << m_ind[i] << dlm;
+                continue;
+            }
+            for (Long k = ind_rec.size() - 1; k > 0; --k)
+                fout << ind_rec[k] - ind_rec[k - 1] << dlm;
+            fout << ind_rec[0] << dlm << -(Long)ind_rec.size() << dlm;
+        }
         // write number of variables
         fout << m_n;
         m_out.close();
@@ -223,6 +356,8 @@ inline void Matt::close()
     m_type.clear();
     m_size.clear();
     m_ind.clear();
+    m_ind_rec.clear();
+    m_name_ind.clear();
 }
 
 // send one scalar to ofstream
@@ -293,7 +428,7 @@ void save(const T &s, Str_I varname, Matt_IO matt)
     ofstream &fout = matt.m_out;
     if (!fout.is_open())
         SLS_ERR("matt file not open: " + matt.fname);
-    ++matt.m_n; matt.m_ind.push_back(fout.tellp());
+    matt.add_var(varname);
     // write variable name info
     n = varname.size();
     fout << n << Matt::dlm;
@@ -316,7 +451,7 @@ inline void save(const Tv &v, Str_I varname, Matt_IO matt)
     ofstream &fout = matt.m_out;
     if (!fout.is_open())
         SLS_ERR("matt file not open!");
-    ++matt.m_n; matt.m_ind.push_back(fout.tellp());
+    matt.add_var(varname);
     // write variable name info
     n = varname.size();
     fout << n << Matt::dlm;
@@ -345,7 +480,7 @@ inline void save(const Tm &a, Str_I varname, Matt_IO matt,
     ofstream &fout = matt.m_out;
     if (!fout.is_open())
         SLS_ERR("matt file not open!");
-    ++matt.m_n; matt.m_ind.push_back(fout.tellp());
+    matt.add_var(varname);
     // write variable name info
     n = varname.size();
     fout << n << Matt::dlm;
@@ -373,7 +508,7 @@ inline void save(const Tmat &a, Str_I varname, Matt_IO matt,
     ofstream &fout = matt.m_out;
     if (!fout.is_open())
         SLS_ERR("matt file not open!");
-    ++matt.m_n; matt.m_ind.push_back(fout.tellp());
+    matt.add_var(varname);
     // write variable name info
     n = varname.size();
     fout << n << Matt::dlm;
@@ -401,7 +536,7 @@ inline void save(Mat3Doub_I &a, Str_I varname, Matt_IO matt,
     ofstream &fout = matt.m_out;
     if (!fout.is_open())
         SLS_ERR("matt file not open!");
-    ++matt.m_n; matt.m_ind.push_back(fout.tellp());
+    matt.add_var(varname);
     // write variable name info
     n = varname.size();
     fout << n << Matt::dlm;
@@ -457,7 +592,7 @@ inline void save(Mat3Comp_I &a, Str_I varname, Matt_IO matt,
     ofstream &fout = matt.m_out;
     if (!fout.is_open())
         SLS_ERR("matt file not open!");
-    ++matt.m_n; matt.m_ind.push_back(fout.tellp());
+    matt.add_var(varname);
     // write variable name info
     n = varname.size();
     fout << n << Matt::dlm;
@@ -576,23 +711,27 @@ template <class Tm, class T = contain_type<Tm>, SLS_IF(
         is_Doub<T>() || is_Comp<T>()))>
 inline Int load(Tm &a, Str_I varname, Matt_IO matt)
 {
-    Long i, j, m, n;
+    Long i, j, m, n, ivar;
     ifstream &fin = matt.m_in;
-    i = matt.search(varname);
-    if (i < 0)
+    ivar = matt.search(varname);
+    if (ivar < 0)
         return -1;
-    fin.seekg(matt.m_ind[i]);
+    fin.seekg(matt.m_ind[ivar]);
 
-    if (!is_promo(type_num<T>(), matt.m_type[i]))
+    if (!is_promo(type_num<T>(), matt.m_type[ivar]))
         SLS_ERR("wrong type!");
-    if (matt.m_size[i].size() != 2)
+    if (matt.m_size[ivar].size() != 2)
         SLS_ERR("wrong dimension!");
 
-    m = matt.m_size[i][0]; n = matt.m_size[i][1]; a.resize(m, n);
+    const vector<Long> &ind_rec = matt.m_ind_rec[ivar];
+    m = matt.m_size[ivar][0]; n = matt.m_size[ivar][1]; a.resize(m, n);
     // read var data
-    for (j = 0; j < n; ++j)
+    for (j = 0; j < n; ++j) {
+        if (!ind_rec.empty())
+            fin.seekg(ind_rec[j]);
         for (i = 0; i < m; ++i)
             matt.read(a(i, j));
+    }
     return 0;
 }
 
@@ -600,25 +739,172 @@ template <class Tmat, class T = contain_type<Tmat>, SLS_IF(
     is_dense<Tmat>() && ndims<Tmat>() == 3 && is_scalar<T>())>
 inline Int load(Tmat &a, Str_I varname, Matt_IO matt)
 {
-    Long i, j, k, m, n, q;
+    Long i, j, k, m, n, q, ivar;
     ifstream &fin = matt.m_in;
-    i = matt.search(varname);
-    if (i < 0)
+    ivar = matt.search(varname);
+    if (ivar < 0)
         return -1;
-    fin.seekg(matt.m_ind[i]);
+    fin.seekg(matt.m_ind[ivar]);
 
-    if (!is_promo(type_num<T>(), matt.m_type[i]))
+    if (!is_promo(type_num<T>(), matt.m_type[ivar]))
         SLS_ERR("wrong type!");
-    if (matt.m_size[i].size() != 3)
+    if (matt.m_size[ivar].size() != 3)
         SLS_ERR("wrong dimension!");
     
-    m = matt.m_size[i][0]; n = matt.m_size[i][1]; q = matt.m_size[i][2];
+    const vector<Long> &ind_rec = matt.m_ind_rec[ivar];
+    m = matt.m_size[ivar][0]; n = matt.m_size[ivar][1]; q = matt.m_size[ivar][2];
     a.resize(m, n, q);
     // read var data
-    for (k = 0; k < q; ++k)
+    for (k = 0; k < q; ++k) {
+        if (!ind_rec.empty())
+            fin.seekg(ind_rec[k]);
         for (j = 0; j < n; ++j)
             for (i = 0; i < m; ++i)
                 matt.read(a(i, j, k));
+    }
+    return 0;
+}
+
+// ===== append records to a variable =====
+// each call of append() adds one record to variable `varname`, a vector (or matrix) becomes
+// a matrix (or 3D array) whose last dimension is the number of records.
+// the record is flushed to the file, so that the file can still be read after a crash.
+// records of the same variable must have the same type and size.
+// a record header has a negative number of dimensions, the profile written by close() has one entry
+// for each appended variable (see get_profile()), so that only the first record header is read when opened.
+// a name can not be used by both save() and append().
+
+inline void Matt::add_var(Str_I varname)
+{
+    auto it = m_name_ind.find(varname);
+    if (it != m_name_ind.end() && !m_ind_rec[it->second].empty())
+        SLS_ERR("variable already written by append(): " + varname);
+    if (it == m_name_ind.end())
+        m_name_ind[varname] = m_n;
+    m_name.push_back(varname);
+    m_type.push_back(-1);
+    m_size.emplace_back();
+    m_ind.push_back(m_out.tellp());
+    m_ind_rec.emplace_back();
+    ++m_n;
+}
+
+inline void Matt::append_header(Str_I varname, Int_I type, const vector<Long> &size)
+{
+    Long i, n;
+    ofstream &fout = m_out;
+    if (!fout.is_open())
+        SLS_ERR("matt file not open!");
+    // check with previous records
+    auto it = m_name_ind.find(varname);
+    if (it != m_name_ind.end()) {
+        i = it->second;
+        if (m_ind_rec[i].empty())
+            SLS_ERR("variable already written by save(): " + varname);
+        if (m_type[i] != type || m_size[i] != size)
+            SLS_ERR("type or size does not match previous records: " + varname);
+        m_ind_rec[i].push_back(fout.tellp());
+    }
+    else {
+        Long ind = fout.tellp();
+        m_name_ind[varname] = m_n;
+        m_name.push_back(varname);
+        m_type.push_back(type);
+        m_size.push_back(size);
+        m_ind.push_back(ind);
+        m_ind_rec.emplace_back(1, ind);
+        ++m_n;
+    }
+    // write variable name info
+    n = varname.size();
+    fout << n << dlm;
+    for (i = 0; i < n; ++i) {
+        fout << to_num(varname.at(i)) << dlm;
+    }
+    // write data type info
+    fout << type << dlm;
+    // write dimension info, negative to mark a record
+    fout << -(Long)size.size() << dlm;
+    for (i = 0; i < (Long)size.size(); ++i)
+        fout << size[i] << dlm;
+}
+
+template <class Tv, class T = contain_type<Tv>, SLS_IF(
+    ndims<Tv>() == 1 && (is_Char<T>() || is_Int<T>() || is_Llong<T>() ||
+        is_Doub<T>() || is_Comp<T>()))>
+inline void append(const Tv &v, Str_I varname, Matt_IO matt)
+{
+    Long i, n = v.size();
+    matt.append_header(varname, type_num<T>(), { n, 1 });
+    for (i = 0; i < n; ++i)
+        matt.write(v[i]);
+    matt.m_out.flush();
+}
+
+template <class Tm, class T = contain_type<Tm>, SLS_IF(
+    (is_Matrix<Tm>() || is_Cmat<Tm>()) &&
+    (is_Char<T>() || is_Int<T>() || is_Llong<T>() || is_Doub<T>() || is_Comp<T>())
+)>
+inline void append(const Tm &a, Str_I varname, Matt_IO matt)
+{
+    Long i, j, m = a.n1(), n = a.n2();
+    matt.append_header(varname, type_num<T>(), { m, n, 1 });
+    for (j = 0; j < n; ++j)
+        for (i = 0; i < m; ++i)
+            matt.write(a(i, j));
+    matt.m_out.flush();
+}
+
+// read one record of a variable written by append(), record index starts from 0
+// return 0 if successful, -1 if variable not found
+template <class T, SLS_IF(
+    is_Char<T>() || is_Int<T>() || is_Llong<T>() ||
+    is_Doub<T>() || is_Comp<T>())>
+inline Int load_rec(Vector<T> &v, Str_I varname, Long_I irec, Matt_IO matt)
+{
+    Long i, n, ivar;
+    ifstream &fin = matt.m_in;
+    ivar = matt.search(varname);
+    if (ivar < 0)
+        return -1;
+
+    if (!is_promo(type_num<T>(), matt.m_type[ivar]))
+        SLS_ERR("wrong type!");
+    if (matt.m_size[ivar].size() != 2 || matt.m_ind_rec[ivar].empty())
+        SLS_ERR("wrong dimension or not written by append()!");
+    if (irec < 0 || irec >= matt.m_size[ivar][1])
+        SLS_ERR("record index out of bound!");
+
+    fin.seekg(matt.m_ind_rec[ivar][irec]);
+    n = matt.m_size[ivar][0]; v.resize(n);
+    for (i = 0; i < n; ++i)
+        matt.read(v[i]);
+    return 0;
+}
+
+template <class Tm, class T = contain_type<Tm>, SLS_IF(
+    is_dense_mat<Tm>() && (is_Char<T>() || is_Int<T>() || is_Llong<T>() ||
+        is_Doub<T>() || is_Comp<T>()))>
+inline Int load_rec(Tm &a, Str_I varname, Long_I irec, Matt_IO matt)
+{
+    Long i, j, m, n, ivar;
+    ifstream &fin = matt.m_in;
+    ivar = matt.search(varname);
+    if (ivar < 0)
+        return -1;
+
+    if (!is_promo(type_num<T>(), matt.m_type[ivar]))
+        SLS_ERR("wrong type!");
+    if (matt.m_size[ivar].size() != 3 || matt.m_ind_rec[ivar].empty())
+        SLS_ERR("wrong dimension or not written by append()!");
+    if (irec < 0 || irec >= matt.m_size[ivar][2])
+        SLS_ERR("record index out of bound!");
+
+    fin.seekg(matt.m_ind_rec[ivar][irec]);
+    m = matt.m_size[ivar][0]; n = matt.m_size[ivar][1]; a.resize(m, n);
+    for (j = 0; j < n; ++j)
+        for (i = 0; i < m; ++i)
+            matt.read(a(i, j));
     return 0;
 }
 
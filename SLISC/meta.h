@@ -438,7 +438,7 @@ constexpr Bool is_Diag()
 }
 
 template <class T> struct is_MatCoo_imp : false_type {};
-template <class T> struct is_MatCoo_imp<MatCoo<T>> : integral_constant<Bool, is_scalar<T>()> {};
+template <class T, class Tind> struct is_MatCoo_imp<MatCoo<T, Tind>> : integral_constant<Bool, is_scalar<T>()> {};
 template<class T>
 constexpr Bool is_MatCoo()
 {
@@ -453,14 +453,38 @@ constexpr Bool is_CmatObd()
     return is_CmatObd_imp<T>();
 }
 
+template <class T> struct is_OpFedvr_imp : false_type {};
+template <class T> struct is_OpFedvr_imp<OpFedvr<T>> : integral_constant<Bool, is_scalar<T>()> {};
+template<class T>
+constexpr Bool is_OpFedvr()
+{
+    return is_OpFedvr_imp<T>();
+}
+
 template <class T> struct is_MatCooH_imp : false_type {};
-template <class T> struct is_MatCooH_imp<MatCooH<T>> : integral_constant<Bool, is_scalar<T>()> {};
+template <class T, class Tind> struct is_MatCooH_imp<MatCooH<T, Tind>> : integral_constant<Bool, is_scalar<T>()> {};
 template<class T>
 constexpr Bool is_MatCooH()
 {
     return is_MatCooH_imp<T>();
 }
 
+template <class T> struct is_MatSell_imp : false_type {};
+template <class T, class Tind> struct is_MatSell_imp<MatSell<T, Tind>> : integral_constant<Bool, is_scalar<T>()> {};
+template<class T>
+constexpr Bool is_MatSell()
+{
+    return is_MatSell_imp<T>();
+}
+
+template <class T> struct is_MatCsr_imp : false_type {};
+template <class T, class Tind> struct is_MatCsr_imp<MatCsr<T, Tind>> : integral_constant<Bool, is_scalar<T>()> {};
+template<class T>
+constexpr Bool is_MatCsr()
+{
+    return is_MatCsr_imp<T>();
+}
+
 // check if is fixed-size container
 template <class T> constexpr Bool is_fixed()
 {
@@ -495,7 +519,7 @@ template <class T> constexpr Bool is_dense()
 // check if is sparse vector/matrix
 template <class T> constexpr Bool is_sparse_mat()
 {
-    return is_Diag<T>() || is_MatCoo<T>() || is_MatCooH<T>() || is_CmatObd<T>();
+    return is_Diag<T>() || is_MatCoo<T>() || is_MatCooH<T>() || is_CmatObd<T>() || is_MatCsr<T>() || is_MatSell<T>();
 }
 
 template <class T>
@@ -516,6 +540,8 @@ constexpr Int contain_num()
     else if (is_MatCoo<T>()) return 32;
     else if (is_MatCooH<T>()) return 33;
     else if (is_CmatObd<T>()) return 34;
+    else if (is_MatCsr<T>()) return 35;
+    else if (is_MatSell<T>()) return 36;
 
     else if (is_Svector<T>()) return 40;
     else if (is_Dvector<T>()) return 41;
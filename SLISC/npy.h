@@ -0,0 +1,724 @@
+// save/load dense containers to NumPy ".npy" files and ".npz" bundles
+// row-major containers are saved with fortran_order = False, column-major with fortran_order = True,
+// so no transpose is needed in either language.
+// only little-endian machines are supported.
+// ".npz" files are written uncompressed, compressed ".npz" (savez_compressed) requires SLS_USE_ZLIB to read.
+// NpyMap maps the payload of a ".npy" file into memory, to be used by slice containers without copy.
+
+#pragma once
+#include "file.h"
+#include <cstdint>
+#ifdef SLS_USE_ZLIB
+#include <zlib.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__) // POSIX mmap() is available
+#define SLS_NPY_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace slisc {
+
+using std::uint16_t;
+
+class Npz;
+typedef const Npz &Npz_I;
+typedef Npz &Npz_O, &Npz_IO;
+
+// NumPy type string of a scalar type
+template <class T>
+inline Str npy_descr()
+{
+    if (is_Bool<T>()) return "|b1";
+    if (is_Char<T>()) return "|i1";
+    if (is_Uchar<T>()) return "|u1";
+    if (is_Int<T>()) return "<i4";
+    if (is_Llong<T>()) return "<i8";
+    if (is_Float<T>()) return "<f4";
+    if (is_Doub<T>()) return "<f8";
+    if (is_Fcomp<T>()) return "<c8";
+    if (is_Comp<T>()) return "<c16";
+    SLS_ERR("type not supported by .npy!");
+    return "";
+}
+
+// shape of a dense container
+
+template <class Tv, SLS_IF(ndims<Tv>() == 1)>
+inline vector<Long> npy_shape(const Tv &v)
+{ return { v.size() }; }
+
+template <class Tm, SLS_IF(ndims<Tm>() == 2)>
+inline vector<Long> npy_shape(const Tm &a)
+{ return { a.n1(), a.n2() }; }
+
+template <class Tm, SLS_IF(ndims<Tm>() == 3)>
+inline vector<Long> npy_shape(const Tm &a)
+{ return { a.n1(), a.n2(), a.n3() }; }
+
+template <class Tm, SLS_IF(ndims<Tm>() == 4)>
+inline vector<Long> npy_shape(const Tm &a)
+{ return { a.n1(), a.n2(), a.n3(), a.n4() }; }
+
+// resize a container to shape
+
+template <class Tv, SLS_IF(ndims<Tv>() == 1)>
+inline void npy_resize(Tv &v, const vector<Long> &shape)
+{
+    Long N = 1;
+    for (Long i = 0; i < Size(shape); ++i)
+        N *= shape[i];
+    v.resize(N);
+}
+
+template <class Tm, SLS_IF(ndims<Tm>() == 2)>
+inline void npy_resize(Tm &a, const vector<Long> &shape)
+{
+    if (shape.size() != 2) SLS_ERR("wrong dimension!");
+    a.resize(shape[0], shape[1]);
+}
+
+template <class Tm, SLS_IF(ndims<Tm>() == 3)>
+inline void npy_resize(Tm &a, const vector<Long> &shape)
+{
+    if (shape.size() != 3) SLS_ERR("wrong dimension!");
+    a.resize(shape[0], shape[1], shape[2]);
+}
+
+template <class Tm, SLS_IF(ndims<Tm>() == 4)>
+inline void npy_resize(Tm &a, const vector<Long> &shape)
+{
+    if (shape.size() != 4) SLS_ERR("wrong dimension!");
+    a.resize(shape[0], shape[1], shape[2], shape[3]);
+}
+
+// === .npy header ===
+
+// generate the full header (magic string, version, header length, dictionary)
+inline Str npy_header(Str_I descr, Bool_I fortran, const vector<Long> &shape)
+{
+    Str dict = "{'descr': '" + descr + "', 'fortran_order': " +
+        (fortran ? "True" : "False") + ", 'shape': (";
+    for (Long i = 0; i < Size(shape); ++i) {
+        dict += to_string(shape[i]);
+        if (i < Size(shape) - 1 || shape.size() == 1)
+            dict += ",";
+        if (i < Size(shape) - 1)
+            dict += " ";
+    }
+    dict += "), }";
+    // total header length should be a multiple of 64, ends with '\n'
+    Long Nhead = 10 + dict.size() + 1;
+    dict += Str((64 - Nhead % 64) % 64, ' ') + '\n';
+    if (dict.size() > 65535)
+        SLS_ERR("header too long!");
+    Str head = "\x93NUMPY";
+    head += (Char)1; head += (Char)0;
+    head += (Char)(dict.size() & 255); head += (Char)(dict.size() >> 8);
+    return head + dict;
+}
+
+// parse the header, stream position will be at the beginning of data
+// return 0 if successful, -1 if failed
+inline Int npy_read_header(std::istream &fin, Str_O descr, Bool_O fortran, vector<Long> &shape)
+{
+    Char magic[8];
+    fin.read(magic, 8);
+    if (!fin.good() || Str(magic, 6) != "\x93NUMPY")
+        return -1;
+    Long Nhead;
+    Uchar len[4];
+    if (magic[6] == 1) { // version 1.0
+        fin.read((Char *)len, 2);
+        Nhead = len[0] + 256 * (Long)len[1];
+    }
+    else { // version 2.0, 3.0
+        fin.read((Char *)len, 4);
+        Nhead = len[0] + 256 * ((Long)len[1] + 256 * ((Long)len[2] + 256 * (Long)len[3]));
+    }
+    Str dict(Nhead, ' ');
+    fin.read(&dict[0], Nhead);
+    if (!fin.good())
+        return -1;
+    // descr
+    Long ind = dict.find("'descr'");
+    if (ind < 0) return -1;
+    ind = dict.find('\'', dict.find(':', ind));
+    Long ind1 = dict.find('\'', ind + 1);
+    if (ind < 0 || ind1 < 0) return -1;
+    descr = dict.substr(ind + 1, ind1 - ind - 1);
+    // fortran_order
+    ind = dict.find("'fortran_order'");
+    if (ind < 0) return -1;
+    ind = dict.find(':', ind);
+    while (dict[++ind] == ' ');
+    fortran = dict[ind] == 'T';
+    // shape
+    ind = dict.find("'shape'");
+    if (ind < 0) return -1;
+    ind = dict.find('(', ind); ind1 = dict.find(')', ind);
+    if (ind < 0 || ind1 < 0) return -1;
+    shape.clear();
+    Str str = dict.substr(ind + 1, ind1 - ind - 1);
+    for (Long i = 0; i < Size(str); ++i) {
+        if (str[i] >= '0' && str[i] <= '9') {
+            shape.push_back(0);
+            for (; i < Size(str) && str[i] >= '0' && str[i] <= '9'; ++i)
+                shape.back() = 10 * shape.back() + (str[i] - '0');
+        }
+    }
+    return 0;
+}
+
+// reorder data from column-major to row-major (fortran = true), or reverse
+template <class T>
+inline void npy_reorder(T *out, const T *in, const vector<Long> &shape, Bool_I fortran)
+{
+    Long i, k, Nd = shape.size(), N = 1;
+    for (k = 0; k < Nd; ++k)
+        N *= shape[k];
+    // step of each dimension in output
+    vector<Long> step(Nd), ind(Nd, 0);
+    Long s = 1;
+    if (fortran) {
+        for (k = Nd - 1; k >= 0; --k) { step[k] = s; s *= shape[k]; }
+    }
+    else {
+        for (k = 0; k < Nd; ++k) { step[k] = s; s *= shape[k]; }
+    }
+    // loop input in its own order
+    Long j = 0;
+    for (i = 0; i < N; ++i) {
+        out[j] = in[i];
+        if (fortran) { // first index is the fastest in input
+            for (k = 0; k < Nd; ++k) {
+                ++ind[k]; j += step[k];
+                if (ind[k] < shape[k]) break;
+                j -= step[k] * shape[k]; ind[k] = 0;
+            }
+        }
+        else { // last index is the fastest in input
+            for (k = Nd - 1; k >= 0; --k) {
+                ++ind[k]; j += step[k];
+                if (ind[k] < shape[k]) break;
+                j -= step[k] * shape[k]; ind[k] = 0;
+            }
+        }
+    }
+}
+
+// write a container (header and data) to a stream
+template <class Tm, class T = contain_type<Tm>, SLS_IF(is_dense<Tm>())>
+inline void npy_write(std::ostream &fout, const Tm &a)
+{
+    Str head = npy_header(npy_descr<T>(), is_cmajor<Tm>(), npy_shape(a));
+    fout.write(head.data(), head.size());
+    if (a.size() > 0)
+        fout.write((const Char *)a.ptr(), a.size() * sizeof(T));
+}
+
+// read a container (header and data) from a stream
+// return 0 if successful, -1 if failed
+template <class Tm, class T = contain_type<Tm>, SLS_IF(
+    is_Vector<Tm>() || is_Matrix<Tm>() || is_Cmat<Tm>() || is_Mat3d<Tm>() ||
+    is_Cmat3d<Tm>() || is_Cmat4d<Tm>() || is_FixVec<Tm>() || is_FixCmat<Tm>())>
+inline Int npy_read(Tm &a, std::istream &fin)
+{
+    Str descr; Bool fortran; vector<Long> shape;
+    if (npy_read_header(fin, descr, fortran, shape))
+        return -1;
+    if (descr != npy_descr<T>())
+        SLS_ERR("wrong type: " + descr + ", expecting: " + npy_descr<T>());
+    npy_resize(a, shape);
+    if (a.size() == 0)
+        return 0;
+    if (ndims<Tm>() == 1 || shape.size() < 2 || fortran == is_cmajor<Tm>()) {
+        fin.read((Char *)a.ptr(), a.size() * sizeof(T));
+    }
+    else {
+        vector<T> data(a.size());
+        fin.read((Char *)data.data(), a.size() * sizeof(T));
+        npy_reorder(a.ptr(), data.data(), shape, fortran);
+    }
+    return fin.good() ? 0 : -1;
+}
+
+// save a container to a ".npy" file (replace old file)
+template <class Tm, SLS_IF(is_dense<Tm>())>
+inline void save_npy(const Tm &a, Str_I fname)
+{
+    ofstream fout(fname, std::ios::binary);
+    if (!fout.good())
+        SLS_ERR("file not created (directory does not exist ?): " + fname);
+    npy_write(fout, a);
+}
+
+// load a container from a ".npy" file
+// return 0 if successful, -1 if failed
+template <class Tm, SLS_IF(
+    is_Vector<Tm>() || is_Matrix<Tm>() || is_Cmat<Tm>() || is_Mat3d<Tm>() ||
+    is_Cmat3d<Tm>() || is_Cmat4d<Tm>() || is_FixVec<Tm>() || is_FixCmat<Tm>())>
+inline Int load_npy(Tm &a, Str_I fname)
+{
+    ifstream fin(fname, std::ios::binary);
+    if (!fin.good())
+        SLS_ERR("file not found: " + fname);
+    return npy_read(a, fin);
+}
+
+// === memory map of a ".npy" file ===
+// the mapped data is read only and valid until close() or destruction
+// a row-major 2D array (fortran_order = False) is viewed as the transpose by Scmat_c
+class NpyMap
+{
+private:
+    Char *m_p; // mapped file
+    Long m_size; // file size
+    Long m_ind; // position of data
+    Bool m_mmap; // if false, the file is read to memory instead
+public:
+    Str descr; // NumPy type string
+    Bool fortran; // fortran_order
+    vector<Long> shape; // dimensions
+
+    NpyMap();
+    NpyMap(Str_I fname);
+    NpyMap(const NpyMap &) = delete; // owns m_p, copy is forbidden
+    NpyMap &operator=(const NpyMap &) = delete;
+    // return 0 if successful, -1 if failed
+    Int open(Str_I fname);
+    void close();
+    // number of elements
+    Long size() const;
+    // pointer to data
+    const Char *data() const;
+    template <class T>
+    void view(Svector_c<T> &v) const;
+    template <class T>
+    void view(Scmat_c<T> &a) const;
+    ~NpyMap();
+};
+
+inline NpyMap::NpyMap() : m_p(nullptr), m_size(0), m_ind(0), m_mmap(false) {}
+
+inline NpyMap::NpyMap(Str_I fname) : NpyMap()
+{
+    if (open(fname))
+        SLS_ERR("failed to open .npy file: " + fname);
+}
+
+inline Int NpyMap::open(Str_I fname)
+{
+    close();
+    // parse header
+    ifstream fin(fname, std::ios::binary);
+    if (!fin.good())
+        SLS_ERR("file not found: " + fname);
+    if (npy_read_header(fin, descr, fortran, shape))
+        return -1;
+    m_ind = fin.tellg();
+    fin.seekg(0, fin.end);
+    m_size = fin.tellg();
+#ifdef SLS_NPY_MMAP
+    fin.close();
+    int fd = ::open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+        return -1;
+    void *p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        return -1;
+    m_p = (Char *)p; m_mmap = true;
+#else
+    // read the whole file instead
+    m_p = new Char[m_size]; m_mmap = false;
+    fin.seekg(0);
+    fin.read(m_p, m_size);
+#endif
+    return 0;
+}
+
+inline void NpyMap::close()
+{
+    if (m_p) {
+#ifdef SLS_NPY_MMAP
+        if (m_mmap)
+            munmap(m_p, m_size);
+        else
+#endif
+            delete[] m_p;
+    }
+    m_p = nullptr; m_size = 0; m_ind = 0;
+    shape.clear();
+}
+
+inline Long NpyMap::size() const
+{
+    Long N = 1;
+    for (Long i = 0; i < Size(shape); ++i)
+        N *= shape[i];
+    return N;
+}
+
+inline const Char *NpyMap::data() const
+{
+    return m_p + m_ind;
+}
+
+template <class T>
+inline void NpyMap::view(Svector_c<T> &v) const
+{
+    if (descr != npy_descr<T>())
+        SLS_ERR("wrong type: " + descr + ", expecting: " + npy_descr<T>());
+    if (m_ind + size() * (Long)sizeof(T) > m_size)
+        SLS_ERR("file is not complete!");
+    v.set((const T *)data(), size());
+}
+
+template <class T>
+inline void NpyMap::view(Scmat_c<T> &a) const
+{
+    if (descr != npy_descr<T>())
+        SLS_ERR("wrong type: " + descr + ", expecting: " + npy_descr<T>());
+    if (shape.size() != 2)
+        SLS_ERR("wrong dimension!");
+    if (m_ind + size() * (Long)sizeof(T) > m_size)
+        SLS_ERR("file is not complete!");
+    if (fortran)
+        a.set((const T *)data(), shape[0], shape[1]);
+    else
+        a.set((const T *)data(), shape[1], shape[0]);
+}
+
+inline NpyMap::~NpyMap()
+{
+    close();
+}
+
+// === .npz files (zip archive of .npy files) ===
+
+// CRC-32 lookup table (created on the first call, thread-safe)
+class Crc32Table
+{
+public:
+    Uint v[256];
+    Crc32Table()
+    {
+        for (Uint i = 0; i < 256; ++i) {
+            Uint c = i;
+            for (Int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+            v[i] = c;
+        }
+    }
+};
+
+// CRC-32 used by zip
+inline Uint crc32_zip(const Char *p, Long_I N, Uint crc = 0)
+{
+    static const Crc32Table tab;
+    const Uint *table = tab.v;
+    crc = ~crc;
+    for (Long i = 0; i < N; ++i)
+        crc = table[(crc ^ (Uchar)p[i]) & 255] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Npz class, similar to Matt
+class Npz
+{
+public:
+    Char m_rw; // 'r' for read 'w' for write
+    ifstream m_in; // read file
+    ofstream m_out; // write file
+    Str fname; // name of the opened file
+    vector<Str> m_name; // variable names (without ".npy")
+    vector<Long> m_ind; // position of local headers (write), or data (read)
+    vector<Long> m_size; // compressed size
+    vector<Long> m_usize; // uncompressed size
+    vector<Uint> m_crc; // CRC-32
+    vector<Int> m_method; // 0: stored, 8: deflated
+
+    Npz();
+    Npz(Str_I fname, Char_I *rw);
+    // return 0 if successful, -1 if failed
+    Int open(Str_I fname, Char_I *rw);
+    Bool isopen();
+    void close();
+
+    // ===== internal functions =====
+
+    // read the central directory, return 0 if successful
+    Int get_profile();
+    // search a variable by name, return -1 if not found
+    Int search(Str_I name);
+    // write one member
+    void write(Str_I varname, Str_I data);
+    // read one member (uncompressed .npy file)
+    void read(Str_O data, Int_I i);
+
+    template <class T>
+    void write_bin(const T &s);
+    template <class T>
+    void read_bin(T &s);
+
+    ~Npz();
+};
+
+inline Npz::Npz() : m_rw('\0') {}
+
+inline Npz::Npz(Str_I fname, Char_I *rw) : Npz()
+{ open(fname, rw); }
+
+template <class T>
+inline void Npz::write_bin(const T &s)
+{
+    m_out.write((const Char *)&s, sizeof(T));
+}
+
+template <class T>
+inline void Npz::read_bin(T &s)
+{
+    m_in.read((Char *)&s, sizeof(T));
+}
+
+inline Int Npz::open(Str_I fname, Char_I *rw)
+{
+    if (isopen())
+        close();
+    this->fname = fname;
+    if (rw[0] == 'w') {
+        m_rw = 'w';
+        m_out = ofstream(fname, std::ios::binary);
+        if (!m_out.good())
+            SLS_ERR("file not created (directory does not exist ?): " + fname);
+    }
+    else {
+        m_rw = 'r';
+        m_in = ifstream(fname, std::ios::binary);
+        if (!m_in.good())
+            SLS_ERR("file not found: " + fname);
+        return get_profile();
+    }
+    return 0;
+}
+
+inline Bool Npz::isopen()
+{
+    return m_in.is_open() != m_out.is_open();
+}
+
+inline void Npz::close()
+{
+    if (m_rw == 'w') {
+        // central directory
+        Long cd_ind = m_out.tellp();
+        for (Long i = 0; i < Size(m_name); ++i) {
+            Str name = m_name[i] + ".npy";
+            write_bin((Uint)0x02014b50);
+            write_bin((uint16_t)20); write_bin((uint16_t)20); // version
+            write_bin((uint16_t)0); write_bin((uint16_t)0); // flag, method
+            write_bin((uint16_t)0); write_bin((uint16_t)0x21); // time, date
+            write_bin(m_crc[i]);
+            write_bin((Uint)m_size[i]); write_bin((Uint)m_usize[i]);
+            write_bin((uint16_t)name.size());
+            write_bin((uint16_t)0); write_bin((uint16_t)0); // extra, comment
+            write_bin((uint16_t)0); write_bin((uint16_t)0); // disk, internal attr
+            write_bin((Uint)0); // external attr
+            write_bin((Uint)m_ind[i]);
+            m_out.write(name.data(), name.size());
+        }
+        Long cd_size = (Long)m_out.tellp() - cd_ind;
+        // end of central directory
+        write_bin((Uint)0x06054b50);
+        write_bin((uint16_t)0); write_bin((uint16_t)0);
+        write_bin((uint16_t)m_name.size()); write_bin((uint16_t)m_name.size());
+        write_bin((Uint)cd_size); write_bin((Uint)cd_ind);
+        write_bin((uint16_t)0);
+        m_out.close();
+    }
+    else {
+        m_in.close();
+    }
+    m_rw = '\0';
+    m_name.clear(); m_ind.clear(); m_size.clear();
+    m_usize.clear(); m_crc.clear(); m_method.clear();
+}
+
+inline Int Npz::get_profile()
+{
+    ifstream &fin = m_in;
+    fin.seekg(0, fin.end);
+    Long i, j, fsize = fin.tellg();
+    // find end of central directory
+    Long Nsearch = MIN(fsize, (Long)65557);
+    Str tail(Nsearch, '\0');
+    fin.seekg(fsize - Nsearch);
+    fin.read(&tail[0], Nsearch);
+    Long ind = tail.rfind(Str("PK\x05\x06", 4));
+    if (ind < 0)
+        return -1;
+    Long eocd = fsize - Nsearch + ind;
+    uint16_t Nentry; Uint cd_size32, cd_ind32;
+    fin.seekg(eocd + 10); read_bin(Nentry);
+    read_bin(cd_size32); read_bin(cd_ind32);
+    Long N = Nentry, cd_ind = cd_ind32;
+    if (Nentry == 0xFFFF || cd_ind32 == 0xFFFFFFFF) {
+        // zip64 end of central directory
+        Uint sig; Llong eocd64;
+        fin.seekg(eocd - 20); read_bin(sig);
+        if (sig != 0x07064b50) return -1;
+        fin.seekg(eocd - 12); read_bin(eocd64);
+        fin.seekg(eocd64); read_bin(sig);
+        if (sig != 0x06064b50) return -1;
+        Llong temp;
+        fin.seekg(eocd64 + 32); read_bin(temp); N = temp;
+        fin.seekg(eocd64 + 48); read_bin(temp); cd_ind = temp;
+    }
+    // central directory
+    fin.seekg(cd_ind);
+    for (i = 0; i < N; ++i) {
+        Uint sig, crc, size32, usize32, ind32;
+        uint16_t method, Nname, Nextra, Ncomment;
+        read_bin(sig);
+        if (sig != 0x02014b50) return -1;
+        fin.seekg(6, fin.cur); read_bin(method);
+        fin.seekg(4, fin.cur); read_bin(crc);
+        read_bin(size32); read_bin(usize32);
+        read_bin(Nname); read_bin(Nextra); read_bin(Ncomment);
+        fin.seekg(8, fin.cur); read_bin(ind32);
+        Str name(Nname, '\0'), extra(Nextra, '\0');
+        fin.read(&name[0], Nname);
+        if (Nextra > 0)
+            fin.read(&extra[0], Nextra);
+        fin.seekg(Ncomment, fin.cur);
+        Long size = size32, usize = usize32, ind = ind32;
+        // zip64 extra field
+        for (j = 0; j + 4 <= Nextra; ) {
+            uint16_t id, len;
+            memcpy(&id, &extra[j], 2); memcpy(&len, &extra[j + 2], 2);
+            if (id == 1) {
+                Long k = j + 4;
+                Llong temp;
+                if (usize32 == 0xFFFFFFFF) { memcpy(&temp, &extra[k], 8); usize = temp; k += 8; }
+                if (size32 == 0xFFFFFFFF) { memcpy(&temp, &extra[k], 8); size = temp; k += 8; }
+                if (ind32 == 0xFFFFFFFF) { memcpy(&temp, &extra[k], 8); ind = temp; k += 8; }
+            }
+            j += 4 + len;
+        }
+        if (name.size() > 4 && name.substr(name.size() - 4) == ".npy")
+            name.resize(name.size() - 4);
+        m_name.push_back(name); m_ind.push_back(ind);
+        m_size.push_back(size); m_usize.push_back(usize);
+        m_crc.push_back(crc); m_method.push_back(method);
+    }
+    if (!fin.good())
+        return -1;
+    // position of data from local headers
+    for (i = 0; i < N; ++i) {
+        uint16_t Nname, Nextra;
+        fin.seekg(m_ind[i] + 26);
+        read_bin(Nname); read_bin(Nextra);
+        m_ind[i] += 30 + Nname + Nextra;
+    }
+    return fin.good() ? 0 : -1;
+}
+
+inline Int Npz::search(Str_I name)
+{
+    for (Int i = 0; i < Size(m_name); ++i)
+        if (name == m_name[i])
+            return i;
+    SLS_WARN("variable name not found: " + name + ", file : " + fname);
+    return -1;
+}
+
+inline void Npz::write(Str_I varname, Str_I data)
+{
+    if (!m_out.is_open())
+        SLS_ERR("npz file not open: " + fname);
+    Str name = varname + ".npy";
+    Long ind = m_out.tellp();
+    if (ind + Size(data) + Size(name) + 30 > 0xFFFFFFFFL)
+        SLS_ERR(".npz file larger than 4GB is not supported, use .npy files instead!");
+    Uint crc = crc32_zip(data.data(), data.size());
+    // local file header
+    write_bin((Uint)0x04034b50);
+    write_bin((uint16_t)20); write_bin((uint16_t)0); write_bin((uint16_t)0); // version, flag, method
+    write_bin((uint16_t)0); write_bin((uint16_t)0x21); // time, date
+    write_bin(crc);
+    write_bin((Uint)data.size()); write_bin((Uint)data.size());
+    write_bin((uint16_t)name.size()); write_bin((uint16_t)0);
+    m_out.write(name.data(), name.size());
+    m_out.write(data.data(), data.size());
+    m_name.push_back(varname); m_ind.push_back(ind);
+    m_size.push_back(data.size()); m_usize.push_back(data.size());
+    m_crc.push_back(crc); m_method.push_back(0);
+}
+
+inline void Npz::read(Str_O data, Int_I i)
+{
+    data.resize(m_usize[i]);
+    m_in.seekg(m_ind[i]);
+    if (m_method[i] == 0) {
+        if (m_usize[i] > 0)
+            m_in.read(&data[0], m_usize[i]);
+    }
+    else if (m_method[i] == 8) {
+#ifdef SLS_USE_ZLIB
+        Str buf(m_size[i], '\0');
+        m_in.read(&buf[0], m_size[i]);
+        z_stream strm; memset(&strm, 0, sizeof(strm));
+        inflateInit2(&strm, -MAX_WBITS); // raw deflate
+        strm.next_in = (Bytef *)&buf[0]; strm.avail_in = buf.size();
+        strm.next_out = (Bytef *)&data[0]; strm.avail_out = data.size();
+        Int ret = inflate(&strm, Z_FINISH);
+        inflateEnd(&strm);
+        if (ret != Z_STREAM_END)
+            SLS_ERR("corrupted data: " + fname);
+#else
+        SLS_ERR("compressed .npz requires SLS_USE_ZLIB!");
+#endif
+    }
+    else
+        SLS_ERR("unsupported zip compression method!");
+    if (!m_in.good())
+        SLS_ERR("file is not complete: " + fname);
+    if (crc32_zip(data.data(), data.size()) != m_crc[i])
+        SLS_ERR("CRC check failed: " + fname);
+}
+
+inline Npz::~Npz()
+{
+    if (isopen())
+        close();
+}
+
+template <class Tm, SLS_IF(is_dense<Tm>())>
+inline void save(const Tm &a, Str_I varname, Npz_IO npz)
+{
+    std::ostringstream ss;
+    npy_write(ss, a);
+    npz.write(varname, ss.str());
+}
+
+// return 0 if successful, -1 if variable not found
+template <class Tm, SLS_IF(
+    is_Vector<Tm>() || is_Matrix<Tm>() || is_Cmat<Tm>() || is_Mat3d<Tm>() ||
+    is_Cmat3d<Tm>() || is_Cmat4d<Tm>() || is_FixVec<Tm>() || is_FixCmat<Tm>())>
+inline Int load(Tm &a, Str_I varname, Npz_IO npz)
+{
+    Int i = npz.search(varname);
+    if (i < 0)
+        return -1;
+    Str data;
+    npz.read(data, i);
+    std::istringstream ss(data);
+    if (npy_read(a, ss))
+        SLS_ERR("wrong format: " + npz.fname);
+    return 0;
+}
+
+} // namespace slisc
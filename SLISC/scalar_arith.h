@@ -183,4 +183,27 @@ inline Doub factorial(Long_I n) {
     return factorial_imp((Doub)n);
 }
 
+// log of gamma function for complex z, Re(z) > 0
+// shift to |z| >= 10 with recurrence, then use Stirling series (accurate to ~1e-15)
+// imag part is continuous (not reduced to (-pi, pi])
+inline Comp lngamma(Comp_I z)
+{
+    if (real(z) <= 0)
+        SLS_ERR("Re(z) must be positive!");
+    Comp z1 = z, shift = 0;
+    while (abs(z1) < 10) {
+        shift += log(z1);
+        z1 += 1.;
+    }
+    Comp iz = 1. / z1, iz2 = iz * iz;
+    // B_{2k} / (2k (2k-1)), k = 8, 7, ..., 1
+    static const Doub c[8] = { -3617. / 122400., 1. / 156., -691. / 360360., 1. / 1188.,
+        -1. / 1680., 1. / 1260., -1. / 360., 1. / 12. };
+    Comp s = c[0];
+    for (Int i = 1; i < 8; ++i)
+        s = s * iz2 + c[i];
+    s *= iz;
+    return (z1 - 0.5) * log(z1) - z1 + 0.91893853320467274178 + s - shift; // ln(2pi)/2
+}
+
 } // namespace slisc
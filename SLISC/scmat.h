@@ -24,10 +24,10 @@ public:
     template <class Tmat, SLS_IF(is_dense_mat<Tmat>())>
     Scmat & operator=(const Tmat &rhs);
     Scmat & operator=(const T &rhs);
-    template <class T1>
-    Scmat & operator=(const MatCoo<T1> &rhs);
-    template <class T1>
-    Scmat & operator=(const MatCooH<T1> &rhs);
+    template <class T1, class Tind>
+    Scmat & operator=(const MatCoo<T1, Tind> &rhs);
+    template <class T1, class Tind>
+    Scmat & operator=(const MatCooH<T1, Tind> &rhs);
     T& operator()(Long_I i, Long_I j) const; // double indexing
     Long n1() const;
     Long n2() const;
@@ -78,14 +78,14 @@ inline Scmat<T> & Scmat<T>::operator=(const T &rhs)
     vecset(m_p, rhs, m_N);
 }
 
-template <class T> template <class T1>
-inline Scmat<T> & Scmat<T>::operator=(const MatCoo<T1> &rhs)
+template <class T> template <class T1, class Tind>
+inline Scmat<T> & Scmat<T>::operator=(const MatCoo<T1, Tind> &rhs)
 {
     return coo2dense(*this, rhs);
 }
 
-template <class T> template <class T1>
-inline Scmat<T> & Scmat<T>::operator=(const MatCooH<T1> &rhs)
+template <class T> template <class T1, class Tind>
+inline Scmat<T> & Scmat<T>::operator=(const MatCooH<T1, Tind> &rhs)
 {
     return cooh2dense(*this, rhs);
 }
@@ -0,0 +1,228 @@
+// spherical harmonic transform (SHT) between values on an angular grid and coefficients of Y_lm
+// f(theta_i, phi_j) = sum_{l,m} c[ylm_ind(l,m)] * Y_lm(theta_i, phi_j), 0 <= l <= lmax
+// FFT in phi, Gauss-Legendre quadrature in cos(theta), cost O(lmax^3) instead of O(lmax^4)
+// the transform is exact for band limited functions (l <= lmax) with the default grid
+#pragma once
+#include "ylm.h"
+#include "fft.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace slisc {
+
+// Gauss-Legendre abscissas x (descending) and weights w of any order, x in (-1, 1)
+// Newton's method from the asymptotic roots
+// ref: Numerical Recipes 3rd ed., section 4.6 (gauleg)
+inline void GaussLegendre(VecDoub_O x, VecDoub_O w)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (x.size() != w.size())
+        SLS_ERR("wrong shape!");
+#endif
+    Long N = x.size(), N2 = (N + 1) / 2;
+    for (Long i = 0; i < N2; ++i) {
+        Doub z = cos(PI * (i + 0.75) / (N + 0.5)), z1, pp;
+        for (Int it = 0; it < 100; ++it) {
+            Doub p1 = 1, p2 = 0, p3;
+            for (Long j = 0; j < N; ++j) {
+                p3 = p2; p2 = p1;
+                p1 = ((2. * j + 1) * z * p2 - j * p3) / (j + 1);
+            }
+            pp = N * (z * p1 - p2) / (z * z - 1);
+            z1 = z;
+            z = z1 - p1 / pp;
+            if (abs(z - z1) < 1e-15)
+                break;
+        }
+        x[i] = z; x[N - 1 - i] = -z;
+        w[i] = w[N - 1 - i] = 2 / ((1 - z * z) * pp * pp);
+    }
+    if (isodd(N))
+        x[N2 - 1] = 0;
+}
+
+// precomputed grid and Legendre table for sht() and isht()
+// theta (Nth) are Gauss-Legendre points in cos(theta), ascending in theta, Nth >= lmax + 1
+// phi_j = 2pi*j/Nph, Nph is a power of 2 (for fft.h), Nph > 2*lmax
+class ShtPlan
+{
+public:
+    Int lmax;
+    Long Nth, Nph;
+    VecDoub theta, phi;
+    VecDoub wth; // quadrature weights in theta times 2pi/Nph
+    CmatDoub P; // P(i, plm_ind(l,m)) = P_lm(cos(theta[i])), see legendre_norm_table()
+    // Nth = 0 and Nph = 0 gives the smallest grid
+    ShtPlan(Int_I lmax, Long_I Nth = 0, Long_I Nph = 0);
+    // number of coefficients
+    Long size() const { return (Long)(lmax + 1) * (lmax + 1); }
+};
+
+inline ShtPlan::ShtPlan(Int_I lmax_, Long_I Nth_, Long_I Nph_) :
+    lmax(lmax_), Nth(Nth_ ? Nth_ : lmax_ + 1), Nph(Nph_), theta(Nth), phi(0), wth(Nth),
+    P(Nth, plm_ind(lmax_ + 1, 0))
+{
+    if (Nth < lmax + 1)
+        SLS_ERR("Nth too small!");
+    if (Nph == 0)
+        for (Nph = 2; Nph <= 2 * lmax; Nph *= 2);
+    if (Nph <= 2 * lmax || (Nph & (Nph - 1)))
+        SLS_ERR("Nph must be a power of 2 and larger than 2*lmax!");
+    VecDoub x(Nth);
+    GaussLegendre(x, wth);
+    for (Long i = 0; i < Nth; ++i) {
+        theta[i] = acos(x[i]);
+        wth[i] *= 2 * PI / Nph;
+    }
+    phi.resize(Nph);
+    for (Long j = 0; j < Nph; ++j)
+        phi[j] = 2 * PI * j / Nph;
+    legendre_norm_table(P, lmax, theta);
+}
+
+// === internal functions ===
+
+// g(i, lmax+m) = sum_j f(i,j) * exp(-i*m*phi_j), for rows i0 <= i < i1
+inline void sht_fft_rows(CmatComp_O g, MatComp_I f, const ShtPlan &plan, Long_I i0, Long_I i1)
+{
+    Int lmax = plan.lmax; Long Nph = plan.Nph;
+    VecComp row(Nph);
+    for (Long i = i0; i < i1; ++i) {
+        veccpy(row.ptr(), &f(i, 0), Nph);
+        fft(row);
+        for (Int m = -lmax; m <= lmax; ++m)
+            g(i, lmax + m) = row[m < 0 ? Nph + m : m];
+    }
+}
+
+// f(i,j) = sum_m g(i, lmax+m) * exp(i*m*phi_j), for rows i0 <= i < i1
+inline void isht_fft_rows(MatComp_O f, CmatComp_I g, const ShtPlan &plan, Long_I i0, Long_I i1)
+{
+    Int lmax = plan.lmax; Long Nph = plan.Nph;
+    VecComp row(Nph);
+    for (Long i = i0; i < i1; ++i) {
+        row = 0;
+        for (Int m = -lmax; m <= lmax; ++m)
+            row[m < 0 ? Nph + m : m] = g(i, lmax + m);
+        ifft(row);
+        veccpy(&f(i, 0), row.ptr(), Nph);
+    }
+}
+
+// Legendre quadrature for one m (all l), g already multiplied by the weights
+// Y_lm = (-1)^m * P_l|m| * exp(i*m*phi) for m < 0
+inline void sht_legendre_m(VecComp_O c, CmatComp_I g, const ShtPlan &plan, Int_I m)
+{
+    Int lmax = plan.lmax, ma = abs(m); Long Nth = plan.Nth;
+    const Comp *gm = &g(0, lmax + m);
+    Doub sgn = (m < 0 && isodd(ma)) ? -1 : 1;
+    for (Int l = ma; l <= lmax; ++l) {
+        const Doub *p = &plan.P(0, plm_ind(l, ma));
+        Comp s = 0;
+        for (Long i = 0; i < Nth; ++i)
+            s += p[i] * gm[i];
+        c[ylm_ind(l, m)] = sgn * s;
+    }
+}
+
+inline void isht_legendre_m(CmatComp_O g, VecComp_I c, const ShtPlan &plan, Int_I m)
+{
+    Int lmax = plan.lmax, ma = abs(m); Long Nth = plan.Nth;
+    Comp *gm = &g(0, lmax + m);
+    Doub sgn = (m < 0 && isodd(ma)) ? -1 : 1;
+    vecset(gm, Comp(0), Nth);
+    for (Int l = ma; l <= lmax; ++l) {
+        const Doub *p = &plan.P(0, plm_ind(l, ma));
+        Comp cl = sgn * c[ylm_ind(l, m)];
+        for (Long i = 0; i < Nth; ++i)
+            gm[i] += cl * p[i];
+    }
+}
+
+// === user functions ===
+
+// analysis: f(Nth, Nph) on the grid of plan -> coefficients c(plan.size())
+inline void sht(VecComp_O c, MatComp_I f, const ShtPlan &plan)
+{
+    Int lmax = plan.lmax; Long Nth = plan.Nth;
+#ifdef SLS_CHECK_SHAPE
+    if (f.n1() != Nth || f.n2() != plan.Nph || c.size() != plan.size())
+        SLS_ERR("wrong shape!");
+#endif
+    CmatComp g(Nth, 2 * lmax + 1);
+    sht_fft_rows(g, f, plan, 0, Nth);
+    for (Long m = 0; m < g.n2(); ++m)
+        for (Long i = 0; i < Nth; ++i)
+            g(i, m) *= plan.wth[i];
+    for (Int m = -lmax; m <= lmax; ++m)
+        sht_legendre_m(c, g, plan, m);
+}
+
+// synthesis: coefficients c -> f(Nth, Nph) on the grid of plan
+inline void isht(MatComp_O f, VecComp_I c, const ShtPlan &plan)
+{
+    Int lmax = plan.lmax; Long Nth = plan.Nth;
+#ifdef SLS_CHECK_SHAPE
+    if (f.n1() != Nth || f.n2() != plan.Nph || c.size() != plan.size())
+        SLS_ERR("wrong shape!");
+#endif
+    CmatComp g(Nth, 2 * lmax + 1);
+    for (Int m = -lmax; m <= lmax; ++m)
+        isht_legendre_m(g, c, plan, m);
+    isht_fft_rows(f, g, plan, 0, Nth);
+}
+
+// contiguous range [i0, i1) of N rows for the current thread in a parallel region
+inline void sht_thread_rows(Long_O i0, Long_O i1, Long_I N)
+{
+    Long Nthread = 1, ithread = 0;
+#ifdef _OPENMP
+    Nthread = omp_get_num_threads(); ithread = omp_get_thread_num();
+#endif
+    i0 = N * ithread / Nthread; i1 = N * (ithread + 1) / Nthread;
+}
+
+// the FFT of each thread works on one range of rows, so only one work vector per thread
+inline void sht_par(VecComp_O c, MatComp_I f, const ShtPlan &plan)
+{
+    Int lmax = plan.lmax; Long Nth = plan.Nth;
+#ifdef SLS_CHECK_SHAPE
+    if (f.n1() != Nth || f.n2() != plan.Nph || c.size() != plan.size())
+        SLS_ERR("wrong shape!");
+#endif
+    CmatComp g(Nth, 2 * lmax + 1);
+#pragma omp parallel
+    {
+        Long i0, i1;
+        sht_thread_rows(i0, i1, Nth);
+        sht_fft_rows(g, f, plan, i0, i1);
+        for (Long m = 0; m < g.n2(); ++m)
+            for (Long i = i0; i < i1; ++i)
+                g(i, m) *= plan.wth[i];
+    }
+#pragma omp parallel for schedule(dynamic)
+    for (Int m = -lmax; m <= lmax; ++m)
+        sht_legendre_m(c, g, plan, m);
+}
+
+inline void isht_par(MatComp_O f, VecComp_I c, const ShtPlan &plan)
+{
+    Int lmax = plan.lmax; Long Nth = plan.Nth;
+#ifdef SLS_CHECK_SHAPE
+    if (f.n1() != Nth || f.n2() != plan.Nph || c.size() != plan.size())
+        SLS_ERR("wrong shape!");
+#endif
+    CmatComp g(Nth, 2 * lmax + 1);
+#pragma omp parallel for schedule(dynamic)
+    for (Int m = -lmax; m <= lmax; ++m)
+        isht_legendre_m(g, c, plan, m);
+#pragma omp parallel
+    {
+        Long i0, i1;
+        sht_thread_rows(i0, i1, Nth);
+        isht_fft_rows(f, g, plan, i0, i1);
+    }
+}
+
+} // namespace slisc
@@ -14,6 +14,7 @@
 // SLS_USE_CBLAS
 // SLS_USE_LAPACKE
 // SLS_USE_GSL
+// SLS_USE_ZLIB
 // SLS_FP_EXCEPT
 // SLS_USE_UTFCPP
 // SLS_ERR
@@ -43,6 +44,8 @@
 #include "diag.h"
 #include "matcoo.h"
 #include "matcooh.h"
+#include "matcsr.h"
+#include "matsell.h"
 #include "cmatobd.h"
 
 // dense slicing
@@ -71,10 +74,15 @@
 #include "random.h"
 #include "interp1.h"
 #include "lin_eq.h"
+#include "band_lin_eq.h"
+#include "krylov.h"
+#include "eig_jacobi.h"
+#include "eig_batch.h"
+#include "eigs.h"
 #include "eig.h"
-#ifdef SLS_USE_GSL
 #include "ylm.h"
-#endif
+#include "sht.h"
+#include "gaunt.h"
 #include "anglib.h"
 #include "coulomb.h"
 #include "mat_fun.h"
@@ -90,6 +98,8 @@
 #include "input.h"
 #include "file.h"
 #include "matt.h"
+#include "matb.h"
+#include "npy.h"
 #include "disp.h" // see also print.cpp
 #include "time.h"
 
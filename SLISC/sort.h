@@ -159,6 +159,67 @@ template<class T, class U>
 void sort2(vector_IO<T> v, vector_IO<U> v1)
 { sort2_vv(v.data(), v1.data(), v1.size()); }
 
+// stable LSD radix sort of non-negative integers v (v[i] <= vmax), and rearrange v1 at the same time
+// the array is divided into chunks that are counted and scattered in parallel, 8 bits each pass
+template<class T, class U>
+void sort2_radix_vv_par(T *v, U *v1, Long_I N, T vmax)
+{
+    const Int bits = 8;
+    const Long Nbin = 1 << bits;
+    if (N < 2) return;
+    Long Nchunk = MIN(Long(64), (N + 65535) / 65536), chunk = (N + Nchunk - 1) / Nchunk;
+    vector<Long> count(Nchunk * Nbin);
+    vector<T> vbuf(N); vector<U> v1buf(N);
+    T *v_in = v, *v_out = vbuf.data();
+    U *v1_in = v1, *v1_out = v1buf.data();
+    for (Int shift = 0; shift < Int(sizeof(T)*8) && (vmax >> shift) > 0; shift += bits) {
+        // count
+#pragma omp parallel for
+        for (Long c = 0; c < Nchunk; ++c) {
+            Long *cnt = &count[c * Nbin];
+            for (Long b = 0; b < Nbin; ++b)
+                cnt[b] = 0;
+            Long end = MIN(N, (c + 1) * chunk);
+            for (Long i = c * chunk; i < end; ++i)
+                ++cnt[(v_in[i] >> shift) & (Nbin - 1)];
+        }
+        // offsets, skip the pass if all elements are in the same bin
+        Long s = 0, s0, tmp;
+        Bool skip = false;
+        for (Long b = 0; b < Nbin; ++b) {
+            s0 = s;
+            for (Long c = 0; c < Nchunk; ++c) {
+                tmp = count[c * Nbin + b];
+                count[c * Nbin + b] = s; s += tmp;
+            }
+            if (s - s0 == N) skip = true;
+        }
+        if (skip) continue;
+        // scatter
+#pragma omp parallel for
+        for (Long c = 0; c < Nchunk; ++c) {
+            Long *cnt = &count[c * Nbin];
+            Long end = MIN(N, (c + 1) * chunk);
+            for (Long i = c * chunk; i < end; ++i) {
+                Long &k = cnt[(v_in[i] >> shift) & (Nbin - 1)];
+                v_out[k] = v_in[i]; v1_out[k] = v1_in[i];
+                ++k;
+            }
+        }
+        swap(v_in, v_out); swap(v1_in, v1_out);
+    }
+    if (v_in != v) {
+#pragma omp parallel for
+        for (Long i = 0; i < N; ++i) {
+            v[i] = v_in[i]; v1[i] = v1_in[i];
+        }
+    }
+}
+
+template<class T, class U>
+void sort2_radix_par(Vector<T> &v, Vector<U> &v1, T vmax)
+{ sort2_radix_vv_par(v.ptr(), v1.ptr(), v.size(), vmax); }
+
 template<class T>
 void shell(Vector<T> &a, Int m = -1)
 {
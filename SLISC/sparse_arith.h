@@ -3,6 +3,8 @@
 #pragma once
 #include "diag.h"
 #include "matcooh.h"
+#include "matcsr.h"
+#include "matsell.h"
 #include "cmatobd.h"
 #include "ptr_arith.h"
 
@@ -34,22 +36,23 @@ void mul_cmat_diag_cmat(T *c, const T1 *a, const T2 *b, Long_I Nr, Long_I Nc)
     }
 }
 
-template <class T, class Tx, class Ty, SLS_IF(
+// Tind is Int or Long
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
     is_scalar<T>() && is_scalar<Tx>() &&
     is_same<Ty, promo_type<T,Tx>>()
 )>
-void mul_v_coo_v(Ty *y, const Tx *x, const T *a_ij, const Long *i, const Long *j, Long_I Nr, Long_I Nnz)
+void mul_v_coo_v(Ty *y, const Tx *x, const T *a_ij, const Tind *i, const Tind *j, Long_I Nr, Long_I Nnz)
 {
     vecset(y, Ty(), Nr);
     for (Long k = 0; k < Nnz; ++k)
         y[i[k]] += a_ij[k] * x[j[k]];
 }
 
-template <class T, class Tx, class Ty, SLS_IF(
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
     is_scalar<T>() && is_scalar<Tx>() &&
     is_same<Ty, promo_type<T, Tx>>()
 )>
-void mul_v_cooh_v(Ty *y, const Tx *x, const T *a_ij, const Long *i, const Long *j, Long_I Nr, Long_I Nnz)
+void mul_v_cooh_v(Ty *y, const Tx *x, const T *a_ij, const Tind *i, const Tind *j, Long_I Nr, Long_I Nnz)
 {
     vecset(y, Ty(), Nr);
     for (Long k = 0; k < Nnz; ++k) {
@@ -63,52 +66,370 @@ void mul_v_cooh_v(Ty *y, const Tx *x, const T *a_ij, const Long *i, const Long *
     }
 }
 
-// a(blk_size, blk_size, Nblk) is column major
-// overlapped element already divided by 2
-template <class T, class Tx, class Ty, SLS_IF(
+// row[i] is the index of the first element of row i, row[Nr] = Nnz
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
     is_scalar<T>() && is_scalar<Tx>() &&
     is_same<Ty, promo_type<T, Tx>>()
 )>
-void mul_v_cmatobd_v(Ty *y, const Tx *x, const T *a, Long_I blk_size, Long_I Nblk, Long_I N)
+void mul_v_csr_v(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j, Long_I Nr)
+{
+    for (Long i = 0; i < Nr; ++i) {
+        Ty s = 0;
+        for (Long k = row[i]; k < row[i + 1]; ++k)
+            s += a_ij[k] * x[j[k]];
+        y[i] = s;
+    }
+}
+
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_v_csr_v_par(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j, Long_I Nr)
+{
+#pragma omp parallel for schedule(static, 256)
+    for (Long i = 0; i < Nr; ++i) {
+        Ty s = 0;
+        for (Long k = row[i]; k < row[i + 1]; ++k)
+            s += a_ij[k] * x[j[k]];
+        y[i] = s;
+    }
+}
+
+// many vectors at once: y = a * x, x (Nc, Ncol) and y (Nr, Ncol)
+// column major: each row of a is used for all columns while it is in cache
+template <class T, class Tx, class Ty, class Tind>
+void mul_cmat_csr_cmat_rows(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j,
+    Long_I Nr, Long_I Nc, Long_I Ncol, Long_I i0, Long_I i1)
+{
+    for (Long i = i0; i < i1; ++i)
+        for (Long c = 0; c < Ncol; ++c) {
+            const Tx *xc = x + Nc * c;
+            Ty s = 0;
+            for (Long k = row[i]; k < row[i + 1]; ++k)
+                s += a_ij[k] * xc[j[k]];
+            y[i + Nr * c] = s;
+        }
+}
+
+// row major: the inner loop over columns is contiguous (vectorized)
+template <class T, class Tx, class Ty, class Tind>
+void mul_mat_csr_mat_rows(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j,
+    Long_I Ncol, Long_I i0, Long_I i1)
+{
+    for (Long i = i0; i < i1; ++i) {
+        Ty *yi = y + Ncol * i;
+        vecset(yi, Ty(0), Ncol);
+        for (Long k = row[i]; k < row[i + 1]; ++k) {
+            const Tx *xj = x + Ncol * Long(j[k]);
+            T a = a_ij[k];
+            for (Long c = 0; c < Ncol; ++c)
+                yi[c] += a * xj[c];
+        }
+    }
+}
+
+// number of rows in each chunk of the parallel versions
+const Long csr_mat_chunk = 64;
+
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_cmat_csr_cmat(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j,
+    Long_I Nr, Long_I Nc, Long_I Ncol)
+{
+    mul_cmat_csr_cmat_rows(y, x, a_ij, row, j, Nr, Nc, Ncol, 0, Nr);
+}
+
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_cmat_csr_cmat_par(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j,
+    Long_I Nr, Long_I Nc, Long_I Ncol)
+{
+    Long Nchunk = (Nr + csr_mat_chunk - 1) / csr_mat_chunk;
+#pragma omp parallel for
+    for (Long ic = 0; ic < Nchunk; ++ic)
+        mul_cmat_csr_cmat_rows(y, x, a_ij, row, j, Nr, Nc, Ncol,
+            csr_mat_chunk * ic, MIN(csr_mat_chunk * (ic + 1), Nr));
+}
+
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_mat_csr_mat(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j,
+    Long_I Nr, Long_I Ncol)
+{
+    mul_mat_csr_mat_rows(y, x, a_ij, row, j, Ncol, 0, Nr);
+}
+
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_mat_csr_mat_par(Ty *y, const Tx *x, const T *a_ij, const Long *row, const Tind *j,
+    Long_I Nr, Long_I Ncol)
+{
+    Long Nchunk = (Nr + csr_mat_chunk - 1) / csr_mat_chunk;
+#pragma omp parallel for
+    for (Long ic = 0; ic < Nchunk; ++ic)
+        mul_mat_csr_mat_rows(y, x, a_ij, row, j, Ncol,
+            csr_mat_chunk * ic, MIN(csr_mat_chunk * (ic + 1), Nr));
+}
+
+// SELL-C-sigma matrix, see matsell.h
+// the C rows of a slice are computed together, the inner loop is vectorized
+// row sums are kept in a stack buffer, so C rows are done in groups of at most sell_group rows
+// (a single group if the compile-time slice height Cc > 0, then C == Cc is assumed)
+const Long sell_group = 64;
+
+template <Long Cc, class T, class Tx, class Ty, class Tind>
+void mul_v_sell_v_n(Ty *y, const Tx *x, const T *a, const Tind *col, const Long *slice,
+    const Tind *perm, Long_I Nr, Long_I C, Long_I is0, Long_I is1)
+{
+    const Long C1 = Cc > 0 ? Cc : C, Ng = Cc > 0 ? Cc : sell_group;
+    Ty s[Cc > 0 ? Cc : sell_group];
+    for (Long is = is0; is < is1; ++is) {
+        Long width = (slice[is + 1] - slice[is]) / C1;
+        Long i0 = is * C1, Nrow = MIN(C1, Nr - i0);
+        for (Long r0 = 0; r0 < C1; r0 += Ng) {
+            Long Cg = MIN(Ng, C1 - r0);
+            for (Long r = 0; r < Cg; ++r)
+                s[r] = 0;
+            const T *pa = a + slice[is] + r0;
+            const Tind *pc = col + slice[is] + r0;
+            for (Long k = 0; k < width; ++k) {
+#pragma omp simd
+                for (Long r = 0; r < Cg; ++r)
+                    s[r] += pa[r] * x[pc[r]];
+                pa += C1; pc += C1;
+            }
+            for (Long r = 0; r < MIN(Cg, Nrow - r0); ++r)
+                y[perm[i0 + r0 + r]] = s[r];
+        }
+    }
+}
+
+// slices [is0, is1), dispatch to a compile-time slice height (common vector widths)
+template <class T, class Tx, class Ty, class Tind>
+void mul_v_sell_v_slices(Ty *y, const Tx *x, const T *a, const Tind *col, const Long *slice,
+    const Tind *perm, Long_I Nr, Long_I C, Long_I is0, Long_I is1)
+{
+#define SLS_SELL_C_CASE(n) case n: \
+    mul_v_sell_v_n<n>(y, x, a, col, slice, perm, Nr, C, is0, is1); break;
+    switch (C) {
+    SLS_SELL_C_CASE(4) SLS_SELL_C_CASE(8) SLS_SELL_C_CASE(16) SLS_SELL_C_CASE(32)
+    default:
+        mul_v_sell_v_n<0>(y, x, a, col, slice, perm, Nr, C, is0, is1);
+    }
+#undef SLS_SELL_C_CASE
+}
+
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_v_sell_v(Ty *y, const Tx *x, const T *a, const Tind *col, const Long *slice,
+    const Tind *perm, Long_I Nr, Long_I C, Long_I Nslice)
+{
+    mul_v_sell_v_slices(y, x, a, col, slice, perm, Nr, C, 0, Nslice);
+}
+
+// slices are divided into chunks of 16
+template <class T, class Tx, class Ty, class Tind, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_v_sell_v_par(Ty *y, const Tx *x, const T *a, const Tind *col, const Long *slice,
+    const Tind *perm, Long_I Nr, Long_I C, Long_I Nslice)
+{
+    Long Nchunk = (Nslice + 15) / 16;
+#pragma omp parallel for schedule(dynamic)
+    for (Long ic = 0; ic < Nchunk; ++ic)
+        mul_v_sell_v_slices(y, x, a, col, slice, perm, Nr, C, 16 * ic, MIN(16 * (ic + 1), Nslice));
+}
+
+// y[0:N0] += a * x[0:N0], a is an N0 x N0 column major block
+// N0 is a compile-time constant, so the loops are fully unrolled and y is kept in registers
+template <Long N0, class T, class Tx, class Ty>
+inline void mul_v_blk_v(Ty *y, const T *a, const Tx *x)
 {
-    vecset(y, Ty(0), N);
-    Long step = blk_size - 1, step2 = blk_size - 2;
-    a += blk_size + 1; // move to first element
+    Ty s[N0];
+    for (Long i = 0; i < N0; ++i)
+        s[i] = y[i];
+    for (Long j = 0; j < N0; ++j) {
+        Tx xj = x[j];
+        for (Long i = 0; i < N0; ++i)
+            s[i] += a[N0 * j + i] * xj;
+    }
+    for (Long i = 0; i < N0; ++i)
+        y[i] = s[i];
+}
 
-    // first block
-    for (Long j = 0; j < step; ++j) {
-        Tx s = x[j];
-        for (Long i = 0; i < step; ++i) {
-            y[i] += (*a) * s;
-            ++a;
+// multiply blocks [blk0, blk1) of a CmatObd matrix to Ncol columns of x (y += a * x)
+// rows of y owned by the block range are set to 0 first
+// the first row of blk0 is shared with the previous block, its result is added to edge[] instead of y
+// y, x are column major with leading dimension N (matrix size)
+// if N0c > 0, blk_size == N0c is assumed and the full blocks use mul_v_blk_v<N0c>()
+template <Long N0c, class T, class Tx, class Ty>
+void mul_cmat_cmatobd_cmat_blk_n(Ty *y, Ty *edge, const T *a, const Tx *x, Long_I blk_size,
+    Long_I N, Long_I Ncol, Long_I blk0, Long_I blk1)
+{
+    const Long N0 = N0c > 0 ? N0c : blk_size;
+    Long step = N0 - 1, N02 = N0 * N0;
+    Long g0 = blk0 * step, g1 = MIN(blk1 * step, N); // owned rows [g0, g1)
+    for (Long c = 0; c < Ncol; ++c) {
+        vecset(y + N * c + g0, Ty(0), g1 - g0);
+        edge[c] = 0;
+    }
+    for (Long blk = blk0; blk < blk1; ++blk) {
+        const T *pa = a + N02 * blk;
+        Long gs = blk * step - 1; // global index of the first row/column of the block
+        Long k0 = gs < 0 ? 1 : 0, k1 = gs + N0 > N ? N0 - 1 : N0; // valid range in the block
+        Long i0 = (blk == blk0) ? 1 : k0; // first row goes to edge[] for blk0
+        if (N0c > 0 && i0 == 0 && k1 == N0) {
+            for (Long c = 0; c < Ncol; ++c)
+                mul_v_blk_v<(N0c > 0 ? N0c : 1)>(y + N * c + gs, pa, x + N * c + gs);
+            continue;
+        }
+        for (Long c = 0; c < Ncol; ++c) {
+            const Tx *xc = x + N * c + gs;
+            Ty *yc = y + N * c + gs;
+            for (Long j = k0; j < k1; ++j) {
+                const T *pa_j = pa + N0 * j;
+                Tx s = xc[j];
+                if (i0 > k0)
+                    edge[c] += pa_j[0] * s;
+                for (Long i = i0; i < k1; ++i)
+                    yc[i] += pa_j[i] * s;
+            }
         }
-        ++a;
     }
-    x += step2; y += step2; --a;
-
-    // middle blocks
-    for (Long blk = 1; blk < Nblk - 1; ++blk) {
-		for (Long j = 0; j < blk_size; ++j) {
-			Tx s = x[j];
-			for (Long i = 0; i < blk_size; ++i) {
-				y[i] += (*a) * s;
-				++a;
-			}
-		}
-		x += step; y += step;
+}
+
+// dispatch to a compile-time block size (common FEDVR sizes), or the generic kernel
+template <class T, class Tx, class Ty>
+void mul_cmat_cmatobd_cmat_blk(Ty *y, Ty *edge, const T *a, const Tx *x, Long_I blk_size,
+    Long_I N, Long_I Ncol, Long_I blk0, Long_I blk1)
+{
+#define SLS_CMATOBD_BLK_CASE(n) case n: \
+    mul_cmat_cmatobd_cmat_blk_n<n>(y, edge, a, x, blk_size, N, Ncol, blk0, blk1); break;
+    switch (blk_size) {
+    SLS_CMATOBD_BLK_CASE(3) SLS_CMATOBD_BLK_CASE(4) SLS_CMATOBD_BLK_CASE(5)
+    SLS_CMATOBD_BLK_CASE(6) SLS_CMATOBD_BLK_CASE(7) SLS_CMATOBD_BLK_CASE(8)
+    SLS_CMATOBD_BLK_CASE(9) SLS_CMATOBD_BLK_CASE(10) SLS_CMATOBD_BLK_CASE(11)
+    SLS_CMATOBD_BLK_CASE(12) SLS_CMATOBD_BLK_CASE(16)
+    default:
+        mul_cmat_cmatobd_cmat_blk_n<0>(y, edge, a, x, blk_size, N, Ncol, blk0, blk1);
     }
-    
-    // last block
-    for (Long j = 0; j < step; ++j) {
-        Tx s = x[j];
-        for (Long i = 0; i < step; ++i) {
-            y[i] += (*a) * s;
-            ++a;
+#undef SLS_CMATOBD_BLK_CASE
+}
+
+// matrix-vector multiplication, blocks are divided between threads
+// the shared boundary rows are computed separately and added at the end, so no atomic operation is needed
+template <class T, class Tx, class Ty, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_cmat_cmatobd_cmat_par(Ty *y, const T *a, const Tx *x, Long_I blk_size, Long_I Nblk, Long_I N, Long_I Ncol)
+{
+    Long Nchunk = MIN(Nblk, Long(256));
+    vector<Ty> edge(Nchunk * Ncol);
+#pragma omp parallel for
+    for (Long ichunk = 0; ichunk < Nchunk; ++ichunk)
+        mul_cmat_cmatobd_cmat_blk(y, edge.data() + Ncol * ichunk, a, x, blk_size,
+            N, Ncol, Nblk * ichunk / Nchunk, Nblk * (ichunk + 1) / Nchunk);
+    for (Long ichunk = 1; ichunk < Nchunk; ++ichunk) {
+        Long g = (Nblk * ichunk / Nchunk) * (blk_size - 1) - 1;
+        for (Long c = 0; c < Ncol; ++c)
+            y[N * c + g] += edge[Ncol * ichunk + c];
+    }
+}
+
+template <class T, class Tx, class Ty, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_cmat_cmatobd_cmat(Ty *y, const T *a, const Tx *x, Long_I blk_size, Long_I Nblk, Long_I N, Long_I Ncol)
+{
+    vector<Ty> edge(Ncol);
+    mul_cmat_cmatobd_cmat_blk(y, edge.data(), a, x, blk_size, N, Ncol, 0, Nblk);
+}
+
+// number of rows in each chunk of mul_cmat_cmatobd_mid_add(), so that the columns stay in L1 cache
+const Long cmatobd_mid_chunk = 64;
+
+// y(m, i, k) += sum_j a(i, j) * x(m, j, k) for one k and rows [m0, m1)
+// i.e. a CmatObd matrix a (N x N) is applied to the middle index of x, y (M, N, K) (column major)
+// pointers x, y are already shifted to the k-th slice
+template <class T, class Tx, class Ty>
+void mul_cmat_cmatobd_mid_add1(Ty *y, const T *a, const Tx *x, Long_I blk_size, Long_I Nblk,
+    Long_I M, Long_I N, Long_I m0, Long_I m1)
+{
+    Long N0 = blk_size, step = N0 - 1, N02 = N0 * N0;
+    for (Long blk = 0; blk < Nblk; ++blk) {
+        const T *pa = a + N02 * blk;
+        Long gs = blk * step - 1; // global index of the first row/column of the block
+        Long k0 = gs < 0 ? 1 : 0, k1 = gs + N0 > N ? N0 - 1 : N0; // valid range in the block
+        for (Long j = k0; j < k1; ++j) {
+            const Tx *xj = x + M * (gs + j);
+            for (Long i = k0; i < k1; ++i) {
+                T aij = pa[i + N0 * j];
+                if (aij == T(0))
+                    continue; // skip zero entries of the block
+                Ty *yi = y + M * (gs + i);
+                for (Long m = m0; m < m1; ++m)
+                    yi[m] += aij * xj[m];
+            }
         }
-        ++a;
     }
 }
 
+template <class T, class Tx, class Ty, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_promo<Ty, promo_type<T, Tx>>()
+)>
+void mul_cmat_cmatobd_mid_add(Ty *y, const T *a, const Tx *x, Long_I blk_size, Long_I Nblk,
+    Long_I M, Long_I N, Long_I K)
+{
+    for (Long k = 0; k < K; ++k)
+        for (Long m0 = 0; m0 < M; m0 += cmatobd_mid_chunk)
+            mul_cmat_cmatobd_mid_add1(y + M * N * k, a, x + M * N * k, blk_size, Nblk,
+                M, N, m0, MIN(m0 + cmatobd_mid_chunk, M));
+}
+
+// each thread owns different rows, no atomic operation is needed
+template <class T, class Tx, class Ty, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_promo<Ty, promo_type<T, Tx>>()
+)>
+void mul_cmat_cmatobd_mid_add_par(Ty *y, const T *a, const Tx *x, Long_I blk_size, Long_I Nblk,
+    Long_I M, Long_I N, Long_I K)
+{
+    Long Nchunk = (M + cmatobd_mid_chunk - 1) / cmatobd_mid_chunk;
+#pragma omp parallel for
+    for (Long u = 0; u < K * Nchunk; ++u) {
+        Long k = u / Nchunk, m0 = cmatobd_mid_chunk * (u % Nchunk);
+        mul_cmat_cmatobd_mid_add1(y + M * N * k, a, x + M * N * k, blk_size, Nblk,
+            M, N, m0, MIN(m0 + cmatobd_mid_chunk, M));
+    }
+}
+
+// a(blk_size, blk_size, Nblk) is column major
+// overlapped element already divided by 2
+template <class T, class Tx, class Ty, SLS_IF(
+    is_scalar<T>() && is_scalar<Tx>() &&
+    is_same<Ty, promo_type<T, Tx>>()
+)>
+void mul_v_cmatobd_v(Ty *y, const Tx *x, const T *a, Long_I blk_size, Long_I Nblk, Long_I N)
+{
+    Ty edge;
+    mul_cmat_cmatobd_cmat_blk(y, &edge, a, x, blk_size, N, 1, 0, Nblk);
+}
+
 template <class Tx, class Ty, class Ta, SLS_IF(
     is_dense_vec<Tx>() && is_dense_vec<Ty>() && is_CmatObd<Ta>())>
 void mul(Ty &y, const Ta &a, const Tx &x)
@@ -120,6 +441,42 @@ void mul(Ty &y, const Ta &a, const Tx &x)
     mul_v_cmatobd_v(y.ptr(), x.ptr(), a.ptr(), a.n0(), a.nblk(), a.n1());
 }
 
+template <class Tx, class Ty, class Ta, SLS_IF(
+    is_dense_vec<Tx>() && is_dense_vec<Ty>() && is_CmatObd<Ta>())>
+void mul_par(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (y.size() != a.n1() || x.size() != a.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_cmat_cmatobd_cmat_par(y.ptr(), a.ptr(), x.ptr(), a.n0(), a.nblk(), a.n1(), 1);
+}
+
+// multiply to each column of x
+template <class Tx, class Ty, class Ta, SLS_IF(
+    is_dense_mat<Tx>() && is_cmajor<Tx>() && is_dense_mat<Ty>() && is_cmajor<Ty>() &&
+    is_CmatObd<Ta>())>
+void mul(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (y.n1() != a.n1() || x.n1() != a.n2() || y.n2() != x.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_cmat_cmatobd_cmat(y.ptr(), a.ptr(), x.ptr(), a.n0(), a.nblk(), a.n1(), x.n2());
+}
+
+template <class Tx, class Ty, class Ta, SLS_IF(
+    is_dense_mat<Tx>() && is_cmajor<Tx>() && is_dense_mat<Ty>() && is_cmajor<Ty>() &&
+    is_CmatObd<Ta>())>
+void mul_par(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (y.n1() != a.n1() || x.n1() != a.n2() || y.n2() != x.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_cmat_cmatobd_cmat_par(y.ptr(), a.ptr(), x.ptr(), a.n0(), a.nblk(), a.n1(), x.n2());
+}
+
 // arithmetics
 
 template <class T, class Ts, SLS_IF(
@@ -176,10 +533,10 @@ inline void operator-=(T &v, const T1 &v1)
 }
 
 // infinite norm (maximum absolute sum of rows)
-template <class T, SLS_IF(
+template <class T, class Tind, SLS_IF(
     type_num<T>() >= 20
 )>
-inline rm_comp<T> norm_inf(const MatCoo<T> &A)
+inline rm_comp<T> norm_inf(const MatCoo<T, Tind> &A)
 {
     Vector<rm_comp<T>> abs_sum(A.n1(), 0.);
     for (Long i = 0; i < A.nnz(); ++i) {
@@ -188,10 +545,10 @@ inline rm_comp<T> norm_inf(const MatCoo<T> &A)
     return max(abs_sum);
 }
 
-template <class T, SLS_IF(
+template <class T, class Tind, SLS_IF(
     type_num<T>() >= 20
 )>
-inline rm_comp<T> norm_inf(const MatCooH<T> &A)
+inline rm_comp<T> norm_inf(const MatCooH<T, Tind> &A)
 {
     Vector<rm_comp<T>> abs_sum(A.n1(), 0.);
     for (Long i = 0; i < A.nnz(); ++i) {
@@ -204,38 +561,57 @@ inline rm_comp<T> norm_inf(const MatCooH<T> &A)
     return max(abs_sum);
 }
 
-// (using maximum absolute sum of columns)
-template <class T, SLS_IF(is_scalar<T>())>
-inline rm_comp<T> norm_inf(const CmatObd<T> &A)
+// maximum absolute sum of columns of a CmatObd matrix, see mul_cmat_cmatobd_cmat_blk_n()
+template <Long N0c, class T>
+inline rm_comp<T> norm_inf_cmatobd_n(const CmatObd<T> &A)
 {
-    Long N0 = A.n0(), N1 = N0 - 1, Nblk = A.nblk();
+    const Long N0 = N0c > 0 ? N0c : A.n0();
+    Long step = N0 - 1, N02 = N0 * N0, N = A.n1(), Nblk = A.nblk();
     Vector<rm_comp<T>> abs_sum(A.n2(), 0.);
-    Long k = 0;
-    Svector_c<T> sli(A.ptr() + N0 + 1, N1);
-    // first block
-    for (Long j = 1; j < N0; ++j) {
-        abs_sum[k] += sum_abs(sli);
-        ++k; sli.shift(N0);
-    }
-    --k;
-    // middle blocks
-    sli.set_size(N0); sli.shift(-1);
-    for (Long blk = 1; blk < Nblk - 1; ++blk) {
-        for (Long j = 0; j < N0; ++j) {
-            abs_sum[k] += sum_abs(sli);
-            ++k; sli.next();
+    for (Long blk = 0; blk < Nblk; ++blk) {
+        const T *pa = A.ptr() + N02 * blk;
+        Long gs = blk * step - 1; // global index of the first row/column of the block
+        Long k0 = gs < 0 ? 1 : 0, k1 = gs + N0 > N ? N0 - 1 : N0; // valid range in the block
+        rm_comp<T> *ps = abs_sum.ptr() + gs;
+        if (N0c > 0 && k0 == 0 && k1 == N0) {
+            for (Long j = 0; j < N0; ++j) {
+                rm_comp<T> s = 0;
+                for (Long i = 0; i < N0; ++i)
+                    s += abs(pa[N0 * j + i]);
+                ps[j] += s;
+            }
+            continue;
+        }
+        for (Long j = k0; j < k1; ++j) {
+            rm_comp<T> s = 0;
+            for (Long i = k0; i < k1; ++i)
+                s += abs(pa[N0 * j + i]);
+            ps[j] += s;
         }
-        --k;
-    }
-    // last block
-    sli.set_size(N1);
-    for (Long j = 0; j < N1; ++j) {
-        abs_sum[k] += sum_abs(sli);
-        ++k; sli.shift(N0);
     }
     return max(abs_sum);
 }
 
+// (using maximum absolute sum of columns)
+template <class T, SLS_IF(is_scalar<T>())>
+inline rm_comp<T> norm_inf(const CmatObd<T> &A)
+{
+    switch (A.n0()) {
+    case 3: return norm_inf_cmatobd_n<3>(A);
+    case 4: return norm_inf_cmatobd_n<4>(A);
+    case 5: return norm_inf_cmatobd_n<5>(A);
+    case 6: return norm_inf_cmatobd_n<6>(A);
+    case 7: return norm_inf_cmatobd_n<7>(A);
+    case 8: return norm_inf_cmatobd_n<8>(A);
+    case 9: return norm_inf_cmatobd_n<9>(A);
+    case 10: return norm_inf_cmatobd_n<10>(A);
+    case 11: return norm_inf_cmatobd_n<11>(A);
+    case 12: return norm_inf_cmatobd_n<12>(A);
+    case 16: return norm_inf_cmatobd_n<16>(A);
+    default: return norm_inf_cmatobd_n<0>(A);
+    }
+}
+
 // matrix vector multiplication
 
 template <class Ta, class Tx, class Ty, SLS_IF(
@@ -256,11 +632,111 @@ template <class Ta, class Tx, class Ty, SLS_IF(
 void mul(Ty &y, const Ta &a, const Tx &x)
 {
 #ifdef SLS_CHECK_SHAPE
-    if (a.n2() != x.size() || a.rows() != y.size()) SLS_ERR("wrong shape!");
+    if (a.n2() != x.size() || a.n1() != y.size()) SLS_ERR("wrong shape!");
 #endif
     mul_v_cooh_v(y.ptr(), x.ptr(), a.ptr(), a.row_ptr(), a.col_ptr(), a.n1(), a.nnz());
 }
 
+template <class Ta, class Tx, class Ty, SLS_IF(
+    is_dense_vec<Ty>() && is_MatCsr<Ta>() && is_dense_vec<Tx>()
+)>
+void mul(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.size() || a.n1() != y.size())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_v_csr_v(y.ptr(), x.ptr(), a.ptr(), a.row_ptr(), a.col_ptr(), a.n1());
+}
+
+template <class Ta, class Tx, class Ty, SLS_IF(
+    is_dense_vec<Ty>() && is_MatCsr<Ta>() && is_dense_vec<Tx>()
+)>
+void mul_par(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.size() || a.n1() != y.size())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_v_csr_v_par(y.ptr(), x.ptr(), a.ptr(), a.row_ptr(), a.col_ptr(), a.n1());
+}
+
+// multiply to each column of x
+template <class Ty, class Ta, class Tx, SLS_IF(
+    is_dense_mat<Ty>() && is_cmajor<Ty>() && is_MatCsr<Ta>() && is_dense_mat<Tx>() && is_cmajor<Tx>()
+)>
+void mul(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.n1() || a.n1() != y.n1() || x.n2() != y.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_cmat_csr_cmat(y.ptr(), x.ptr(), a.ptr(), a.row_ptr(), a.col_ptr(), a.n1(), a.n2(), x.n2());
+}
+
+template <class Ty, class Ta, class Tx, SLS_IF(
+    is_dense_mat<Ty>() && is_cmajor<Ty>() && is_MatCsr<Ta>() && is_dense_mat<Tx>() && is_cmajor<Tx>()
+)>
+void mul_par(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.n1() || a.n1() != y.n1() || x.n2() != y.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_cmat_csr_cmat_par(y.ptr(), x.ptr(), a.ptr(), a.row_ptr(), a.col_ptr(), a.n1(), a.n2(), x.n2());
+}
+
+// row major x and y are faster for many columns
+template <class Ty, class Ta, class Tx, SLS_IF(
+    is_dense_mat<Ty>() && is_rmajor<Ty>() && is_MatCsr<Ta>() && is_dense_mat<Tx>() && is_rmajor<Tx>()
+)>
+void mul(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.n1() || a.n1() != y.n1() || x.n2() != y.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_mat_csr_mat(y.ptr(), x.ptr(), a.ptr(), a.row_ptr(), a.col_ptr(), a.n1(), x.n2());
+}
+
+template <class Ty, class Ta, class Tx, SLS_IF(
+    is_dense_mat<Ty>() && is_rmajor<Ty>() && is_MatCsr<Ta>() && is_dense_mat<Tx>() && is_rmajor<Tx>()
+)>
+void mul_par(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.n1() || a.n1() != y.n1() || x.n2() != y.n2())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_mat_csr_mat_par(y.ptr(), x.ptr(), a.ptr(), a.row_ptr(), a.col_ptr(), a.n1(), x.n2());
+}
+
+template <class Ta, class Tx, class Ty, SLS_IF(
+    is_dense_vec<Ty>() && is_MatSell<Ta>() && is_dense_vec<Tx>()
+)>
+void mul(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.size() || a.n1() != y.size())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_v_sell_v(y.ptr(), x.ptr(), a.ptr(), a.col_ptr(), a.slice_ptr(), a.perm_ptr(),
+        a.n1(), a.C(), a.nslice());
+}
+
+template <class Ta, class Tx, class Ty, SLS_IF(
+    is_dense_vec<Ty>() && is_MatSell<Ta>() && is_dense_vec<Tx>()
+)>
+void mul_par(Ty &y, const Ta &a, const Tx &x)
+{
+#ifdef SLS_CHECK_SHAPE
+    if (a.n2() != x.size() || a.n1() != y.size())
+        SLS_ERR("wrong shape!");
+#endif
+    mul_v_sell_v_par(y.ptr(), x.ptr(), a.ptr(), a.col_ptr(), a.slice_ptr(), a.perm_ptr(),
+        a.n1(), a.C(), a.nslice());
+}
+
 // matrix matrix multiplication
 
 // mul(Cmat, Cmat, Diag)
@@ -293,4 +769,37 @@ void mul(T &c, const T1 &a, const T2 &b)
     mul_cmat_diag_cmat(c.ptr(), a.ptr(), b.ptr(), b.n1(), b.n2());
 }
 
+// matrix / vector multiplication (y = a * x) for raw pointers
+// this is the interface used by matrix-free algorithms such as ZGEXPV(), ZHEXPV() and the Krylov solvers
+template <class T1, class Tind, class T2, SLS_IF(is_promo<T2, T1>())>
+void mul(T2 *y, const MatCoo<T1, Tind> &a, T2 *x)
+{
+    mul_v_coo_v(y, x, a.ptr(), a.row_ptr(), a.col_ptr(), a.n1(), a.nnz());
+}
+
+template <class T1, class Tind, class T2, SLS_IF(is_promo<T2, T1>())>
+void mul(T2 *y, const MatCooH<T1, Tind> &a, T2 *x)
+{
+    mul_v_cooh_v(y, x, a.ptr(), a.row_ptr(), a.col_ptr(), a.n1(), a.nnz());
+}
+
+template <class T1, class Tind, class T2, SLS_IF(is_promo<T2, T1>())>
+void mul(T2 *y, const MatCsr<T1, Tind> &a, T2 *x)
+{
+    mul_v_csr_v_par(y, x, a.ptr(), a.row_ptr(), a.col_ptr(), a.n1());
+}
+
+template <class T1, class Tind, class T2, SLS_IF(is_promo<T2, T1>())>
+void mul(T2 *y, const MatSell<T1, Tind> &a, T2 *x)
+{
+    mul_v_sell_v_par(y, x, a.ptr(), a.col_ptr(), a.slice_ptr(), a.perm_ptr(),
+        a.n1(), a.C(), a.nslice());
+}
+
+template <class T1, class T2, SLS_IF(is_promo<T2, T1>())>
+void mul(T2 *y, const CmatObd<T1> &a, T2 *x)
+{
+    mul_v_cmatobd_v(y, x, a.ptr(), a.n0(), a.nblk(), a.n1());
+}
+
 } // namespace slisc
@@ -1,49 +1,198 @@
 // calculate spherical harmonics Y_{lm}(\theta,\phi) and coupled spherical harmonics
+// uses the stable recurrence of normalized associated Legendre functions, no factorial is needed
 #pragma once
 #include "scalar_arith.h"
 #include "anglib.h"
-#ifdef SLS_USE_GSL
-#include <gsl/gsl_sf_legendre.h>
-#include <gsl/gsl_sf_coupling.h>
-#endif
+#include "cmat.h"
+#include "copy.h"
 
 namespace slisc {
 
-// same definition with Wolfram Alpha
-// see http://littleshi.cn/online/SphHar.html
-#ifdef SLS_USE_GSL
-Comp ylm(Int_I l, Int_I m, Doub_I theta, Doub_I phi)
+// normalized associated Legendre functions (with Condon-Shortley phase), Y_lm = P_lm(cos(theta)) * exp(i*m*phi)
+// P_mm = -sqrt((2m+1)/(2m)) * sin(theta) * P_{m-1,m-1}, P_00 = 1/sqrt(4pi)
+// P_{m+1,m} = sqrt(2m+3) * cos(theta) * P_mm
+// P_lm = a_lm * (cos(theta) * P_{l-1,m} - b_lm * P_{l-2,m})
+inline Doub legendre_norm_a(Int_I l, Int_I m)
+{
+    return sqrt((4. * l * l - 1) / ((Doub)l * l - (Doub)m * m));
+}
+
+inline Doub legendre_norm_b(Int_I l, Int_I m)
+{
+    return sqrt(((l - 1.) * (l - 1.) - (Doub)m * m) / (4. * (l - 1.) * (l - 1.) - 1));
+}
+
+// index of (l, m) in a table of all Y_lm, l = 0, 1, ..., -l <= m <= l
+inline Long ylm_ind(Int_I l, Int_I m) { return (Long)l * l + l + m; }
+
+// index of (l, m) in a table of P_lm, m >= 0
+inline Long plm_ind(Int_I l, Int_I m) { return (Long)l * (l + 1) / 2 + m; }
+
+// reduce theta to [0, pi] and phi to [0, 2pi)
+inline void ylm_angle(Doub_O th, Doub_O ph, Doub_I theta, Doub_I phi)
 {
-    Doub A, ret0;
     Long n;
-    Doub th = mod(n, theta, 2 * PI);
-    Doub ph;
+    th = mod(n, theta, 2 * PI);
     if (th > PI) {
         th = 2 * PI - th;
         ph = mod(n, phi + PI, 2 * PI);
     }
     else
         ph = mod(n, phi, 2 * PI);
+}
 
-    if (m >= 0) {
-        A = sqrt((2 * l + 1)*factorial(l - m) / (4 * PI * factorial(l + m)));
-        ret0 = A * gsl_sf_legendre_Plm(l, m, cos(th));
+// normalized P_lm(cos(theta)), 0 <= m <= l, theta in [0, pi]
+inline Doub legendre_norm(Int_I l, Int_I m, Doub_I theta)
+{
+    Doub x = cos(theta), s = sin(theta);
+    Doub p = 0.28209479177387814347; // 1/sqrt(4pi)
+    for (Int i = 1; i <= m; ++i)
+        p *= -sqrt((2. * i + 1) / (2. * i)) * s;
+    if (l == m)
+        return p;
+    Doub p1 = sqrt(2. * m + 3) * x * p, p2;
+    for (Int i = m + 2; i <= l; ++i) {
+        p2 = p; p = p1;
+        p1 = legendre_norm_a(i, m) * (x * p - legendre_norm_b(i, m) * p2);
     }
-    else {
-        A = pow(-1, m) * sqrt((2 * l + 1)*factorial(l + m) / (4 * PI * factorial(l - m)));
-        ret0 = A * gsl_sf_legendre_Plm(l, -m, cos(th));
+    return p1;
+}
+
+// same definition with Wolfram Alpha
+// see http://littleshi.cn/online/SphHar.html
+inline Comp ylm(Int_I l, Int_I m, Doub_I theta, Doub_I phi)
+{
+    Doub th, ph;
+    ylm_angle(th, ph, theta, phi);
+    Int ma = abs(m);
+    Doub ret0 = legendre_norm(l, ma, th);
+    if (m < 0 && isodd(ma))
+        ret0 = -ret0;
+    if (m != 0)
+        return ret0 * exp(Comp(0., m*ph));
+    return ret0;
+}
+
+// P(i, plm_ind(l,m)) = P_lm(cos(theta[i])), 0 <= m <= l <= lmax
+// theta in [0, pi], each column is a contiguous (vectorizable) loop over angles
+inline void legendre_norm_table(CmatDoub_O P, Int_I lmax, VecDoub_I theta)
+{
+    Long N = theta.size();
+#ifdef SLS_CHECK_SHAPE
+    if (P.n1() != N || P.n2() != plm_ind(lmax + 1, 0))
+        SLS_ERR("wrong shape!");
+#endif
+    VecDoub x(N), s(N), pmm(N);
+    for (Long i = 0; i < N; ++i) {
+        x[i] = cos(theta[i]); s[i] = sin(theta[i]);
+        pmm[i] = 0.28209479177387814347;
+    }
+    for (Int m = 0; m <= lmax; ++m) {
+        if (m > 0) {
+            Doub c = -sqrt((2. * m + 1) / (2. * m));
+            for (Long i = 0; i < N; ++i)
+                pmm[i] *= c * s[i];
+        }
+        Doub *p = &P(0, plm_ind(m, m));
+        veccpy(p, pmm.ptr(), N);
+        if (m == lmax)
+            break;
+        Doub *p1 = &P(0, plm_ind(m + 1, m)), c = sqrt(2. * m + 3);
+        for (Long i = 0; i < N; ++i)
+            p1[i] = c * x[i] * p[i];
+        for (Int l = m + 2; l <= lmax; ++l) {
+            const Doub *p_1 = &P(0, plm_ind(l - 1, m)), *p_2 = &P(0, plm_ind(l - 2, m));
+            Doub *pl = &P(0, plm_ind(l, m));
+            Doub a = legendre_norm_a(l, m), b = legendre_norm_b(l, m);
+            for (Long i = 0; i < N; ++i)
+                pl[i] = a * (x[i] * p_1[i] - b * p_2[i]);
+        }
     }
+}
+
+// number of angles in each chunk of ylm_table_par()
+const Long ylm_chunk = 64;
 
-    if (m != 0) {
-        Comp ret = ret0 * exp(Comp(0., m*ph));
-        return ret;
+// Y(ylm_ind(l,m), i) = Y_lm(theta[i], phi[i]), 0 <= l <= lmax, -l <= m <= l
+// for each chunk of angles, the recurrence is vectorized over angles
+inline void ylm_table_chunk(CmatComp_O Y, Int_I lmax, const Doub *theta, const Doub *phi, Long_I i0, Long_I N)
+{
+    Doub x[ylm_chunk], s[ylm_chunk], pmm[ylm_chunk], p2[ylm_chunk], p1[ylm_chunk], p[ylm_chunk];
+    Comp eiph[ylm_chunk], eimph[ylm_chunk];
+    for (Long i = 0; i < N; ++i) {
+        Doub th, ph;
+        ylm_angle(th, ph, theta[i], phi[i]);
+        x[i] = cos(th); s[i] = sin(th);
+        eiph[i] = Comp(cos(ph), sin(ph)); eimph[i] = 1;
+        pmm[i] = 0.28209479177387814347;
+    }
+    Long Nr = Y.n1();
+    Comp *py = Y.ptr() + Nr * i0;
+    for (Int m = 0; m <= lmax; ++m) {
+        if (m > 0) {
+            Doub c = -sqrt((2. * m + 1) / (2. * m));
+            for (Long i = 0; i < N; ++i) {
+                pmm[i] *= c * s[i];
+                eimph[i] *= eiph[i];
+            }
+        }
+        Doub sgn = isodd(m) ? -1 : 1; // Y_{l,-m} = (-1)^m conj(Y_lm)
+        for (Int l = m; l <= lmax; ++l) {
+            if (l == m)
+                veccpy(p, pmm, N);
+            else if (l == m + 1) {
+                Doub c = sqrt(2. * m + 3);
+                for (Long i = 0; i < N; ++i) {
+                    p2[i] = pmm[i];
+                    p[i] = c * x[i] * pmm[i];
+                }
+            }
+            else {
+                Doub a = legendre_norm_a(l, m), b = legendre_norm_b(l, m);
+                for (Long i = 0; i < N; ++i) {
+                    Doub t = a * (x[i] * p1[i] - b * p2[i]);
+                    p2[i] = p1[i]; p[i] = t;
+                }
+            }
+            veccpy(p1, p, N);
+            Long k = ylm_ind(l, m), k1 = ylm_ind(l, -m);
+            for (Long i = 0; i < N; ++i) {
+                Comp y = p[i] * eimph[i];
+                py[k + Nr * i] = y;
+                py[k1 + Nr * i] = sgn * conj(y);
+            }
+        }
     }
-    return ret0;
 }
+
+// Y(ylm_ind(l,m), i) = Y_lm(theta[i], phi[i]), Y is ((lmax+1)^2, N)
+inline void ylm_table(CmatComp_O Y, Int_I lmax, VecDoub_I theta, VecDoub_I phi)
+{
+    Long N = theta.size();
+#ifdef SLS_CHECK_SHAPE
+    if (phi.size() != N || Y.n1() != ylm_ind(lmax + 1, -lmax - 1) || Y.n2() != N)
+        SLS_ERR("wrong shape!");
 #endif
+    for (Long i0 = 0; i0 < N; i0 += ylm_chunk)
+        ylm_table_chunk(Y, lmax, theta.ptr() + i0, phi.ptr() + i0, i0, MIN(ylm_chunk, N - i0));
+}
+
+inline void ylm_table_par(CmatComp_O Y, Int_I lmax, VecDoub_I theta, VecDoub_I phi)
+{
+    Long N = theta.size(), Nchunk = (N + ylm_chunk - 1) / ylm_chunk;
+#ifdef SLS_CHECK_SHAPE
+    if (phi.size() != N || Y.n1() != ylm_ind(lmax + 1, -lmax - 1) || Y.n2() != N)
+        SLS_ERR("wrong shape!");
+#endif
+#pragma omp parallel for
+    for (Long k = 0; k < Nchunk; ++k) {
+        Long i0 = ylm_chunk * k;
+        ylm_table_chunk(Y, lmax, theta.ptr() + i0, phi.ptr() + i0, i0, MIN(ylm_chunk, N - i0));
+    }
+}
 
 // generalized spherical harmonics
-Comp yl1l2LM(Int_I l1, Int_I l2, Int_I L, Int_I M,
+inline Comp yl1l2LM(Int_I l1, Int_I l2, Int_I L, Int_I M,
     Doub_I theta1, Doub_I phi1, Doub_I theta2, Doub_I phi2)
 {
     Comp sum = 0.;
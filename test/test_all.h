@@ -13,6 +13,8 @@ void print(slisc::Cmat3Comp_I v, slisc::Long_I i, slisc::Long_I n1, slisc::Long_
 #include "test_fixsize.h"
 #include "test_sparse.h"
 #include "test_cmatobd.h"
+#include "test_krylov.h"
+#include "test_eigs.h"
 #include "test_interp1.h"
 #include "test_fft.h"
 #include "test_random.h"
@@ -21,24 +23,26 @@ void print(slisc::Cmat3Comp_I v, slisc::Long_I i, slisc::Long_I n1, slisc::Long_
 //#include "test_eigen_linsolve.h"
 //#include "test_eigen_fft.h"
 #include "test_time.h"
-#ifdef SLS_USE_GSL
 #include "test_ylm.h"
-#endif
+#include "test_sht.h"
+#include "test_gaunt.h"
 #include "test_coulomb.h"
 #include "test_input.h"
 #include "test_disp.h"
 #include "test_print.h"
 
-#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
 #include "test_lin_eq.h"
+#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
 #include "test_eig.h"
 #include "test_mat_fun.h"
 #include "test_expokit.h"
-#include "test_fedvr.h"
 #endif
+#include "test_fedvr.h"
 
 #include "test_except.h"
 #include "test_mattsave.h"
+#include "test_matb.h"
+#include "test_npy.h"
 #include "test_anglib.h"
 #ifdef SLS_USE_GSL
 #include "test_gsl.h"
@@ -75,18 +79,22 @@ inline void test_all()
     test_sparse();
     cout << "test_cmatobd()" << endl;
     test_cmatobd();
-#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
-	cout << "test_lin_eq()" << endl;
+    cout << "test_krylov()" << endl;
+    test_krylov();
+    cout << "test_eigs()" << endl;
+    test_eigs();
+    cout << "test_lin_eq()" << endl;
     test_lin_eq();
+#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
     cout << "test_eig()" << endl;
     test_eig();
     cout << "test_mat_fun()" << endl;
     test_mat_fun();
     cout << "test_expokit()" << endl;
     test_expokit();
+#endif
     cout << "test_fedvr()" << endl;
     test_fedvr();
-#endif
     cout << "test_interp1()" << endl;
     test_interp1();
     cout << "test_fft()" << endl;
@@ -101,14 +109,20 @@ inline void test_all()
     test_tree();
     cout << "test_time()" << endl;
     test_time();
-#ifdef SLS_USE_GSL
     cout << "test_ylm()" << endl;
     test_ylm();
-#endif
+    cout << "test_sht()" << endl;
+    test_sht();
+    cout << "test_gaunt()" << endl;
+    test_gaunt();
     cout << "test_coulomb()" << endl;
     test_coulomb();
     cout << "test_mattsave()" << endl;
     test_mattsave();
+    cout << "test_matb()" << endl;
+    test_matb();
+    cout << "test_npy()" << endl;
+    test_npy();
     cout << "test_anglib()" << endl;
     test_anglib();
 #ifdef SLS_USE_GSL
@@ -1,5 +1,6 @@
 #pragma once
 #include "../SLISC/anglib.h"
+#include "../SLISC/arithmetic.h"
 
 void test_anglib()
 {
@@ -13,4 +14,88 @@ void test_anglib()
     if (abs(cleb(10, 0, 8, 0, 2, 0) - sqrt(5. / 33.)) > 1e-15) SLS_ERR("failed!");
     if (abs(threej(12, 0, 8, 0, 4, 0) - sqrt(5. / 143.)) > 1e-15) SLS_ERR("failed!");
     if (abs(sixj(2, 4, 6, 4, 2, 4) - 1. / (5 * sqrt(21.))) > 1e-15) SLS_ERR("failed!");
+    if (binom(60, 30) != 118264581564861424.) SLS_ERR("failed!");
+    if (abs(lnfact(20) - log(factorial(20))) > 1e-13) SLS_ERR("failed!");
+    if (abs(lnfact(2000) - lgamma(2001.)) > 1e-10) SLS_ERR("failed!");
+
+    // threej_table(), compare with threej()
+    for (Long j2 = 0; j2 <= 8; ++j2)
+        for (Long j3 = 0; j3 <= 9; ++j3)
+            for (Long m2 = -j2; m2 <= j2; m2 += 2)
+                for (Long m3 = -j3; m3 <= j3; m3 += 2) {
+                    VecDoub f(0); Long j1min;
+                    threej_table(f, j1min, j2, j3, m2, m3);
+                    for (Long k = 0; k < f.size(); ++k)
+                        if (abs(f[k] - threej(j1min + 2 * k, -m2 - m3, j2, m2, j3, m3)) > 1e-15)
+                            SLS_ERR("failed!");
+                }
+
+    // threej_table() for large j, orthogonality
+    // sum_{m2,m3} (2j1+1) (j1 j2 j3; m1 m2 m3) (j1' j2 j3; m1 m2 m3) = delta(j1, j1')
+    {
+        Long two_j2 = 300, two_j3 = 220, two_m1 = 6;
+        Long j1min0 = two_j2 - two_j3, N = (two_j2 + two_j3 - j1min0) / 2 + 1, j1min;
+        CmatDoub G(N, N); G = 0;
+        VecDoub f(0);
+        for (Long m2 = -two_j2; m2 <= two_j2; m2 += 2) {
+            Long m3 = -two_m1 - m2;
+            if (abs(m3) > two_j3)
+                continue;
+            threej_table(f, j1min, two_j2, two_j3, m2, m3);
+            Long k0 = (j1min - j1min0) / 2;
+            for (Long j = 0; j < f.size(); ++j)
+                for (Long i = 0; i < f.size(); ++i)
+                    G(k0 + i, k0 + j) += (j1min + 2 * i + 1) * f[i] * f[j];
+        }
+        for (Long i = 0; i < N; ++i)
+            G(i, i) -= 1;
+        if (max_abs(G) > 1e-13)
+            SLS_ERR("failed!");
+    }
+
+    // cleb_table()
+    {
+        Long two_j1 = 5, two_j2 = 4;
+        Cmat3d<Doub> C(0, 0, 0);
+        cleb_table(C, two_j1, two_j2);
+        for (Long i1 = 0; i1 <= two_j1; ++i1)
+            for (Long i2 = 0; i2 <= two_j2; ++i2)
+                for (Long k = 0; k < C.n3(); ++k) {
+                    Long m1 = 2 * i1 - two_j1, m2 = 2 * i2 - two_j2;
+                    if (abs(C(i1, i2, k) - cleb(two_j1, m1, two_j2, m2, 1 + 2 * k, m1 + m2)) > 1e-15)
+                        SLS_ERR("failed!");
+                }
+    }
+
+    // sixj_memo(), ninej_memo(), also from an OpenMP loop
+    {
+        Long N = 4000;
+        VecDoub err(N); err = 0;
+#pragma omp parallel for
+        for (Long n = 0; n < N; ++n) {
+            Long j[9];
+            for (Int i = 0; i < 9; ++i)
+                j[i] = (n * (2 * i + 7) + i * i) % (i < 6 ? 7 : 4);
+            Doub x = sixj_memo(j[0], j[1], j[2], j[3], j[4], j[5]) - sixj(j[0], j[1], j[2], j[3], j[4], j[5]);
+            // symmetries of 6j
+            x += sixj_memo(j[1], j[0], j[2], j[4], j[3], j[5]) - sixj(j[0], j[1], j[2], j[3], j[4], j[5]);
+            x += sixj_memo(j[3], j[4], j[2], j[0], j[1], j[5]) - sixj(j[0], j[1], j[2], j[3], j[4], j[5]);
+            Doub y = ninej(j[0], j[1], j[2], j[3], j[4], j[5], j[6], j[7], j[8]);
+            x += ninej_memo(j[0], j[1], j[2], j[3], j[4], j[5], j[6], j[7], j[8]) - y;
+            // symmetries of 9j, (-1)^sum for exchange of two rows
+            x += ninej_memo(j[0], j[3], j[6], j[1], j[4], j[7], j[2], j[5], j[8]) - y;
+            Long sum = 0;
+            for (Int i = 0; i < 9; ++i)
+                sum += j[i];
+            x += ninej_memo(j[3], j[4], j[5], j[0], j[1], j[2], j[6], j[7], j[8]) - (isodd(sum / 2) ? -y : y);
+            err[n] = abs(x);
+        }
+        if (max(err) > 1e-14)
+            SLS_ERR("failed!");
+        // only the canonical key is stored
+        AngMemo memo;
+        memo.sixj(2, 4, 6, 4, 2, 4); memo.sixj(4, 2, 6, 2, 4, 4); memo.sixj(4, 4, 4, 2, 2, 6);
+        if (memo.size() != 1)
+            SLS_ERR("failed!");
+    }
 }
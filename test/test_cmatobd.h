@@ -75,4 +75,57 @@ void test_cmatobd()
         if (norm_inf(a) != 120)
             SLS_ERR("failed!");
     }
+
+    // parallel and multi-column multiplication
+    {
+        Long N0 = 6, Nblk = 301, Ncol = 3;
+        CmobdDoub b(N0, Nblk);
+        Cmat3Doub b3(N0, N0, Nblk);
+        rand(b3); b = b3;
+        Long N = b.n1();
+        CmatDoub bd(N, N);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i < N; ++i)
+                bd(i, j) = b(i, j);
+        VecComp x(N), y(N), y1(N), y2(N);
+        rand(x);
+        mul(y, bd, x); mul(y1, b, x); mul_par(y2, b, x);
+        y1 -= y; y2 -= y;
+        if (max_abs(y1) > 1e-12 || max_abs(y2) > 1e-12)
+            SLS_ERR("failed!");
+        CmatComp X(N, Ncol), Y(N, Ncol), Y1(N, Ncol), Y2(N, Ncol);
+        rand(X);
+        mul(Y, bd, X); mul(Y1, b, X); mul_par(Y2, b, X);
+        Y1 -= Y; Y2 -= Y;
+        if (max_abs(Y1) > 1e-12 || max_abs(Y2) > 1e-12)
+            SLS_ERR("failed!");
+    }
+
+    // specialized (N0 = 5, 10) and generic (N0 = 17) block sizes
+    for (Long N0 : {5, 10, 17}) {
+        Long Nblk = 7;
+        CmobdDoub b(N0, Nblk);
+        Cmat3Doub b3(N0, N0, Nblk);
+        rand(b3); b = b3;
+        Long N = b.n1();
+        CmatDoub bd(N, N);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i < N; ++i)
+                bd(i, j) = b(i, j);
+        VecDoub x(N), y(N), y1(N), y2(N);
+        rand(x);
+        mul(y, bd, x); mul(y1, b, x); mul_par(y2, b, x);
+        y1 -= y; y2 -= y;
+        if (max_abs(y1) > 1e-12 || max_abs(y2) > 1e-12)
+            SLS_ERR("failed!");
+        Doub nrm = 0;
+        for (Long j = 0; j < N; ++j) {
+            Doub s = 0;
+            for (Long i = 0; i < N; ++i)
+                s += abs(bd(i, j));
+            nrm = MAX(nrm, s);
+        }
+        if (abs(norm_inf(b) - nrm) > 1e-12)
+            SLS_ERR("failed!");
+    }
 }
@@ -23,13 +23,97 @@ void test_coulomb()
     //disp(r, 15);
     //disp(F, 15);
 
+    // batched F, dF along a sorted grid
+    {
+        // eta = 0, F_0 = sin(rho), F_1 = sin(rho)/rho - cos(rho)
+        Long N = 3000; Doub k = 1.3;
+        VecDoub r(N), F(N), dF(N); linspace(r, 0., 300.);
+        coulombFDF_sorted(F, dF, 0, k, r, 0.);
+        for (Long i = 0; i < N; ++i)
+            if (abs(F[i] - sin(k*r[i])) > 1e-13 || abs(dF[i] - cos(k*r[i])) > 1e-13)
+                SLS_ERR("failed!");
+        coulombFDF_sorted(F, dF, 1, k, r, 0.);
+        for (Long i = 1; i < N; ++i) {
+            Doub x = k * r[i];
+            if (abs(F[i] - (sin(x)/x - cos(x))) > 1e-12)
+                SLS_ERR("failed!");
+        }
+        // compare with the point-wise version
+        N = 600;
+        VecInt ls(3); ls[0] = 0; ls[1] = 3; ls[2] = 10;
+        VecDoub ks(3); ks[0] = 0.3; ks[1] = 2.; ks[2] = 0.7;
+        r.resize(N); linspace(r, 0., 100.);
+        CmatDoub F2(N, 3), dF2(N, 3);
+        coulombFDF_par(F2, dF2, ls, ks, r);
+        for (Long j = 0; j < 3; ++j) {
+            for (Long i = 0; i < N; i += 7) {
+                Doub F0, dF0;
+                coulombFDF(F0, dF0, ls[j], ks[j], r[i]);
+                if (abs(F0 - F2(i, j)) > 2e-8 || abs(dF0 - dF2(i, j)) > 2e-8)
+                    SLS_ERR("failed!");
+            }
+        }
+    }
+
+    // F, G, dF, dG along a sorted grid
+    {
+        // eta = 0, G_0 = cos(rho)
+        Long N = 1000; Doub k = 0.9;
+        VecDoub r(N), F(N), G(N), dF(N), dG(N); linspace(r, 0.01, 100.);
+        coulombFGDG(F, G, dF, dG, 0, k, r, 0.);
+        for (Long i = 0; i < N; ++i)
+            if (abs(G[i] - cos(k*r[i])) > 1e-12 || abs(dG[i] + sin(k*r[i])) > 1e-12)
+                SLS_ERR("failed!");
+        // compare with the point-wise version, check Wronskian
+        VecInt ls(3); ls[0] = 0; ls[1] = 3; ls[2] = 10;
+        VecDoub ks(3); ks[0] = 0.3; ks[1] = 2.; ks[2] = 0.7;
+        CmatDoub F2(N, 3), G2(N, 3), dF2(N, 3), dG2(N, 3);
+        coulombFGDG_par(F2, G2, dF2, dG2, ls, ks, r);
+        for (Long j = 0; j < 3; ++j) {
+            for (Long i = 0; i < N; ++i)
+                if (abs(dF2(i, j) * G2(i, j) - F2(i, j) * dG2(i, j) - 1) > 1e-9)
+                    SLS_ERR("failed!");
+            for (Long i = 0; i < N; i += 11) {
+                Doub G0 = coulombG(ls[j], ks[j], r[i]);
+                if (abs(G0 - G2(i, j)) > 1e-8 * MAX(1., abs(G0)))
+                    SLS_ERR("failed!");
+            }
+        }
+        coulombG(G, ls[2], ks[2], r);
+        for (Long i = 0; i < N; ++i)
+            if (G[i] != G2(i, 2))
+                SLS_ERR("failed!");
+    }
+
     // coulomb phase shift
-#ifdef SLS_USE_GSL
-    Doub ret = coulomb_sigma(3, -2./5);
-    if (abs(ret + 0.503297642943251313) > 1e-15)
-        SLS_ERR("failed!");
-    ret = coulomb_sigma(4, -2. / 9);
-    if (abs(ret + 0.3347819876751476) > 1e-15)
-        SLS_ERR("failed!");
-#endif
+    {
+        Doub ret = coulomb_sigma(3, -2./5);
+        if (abs(ret + 0.503297642943251313) > 1e-15)
+            SLS_ERR("failed!");
+        ret = coulomb_sigma(4, -2. / 9);
+        if (abs(ret + 0.3347819876751476) > 1e-15)
+            SLS_ERR("failed!");
+        // lngamma(): real axis, |Gamma(1+i*y)|^2 = pi*y/sinh(pi*y), and recurrence
+        for (Doub x : {0.1, 1., 2.5, 7.3, 30.})
+            if (abs(lngamma(Comp(x, 0)) - lgamma(x)) > 1e-14 * MAX(1., abs(lgamma(x))))
+                SLS_ERR("failed!");
+        for (Doub y : {-20., -3., -0.3, 0.01, 2.})
+            if (abs(2 * real(lngamma(Comp(1, y))) - log(PI * y / sinh(PI * y))) > 1e-13)
+                SLS_ERR("failed!");
+        Comp z(0.7, -4.2);
+        if (abs(lngamma(z + 1.) - lngamma(z) - log(z)) > 1e-14)
+            SLS_ERR("failed!");
+        // table, compare with the scalar version
+        Int lmax = 30;
+        VecDoub eta(200);
+        linspace(eta, -50., -0.01);
+        CmatDoub sigma(eta.size(), lmax + 1);
+        coulomb_sigma(sigma, lmax, eta);
+        for (Int l = 0; l <= lmax; ++l)
+            for (Long i = 0; i < eta.size(); ++i) {
+                Doub d = abs(sigma(i, l) - coulomb_sigma(l, eta[i]));
+                if (MIN(d, 2 * PI - d) > 1e-12)
+                    SLS_ERR("failed!");
+            }
+    }
 }
@@ -69,4 +69,73 @@ void test_eig()
             }
         }
     }
+    // divide and conquer, and partial spectrum, with reused workspace
+    {
+        Long N = 40;
+        CmatComp a(N, N), vec0(N, N), vec(N, N);
+        VecDoub val0(N), val(N);
+        for (Long j = 0; j < N; ++j) {
+            for (Long i = 0; i < j; ++i) {
+                a(i, j) = Comp(2 * randDoub() - 1, 2 * randDoub() - 1);
+                a(j, i) = conj(a(i, j));
+            }
+            a(j, j) = 2 * randDoub() - 1;
+        }
+        eig_her(val0, vec0, a);
+        EigWsp<Comp> wsp;
+        eig_her_dc(val, vec, a, wsp);
+        val -= val0;
+        if (max_abs(val) > 1e-11)
+            SLS_ERR("failed!");
+        CmatComp av(N, N), vd(N, N);
+        mul(av, a, vec);
+        mul(vd, vec, diag(val0));
+        av -= vd;
+        if (max_abs(av) > 1e-11)
+            SLS_ERR("failed!");
+
+        // index range
+        Long il = 3, iu = 9, Nev = iu - il + 1;
+        VecDoub val1(Nev); CmatComp vec1(N, Nev), av1(N, Nev), vd1(N, Nev);
+        eig_her_range(val1, vec1, a, il, iu, wsp);
+        for (Long i = 0; i < Nev; ++i)
+            if (abs(val1[i] - val0[il + i]) > 1e-11)
+                SLS_ERR("failed!");
+        mul(av1, a, vec1);
+        mul(vd1, vec1, diag(val1));
+        av1 -= vd1;
+        if (max_abs(av1) > 1e-11)
+            SLS_ERR("failed!");
+        eig_her_range(val1, vec1, a, 0, Nev - 1); // without workspace
+        for (Long i = 0; i < Nev; ++i)
+            if (abs(val1[i] - val0[i]) > 1e-11)
+                SLS_ERR("failed!");
+
+        // value interval
+        VecDoub val2(0); CmatComp vec2(0, 0);
+        Long Nfound = eig_her_interval(val2, vec2, a, 0.5 * (val0[4] + val0[5]), 0.5 * (val0[10] + val0[11]), wsp);
+        if (Nfound != 6 || val2.size() != 6 || vec2.n2() != 6)
+            SLS_ERR("failed!");
+        for (Long i = 0; i < Nfound; ++i)
+            if (abs(val2[i] - val0[5 + i]) > 1e-11)
+                SLS_ERR("failed!");
+
+        // real symmetric
+        CmatDoub b(N, N), u(N, N), bu(N, N), ud(N, N);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i <= j; ++i)
+                b(i, j) = b(j, i) = 2 * randDoub() - 1;
+        EigWsp<Doub> wsp1;
+        eig_sym_dc(val, u, b, wsp1);
+        mul(bu, b, u);
+        mul(ud, u, diag(val));
+        bu -= ud;
+        if (max_abs(bu) > 1e-11)
+            SLS_ERR("failed!");
+        CmatDoub u1(N, 2);
+        VecDoub val3(2);
+        eig_her_range(val3, u1, b, N - 2, N - 1, wsp1);
+        if (abs(val3[0] - val[N - 2]) > 1e-11 || abs(val3[1] - val[N - 1]) > 1e-11)
+            SLS_ERR("failed!");
+    }
 }
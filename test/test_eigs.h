@@ -0,0 +1,248 @@
+#pragma once
+#include "../SLISC/eigs.h"
+#include "../SLISC/eig_batch.h"
+#include "../SLISC/random.h"
+#include "../SLISC/arithmetic.h"
+#include "../SLISC/band_arith.h"
+
+inline void test_eigs()
+{
+    using namespace slisc;
+
+    // eig_her_jacobi()
+    {
+        Long N = 12;
+        CmatComp a(N, N), v(N, N), av(N, N), vd(N, N);
+        VecDoub val(N);
+        for (Long j = 0; j < N; ++j) {
+            for (Long i = 0; i < j; ++i) {
+                a(i, j) = Comp(randDoub() - 0.5, randDoub() - 0.5);
+                a(j, i) = conj(a(i, j));
+            }
+            a(j, j) = randDoub() - 0.5;
+        }
+        eig_her_jacobi(val, v, a);
+        for (Long i = 1; i < N; ++i)
+            if (val[i] < val[i - 1])
+                SLS_ERR("failed!");
+        mul(av, a, v);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i < N; ++i)
+                vd(i, j) = v(i, j) * val[j];
+        av -= vd;
+        if (max_abs(av) > 1e-13)
+            SLS_ERR("failed!");
+
+        CmatDoub b(N, N), u(N, N), bu(N, N);
+        rand(b);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i < j; ++i)
+                b(i, j) = b(j, i);
+        eig_her_jacobi(val, u, b);
+        mul(bu, b, u);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i < N; ++i)
+                bu(i, j) -= u(i, j) * val[j];
+        if (max_abs(bu) > 1e-13)
+            SLS_ERR("failed!");
+    }
+
+    // eig_her_batch(), eig_her_batch_par()
+    for (Long N : {3, 8, 13}) {
+        Long Nbatch = 50;
+        Cmat3Comp a(N, N, Nbatch), v(N, N, Nbatch), v1(N, N, Nbatch);
+        CmatDoub val(N, Nbatch), val1(N, Nbatch);
+        for (Long k = 0; k < Nbatch; ++k)
+            for (Long j = 0; j < N; ++j) {
+                for (Long i = 0; i < j; ++i) {
+                    a(i, j, k) = Comp(randDoub() - 0.5, randDoub() - 0.5);
+                    a(j, i, k) = conj(a(i, j, k));
+                }
+                a(j, j, k) = randDoub() - 0.5;
+            }
+        eig_her_batch(val, v, a);
+        eig_her_batch_par(val1, v1, a);
+        if (val != val1 || v != v1)
+            SLS_ERR("failed!");
+        CmatComp a0(N, N), v0(N, N);
+        VecDoub val0(N);
+        for (Long k = 0; k < Nbatch; k += 7) {
+            for (Long j = 0; j < N; ++j)
+                for (Long i = 0; i < N; ++i)
+                    a0(i, j) = a(i, j, k);
+            eig_her_jacobi(val0, v0, a0);
+            for (Long i = 0; i < N; ++i)
+                if (abs(val0[i] - val(i, k)) > 1e-13)
+                    SLS_ERR("failed!");
+            // residual
+            for (Long j = 0; j < N; ++j)
+                for (Long i = 0; i < N; ++i) {
+                    Comp s = -v(i, j, k) * val(j, k);
+                    for (Long n = 0; n < N; ++n)
+                        s += a(i, n, k) * v(n, j, k);
+                    if (abs(s) > 1e-13)
+                        SLS_ERR("failed!");
+                }
+        }
+#ifdef SLS_USE_LAPACKE
+        // always use LAPACK
+        eig_her_batch_par(val1, v1, a, 0);
+        val1 -= val;
+        if (max_abs(val1) > 1e-13)
+            SLS_ERR("failed!");
+#endif
+    }
+
+    // Lanczos, lowest eigen values of a Hermitian MatCooH
+    // harmonic oscillator by finite difference, with a complex gauge phase
+    {
+        Long N = 120, nev = 5;
+        Doub dx = 0.1, x0 = -0.5 * (N - 1) * dx;
+        Comp hop = -0.5 / (dx * dx) * exp(Comp(0, 0.3));
+        McoohComp a(N, N);
+        CmatComp den(N, N); den = 0;
+        for (Long i = 0; i < N; ++i) {
+            Doub x = x0 + i * dx;
+            a.push(1 / (dx * dx) + 0.5 * x * x, i, i);
+            den(i, i) = 1 / (dx * dx) + 0.5 * x * x;
+            if (i < N - 1) {
+                a.push(hop, i, i + 1);
+                den(i, i + 1) = hop; den(i + 1, i) = conj(hop);
+            }
+        }
+        VecDoub val0(N); CmatComp vec0(N, N);
+        eig_her_jacobi(val0, vec0, den);
+
+        VecDoub val(nev); CmatComp vec(N, nev);
+        Long ret = eigs_her(val, vec, a, 'S', 0, 1e-12);
+        if (ret < 0)
+            SLS_ERR("failed!");
+        for (Long i = 0; i < nev; ++i) {
+            if (abs(val[i] - val0[i]) > 1e-9)
+                SLS_ERR("failed!");
+            if (abs(val[i] - (0.5 + i)) > 5e-2)
+                SLS_ERR("failed!");
+        }
+        // residual of eigen vectors
+        VecComp v(N), av(N);
+        for (Long i = 0; i < nev; ++i) {
+            for (Long n = 0; n < N; ++n) v[n] = vec(n, i);
+            mul(av.ptr(), a, v.ptr());
+            v *= val[i]; av -= v;
+            if (max_abs(av) > 1e-6)
+                SLS_ERR("failed!");
+        }
+
+        // shift-invert with MINRES
+        Doub sigma = 3.2; nev = 3;
+        PrecIdent M(N);
+        OpShiftInv<Comp, McoohComp> op(a, sigma, N, M, 'M', 1e-14);
+        VecDoub val1(nev); CmatComp vec1(N, nev);
+        ret = eigs_her_si(val1.ptr(), vec1.ptr(), op, sigma, N, nev);
+        if (ret < 0)
+            SLS_ERR("failed!");
+        // closest to sigma: 2.5, 3.5, 4.5 (approximately)
+        for (Long i = 0; i < nev; ++i)
+            if (abs(val1[i] - val0[i + 2]) > 1e-8)
+                SLS_ERR("failed!");
+    }
+
+    // Lanczos for CmatObd, largest eigen values, and shift-invert with LuBand
+    {
+        Long N0 = 5, Nblk = 30, nev = 4;
+        Cmat3Doub a3(N0, N0, Nblk);
+        rand(a3);
+        for (Long k = 0; k < Nblk; ++k)
+            for (Long j = 0; j < N0; ++j)
+                for (Long i = 0; i < j; ++i)
+                    a3(i, j, k) = a3(j, i, k);
+        CmobdDoub a(N0, Nblk); a = a3;
+        Long N = a.n1();
+        CmatDoub den(N, N);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i < N; ++i)
+                den(i, j) = a(i, j);
+        VecDoub val0(N); CmatDoub vec0(N, N);
+        eig_her_jacobi(val0, vec0, den);
+
+        VecDoub val(nev); CmatDoub vec(N, nev);
+        if (eigs_her(val, vec, a, 'L', 0, 1e-12) < 0)
+            SLS_ERR("failed!");
+        for (Long i = 0; i < nev; ++i)
+            if (abs(val[i] - val0[N - 1 - i]) > 1e-9)
+                SLS_ERR("failed!");
+
+        Doub sigma = 0.5 * (val0[N / 2] + val0[N / 2 + 1]);
+        CmobdDoub b(N0, Nblk); b = a;
+        for (Long i = 0; i < N; ++i)
+            b(b.find(i, i)) -= sigma;
+        LuBand<Doub> lu(b);
+        if (eigs_her_si(val.ptr(), vec.ptr(), lu, sigma, N, 2) < 0)
+            SLS_ERR("failed!");
+        if (abs(val[0] - val0[N / 2]) > 1e-9 || abs(val[1] - val0[N / 2 + 1]) > 1e-9)
+            SLS_ERR("failed!");
+    }
+
+    // Arnoldi for a non-Hermitian MatCoo
+    {
+        Long N = 100, nev = 4;
+        McooComp a(N, N);
+        CmatComp den(N, N); den = 0;
+        for (Long i = 0; i < N; ++i) {
+            Comp d(0.05 * i, 0.3 * sin(i));
+            a.push(d, i, i); den(i, i) = d;
+            if (i < N - 1) {
+                a.push(1, i, i + 1); den(i, i + 1) = 1;
+                a.push(0.9, i + 1, i); den(i + 1, i) = 0.9;
+            }
+        }
+        // all eigen values (den is upper Hessenberg)
+        VecComp val0(N); CmatComp vec0(N, N);
+        eigs_hess_eig(val0.ptr(), vec0.ptr(), den.ptr(), N);
+        VecDoub re(N); VecLong ind(N);
+        for (Long i = 0; i < N; ++i) {
+            re[i] = real(val0[i]); ind[i] = i;
+        }
+        sort2(re, ind);
+
+        VecComp val(nev); CmatComp vec(N, nev);
+        if (eigs_gen(val, vec, a, 'S', 0, 1e-12) < 0)
+            SLS_ERR("failed!");
+        VecComp v(N), av(N);
+        for (Long i = 0; i < nev; ++i) {
+            if (abs(val[i] - val0[ind[i]]) > 1e-8)
+                SLS_ERR("failed!");
+            for (Long n = 0; n < N; ++n) v[n] = vec(n, i);
+            mul(av.ptr(), a, v.ptr());
+            v *= val[i]; av -= v;
+            if (max_abs(av) > 1e-7)
+                SLS_ERR("failed!");
+        }
+
+        // shift-invert with band LU
+        Comp sigma(2.02, 0.1);
+        CmatComp den1(N, N); den1 = 0;
+        for (Long k = 0; k < a.nnz(); ++k)
+            den1(a.row(k), a.col(k)) = a(k);
+        for (Long i = 0; i < N; ++i)
+            den1(i, i) -= sigma;
+        Band<Comp> ban(den1, 1, 1);
+        LuBand<Comp> lu(ban);
+        nev = 2;
+        VecComp val1(nev); CmatComp vec1(N, nev);
+        if (eigs_gen_si(val1.ptr(), vec1.ptr(), lu, sigma, N, nev) < 0)
+            SLS_ERR("failed!");
+        for (Long i = 0; i < nev; ++i) {
+            // should be among the closest eigen values of sigma
+            Doub dmin = 1e100, dist = abs(val1[i] - sigma);
+            Long Ncloser = 0;
+            for (Long n = 0; n < N; ++n) {
+                dmin = MIN(dmin, abs(val0[n] - val1[i]));
+                if (abs(val0[n] - sigma) < dist - 1e-10)
+                    ++Ncloser;
+            }
+            if (dmin > 1e-8 || Ncloser >= nev)
+                SLS_ERR("failed!");
+        }
+    }
+}
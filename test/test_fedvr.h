@@ -1,6 +1,11 @@
 #pragma once
-#include "../SLISC/eig.h"
 #include "../SLISC/fedvr.h"
+#include "../SLISC/arithmetic.h"
+#include "../SLISC/random.h"
+#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
+#include "../SLISC/eig.h"
+#include "../SLISC/expokit.h"
+#endif
 
 inline double test_fedvr_fun(const double x, const int n)
 {
@@ -59,6 +64,108 @@ inline void test_D2_mat()
     if (max_abs(d2y) > 5e-13) SLS_ERR("failed!");
 }
 
+// D2_matrix() directly into CmatObd and MatCsr, compared with MatCoo
+inline void test_D2_direct()
+{
+    using namespace slisc;
+    for (Long Nfe = 1; Nfe <= 5; ++Nfe) {
+        Long Ngs = 4 + 2 * (Nfe % 3), Nx = Nfe * (Ngs - 1) - 1;
+        VecDoub bounds(Nfe + 1); linspace(bounds, -2., 3.);
+        for (Long i = 1; i < Nfe; ++i)
+            bounds[i] += 0.3 * (randDoub() - 0.5);
+        VecDoub x(Nx), w(Nx), u(Nx), x1(Nx), w1(Nx), u1(Nx);
+        McooDoub D2s(Nx, Nx);
+        D2_matrix(D2s, x, w, u, bounds, Ngs);
+        Doub tol = 0;
+        for (Long k = 0; k < D2s.nnz(); ++k)
+            tol = MAX(tol, 1e-14 * abs(D2s[k]));
+
+        // CmatObd
+        CmobdDoub D2(0, 0), D2ref(Ngs, Nfe);
+        D2ref = D2s;
+        D2_matrix(D2, x1, w1, u1, bounds, Ngs);
+        if (D2.n0() != Ngs || D2.nblk() != Nfe || x1 != x || w1 != w || u1 != u)
+            SLS_ERR("failed!");
+        for (Long i = 0; i < D2.cmat3().size(); ++i)
+            if (abs(D2(i) - D2ref(i)) > tol)
+                SLS_ERR("failed!");
+
+        // MatCsr
+        McsrDoub D2c(0, 0), D2cref(Nx, Nx);
+        D2cref = D2s;
+        D2_matrix(D2c, x1, w1, u1, bounds, Ngs);
+        if (D2c.n1() != Nx || D2c.nnz() != D2cref.nnz())
+            SLS_ERR("failed!");
+        for (Long i = 0; i <= Nx; ++i)
+            if (D2c.row_ptr()[i] != D2cref.row_ptr()[i])
+                SLS_ERR("failed!");
+        for (Long k = 0; k < D2c.nnz(); ++k)
+            if (D2c.col(k) != D2cref.col(k) || abs(D2c(k) - D2cref(k)) > tol)
+                SLS_ERR("failed!");
+    }
+}
+
+// transfer between FEDVR grids and uniform grids, exact for polynomials
+inline void test_fedvr_interp()
+{
+    using namespace slisc;
+    // f(x) * x^n, n = 0, 1, 2, vanishes at the box boundaries
+    auto f = [](Doub_I x, Long_I n) { return (x + 2) * (3 - x) * (1 + x + 0.3 * x * x) * pow(x, n); };
+    Long NfeA = 4, NgsA = 8, NA = NfeA * (NgsA - 1) - 1;
+    Long NfeB = 3, NgsB = 6, NB = NfeB * (NgsB - 1) - 1;
+    VecDoub boundsA(NfeA + 1), boundsB(NfeB + 1);
+    linspace(boundsA, -2., 3.); linspace(boundsB, -2., 3.);
+    for (Long i = 1; i < NfeA; ++i)
+        boundsA[i] += 0.4 * (randDoub() - 0.5);
+    VecDoub xA(NA), wA(NA), uA(NA), xB(NB), wB(NB), uB(NB);
+    CmobdDoub D2(0, 0);
+    D2_matrix(D2, xA, wA, uA, boundsA, NgsA);
+    D2_matrix(D2, xB, wB, uB, boundsB, NgsB);
+
+    // FEDVR to FEDVR, many columns
+    McsrDoub T(0, 0);
+    fedvr_interp_matrix(T, boundsA, NgsA, xB);
+    if (T.n1() != NB || T.n2() != NA)
+        SLS_ERR("failed!");
+    CmatDoub X(NA, 3), Y(NB, 3), Y1(NB, 3);
+    MatDoub Xr(NA, 3), Yr(NB, 3);
+    for (Long n = 0; n < 3; ++n)
+        for (Long i = 0; i < NA; ++i)
+            X(i, n) = Xr(i, n) = f(xA[i], n);
+    mul(Y, T, X);
+    mul_par(Y1, T, X);
+    Y1 -= Y;
+    if (max_abs(Y1) > 0)
+        SLS_ERR("failed!");
+    mul_par(Yr, T, Xr);
+    for (Long n = 0; n < 3; ++n)
+        for (Long i = 0; i < NB; ++i)
+            if (abs(Y(i, n) - f(xB[i], n)) > 1e-12 || abs(Yr(i, n) - Y(i, n)) > 1e-13)
+                SLS_ERR("failed!");
+
+    // FEDVR to uniform (including the boundaries)
+    Long Nu = 64;
+    VecDoub xu(Nu), fu(Nu), fA(NA), fB(NB);
+    linspace(xu, -2., 3.);
+    for (Long i = 0; i < NA; ++i)
+        fA[i] = f(xA[i], 0);
+    fedvr_interp_matrix(T, boundsA, NgsA, xu);
+    mul(fu, T, fA);
+    for (Long i = 0; i < Nu; ++i)
+        if (abs(fu[i] - f(xu[i], 0)) > 1e-12)
+            SLS_ERR("failed!");
+
+    // uniform to FEDVR
+    uniform_interp_matrix(T, -2., 5. / (Nu - 1), Nu, xB, 7);
+    if (T.n1() != NB || T.n2() != Nu || T.nnz() != 7 * NB)
+        SLS_ERR("failed!");
+    mul(fB, T, fu);
+    for (Long i = 0; i < NB; ++i)
+        if (abs(fB[i] - f(xB[i], 0)) > 1e-11)
+            SLS_ERR("failed!");
+}
+
+#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
 // bound states of infinite square well
 inline void test_inf_sqr_well()
 {
@@ -131,11 +238,121 @@ inline void test_SHO()
 
     // TODO: test wave function using analytical solution.
 }
+#endif
+
+// 1D FEDVR kinetic matrix -0.5*D2 in CmatObd format, box [0, L]
+inline void test_fedvr_kinetic(slisc::CmatObd<slisc::Doub> &a, slisc::Long_I Nfe, slisc::Long_I Ngs, slisc::Doub_I L)
+{
+    using namespace slisc;
+    Long Nx = Nfe * (Ngs - 1) - 1;
+    VecDoub bounds(Nfe + 1); linspace(bounds, 0., L);
+    VecDoub x(Nx), w(Nx), u(Nx);
+    McooDoub D2(Nx, Nx);
+    D2_matrix(D2, x, w, u, bounds, Ngs);
+    D2 *= -0.5;
+    a.resize(Ngs, Nfe);
+    a = D2;
+}
+
+// matrix-free tensor product operator, compared with the explicit Kronecker sum
+inline void test_fedvr_op()
+{
+    using namespace slisc;
+    CmatObd<Doub> a0(0, 0), a1(0, 0), a2(0, 0);
+    test_fedvr_kinetic(a0, 3, 6, 2.);
+    test_fedvr_kinetic(a1, 2, 8, 1.5);
+    test_fedvr_kinetic(a2, 4, 4, 3.);
+    Long n0 = a0.n1(), n1 = a1.n1(), n2 = a2.n1(), N = n0 * n1 * n2;
+
+    // 2D
+    {
+        OpFedvr<Doub> H(a0, a1);
+        VecDoub V(n0 * n1); rand(V);
+        H.set_diag(V);
+        McooDoub Hs(n0 * n1, n0 * n1, n0 * n1 * (a0.n0() + a1.n0()) * 2);
+        for (Long i1 = 0; i1 < n1; ++i1)
+            for (Long i0 = 0; i0 < n0; ++i0) {
+                Long i = i0 + n0 * i1;
+                for (Long j0 = 0; j0 < n0; ++j0)
+                    if (a0(i0, j0) != 0)
+                        Hs.push(a0(i0, j0) + (i0 == j0 ? V[i] : 0.), i, j0 + n0 * i1);
+                for (Long j1 = 0; j1 < n1; ++j1)
+                    if (a1(i1, j1) != 0)
+                        Hs.push(a1(i1, j1), i, i0 + n0 * j1);
+            }
+        CmatComp x(n0, n1), y(n0, n1), y1(n0, n1);
+        VecComp xv(n0 * n1), yv(n0 * n1);
+        rand(x);
+        for (Long i = 0; i < n0 * n1; ++i)
+            xv[i] = x[i];
+        mul(y, H, x);
+        mul(yv, Hs, xv);
+        for (Long i = 0; i < n0 * n1; ++i)
+            yv[i] -= y[i];
+        if (max_abs(yv) > 1e-14 * max_abs(y))
+            SLS_ERR("failed!");
+        mul_par(y1, H, x);
+        y1 -= y;
+        if (max_abs(y1) > 1e-14 * max_abs(y))
+            SLS_ERR("failed!");
+
+#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
+        // expv()
+        VecComp v(n0 * n1), v1(n0 * n1);
+        rand(v); v /= norm(v); v1 = v;
+        expv<'G'>(v, H, -0.1, 20, norm_inf(H), 1e-12);
+        expv<'G'>(v1, Hs, -0.1, 20, norm_inf(Hs), 1e-12);
+        v1 -= v;
+        if (max_abs(v1) > 1e-10)
+            SLS_ERR("failed!");
+#endif
+    }
+
+    // 3D
+    {
+        OpFedvr<Doub> H(a0, a1, a2);
+        CmatDoub Hd(N, N); Hd = 0;
+        for (Long i2 = 0; i2 < n2; ++i2)
+            for (Long i1 = 0; i1 < n1; ++i1)
+                for (Long i0 = 0; i0 < n0; ++i0) {
+                    Long i = i0 + n0 * i1 + n0 * n1 * i2;
+                    for (Long j = 0; j < n0; ++j)
+                        Hd(i, j + n0 * i1 + n0 * n1 * i2) += a0(i0, j);
+                    for (Long j = 0; j < n1; ++j)
+                        Hd(i, i0 + n0 * j + n0 * n1 * i2) += a1(i1, j);
+                    for (Long j = 0; j < n2; ++j)
+                        Hd(i, i0 + n0 * i1 + n0 * n1 * j) += a2(i2, j);
+                }
+        Cmat3d<Comp> x(n0, n1, n2), y(n0, n1, n2);
+        VecComp xv(N), yv(N);
+        rand(x);
+        for (Long i = 0; i < N; ++i)
+            xv[i] = x[i];
+        mul(y, H, x);
+        mul(yv, Hd, xv);
+        for (Long i = 0; i < N; ++i)
+            yv[i] -= y[i];
+        if (max_abs(yv) > 1e-14 * max_abs(y))
+            SLS_ERR("failed!");
+        mul_par(y, H, x);
+        for (Long i = 0; i < N; ++i)
+            yv[i] = y[i];
+        mul(xv, H, x);
+        xv -= yv;
+        if (max_abs(xv) > 1e-14 * max_abs(yv))
+            SLS_ERR("failed!");
+    }
+}
 
 void test_fedvr()
 {
     test_gauss();
     test_D2_mat();
+    test_D2_direct();
+    test_fedvr_interp();
+    test_fedvr_op();
+#if defined(SLS_USE_MKL) || defined(SLS_USE_LAPACKE) && defined(SLS_USE_CBLAS)
     test_SHO();
     test_inf_sqr_well();
+#endif
 }
@@ -0,0 +1,82 @@
+#pragma once
+#include "../SLISC/gaunt.h"
+#include "../SLISC/arithmetic.h"
+#include "../SLISC/random.h"
+#include "../SLISC/sht.h"
+
+inline void test_gaunt()
+{
+    using namespace slisc;
+    Int lmax = 5, Lmax = 4;
+    GauntTable gaunt(lmax, Lmax);
+    if (gaunt.n1() != 36 || gaunt.n2() != 36)
+        SLS_ERR("failed!");
+
+    // compare with cleb(), all nonzero coefficients are in the table
+    CmatDoub G(gaunt.n1(), gaunt.n2() * (Lmax + 1) * (Lmax + 1)); G = 0;
+    Long N1 = (Lmax + 1) * (Lmax + 1);
+    for (Long i = 0; i < gaunt.n1(); ++i)
+        for (Long k = gaunt.row_ptr[i]; k < gaunt.row_ptr[i + 1]; ++k)
+            G(i, gaunt.ind1[k] + N1 * gaunt.ind2[k]) = gaunt.val[k];
+    Long nnz = 0;
+    for (Int l = 0; l <= lmax; ++l)
+    for (Int m = -l; m <= l; ++m)
+        for (Int L = 0; L <= Lmax; ++L)
+        for (Int M = -L; M <= L; ++M)
+            for (Int l2 = 0; l2 <= lmax; ++l2) {
+                Int m2 = m - M;
+                if (abs(m2) > l2)
+                    continue;
+                Doub g = sqrt((2. * L + 1) * (2 * l2 + 1) / (4 * PI * (2 * l + 1))) *
+                    cleb(2 * L, 0, 2 * l2, 0, 2 * l, 0) * cleb(2 * L, 2 * M, 2 * l2, 2 * m2, 2 * l, 2 * m);
+                if (abs(g) > 1e-15)
+                    ++nnz;
+                if (abs(g - G(ylm_ind(l, m), ylm_ind(L, M) + N1 * ylm_ind(l2, m2))) > 1e-14)
+                    SLS_ERR("failed!");
+            }
+    if (nnz != gaunt.nnz())
+        SLS_ERR("failed!");
+
+    // coupling(), compare with the matrix elements of V(Omega) by quadrature
+    {
+        VecComp V(N1); rand(V);
+        CmatComp A(gaunt.n1(), gaunt.n2());
+        gaunt.coupling(A, V);
+        ShtPlan plan(2 * lmax + Lmax);
+        MatComp f(plan.Nth, plan.Nph);
+        VecComp c(plan.size()); c = 0;
+        for (Long k = 0; k < N1; ++k)
+            c[k] = V[k];
+        isht(f, c, plan); // V(Omega)
+        Long i = ylm_ind(3, -1), i2 = ylm_ind(4, 2);
+        Comp s = 0;
+        for (Long it = 0; it < plan.Nth; ++it)
+            for (Long ip = 0; ip < plan.Nph; ++ip)
+                s += plan.wth[it] * conj(ylm(3, -1, plan.theta[it], plan.phi[ip])) * f(it, ip) *
+                    ylm(4, 2, plan.theta[it], plan.phi[ip]);
+        if (abs(s - A(i, i2)) > 1e-14)
+            SLS_ERR("failed!");
+    }
+
+    // save and load
+    {
+        Matt matt;
+        if (file_exist("test_gaunt.matt"))
+            remove("test_gaunt.matt");
+        matt.open("test_gaunt.matt", "w");
+        save(gaunt, "gaunt", matt);
+        matt.close();
+        GauntTable gaunt1;
+        matt.open("test_gaunt.matt", "r");
+        if (load(gaunt1, "gaunt", matt))
+            SLS_ERR("failed!");
+        matt.close();
+        remove("test_gaunt.matt");
+        if (gaunt1.lmax != lmax || gaunt1.Lmax != Lmax || gaunt1.row_ptr != gaunt.row_ptr ||
+            gaunt1.ind1 != gaunt.ind1 || gaunt1.ind2 != gaunt.ind2)
+            SLS_ERR("failed!");
+        gaunt1.val -= gaunt.val;
+        if (max_abs(gaunt1.val) > 1e-15)
+            SLS_ERR("failed!");
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include "../SLISC/krylov.h"
+#include "../SLISC/random.h"
+
+// relative residual |b - A*x| / |b|
+template <class T, class Tmat>
+inline slisc::Doub test_krylov_res(const Tmat &a, const slisc::Vector<T> &x, const slisc::Vector<T> &b)
+{
+    using namespace slisc;
+    Vector<T> r(x.size()), x1(x.size()); x1 = x;
+    mul(r.ptr(), a, x1.ptr());
+    r -= b;
+    return norm(r) / norm(b);
+}
+
+inline void test_krylov()
+{
+    using namespace slisc;
+    Doub tol = 1e-10;
+
+    // 2D Laplacian (Hermitian positive definite)
+    Long N1 = 20, N = N1 * N1;
+    McooDoub lap(N, N);
+    for (Long i = 0; i < N1; ++i) {
+        for (Long j = 0; j < N1; ++j) {
+            Long n = N1 * i + j;
+            lap.push(4.2, n, n);
+            if (i > 0) lap.push(-1, n, n - N1);
+            if (i < N1 - 1) lap.push(-1, n, n + N1);
+            if (j > 0) lap.push(-1, n, n - 1);
+            if (j < N1 - 1) lap.push(-1, n, n + 1);
+        }
+    }
+    lap.sort_r();
+    McsrDoub lap_csr(N, N); lap_csr = lap;
+
+    // CG with different preconditioners, reuse workspace
+    {
+        VecDoub b(N), x(N); rand(b);
+        KrylovWsp<Doub> wsp;
+        x = 0;
+        Long it0 = cg(x, lap_csr, b, PrecIdent(N), tol, 1000, wsp);
+        if (it0 < 0 || test_krylov_res(lap_csr, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        Long it = cg(x, lap_csr, b, PrecJacobi<Doub>(lap_csr), tol, 1000, wsp);
+        if (it < 0 || test_krylov_res(lap_csr, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        it = cg(x, lap, b, PrecIlu0<Doub>(lap), tol, 1000, wsp);
+        if (it < 0 || it >= it0 || test_krylov_res(lap, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        it = cg(x, lap_csr, b, PrecBlockJacobi<Doub>(lap_csr, N1), tol, 1000, wsp);
+        if (it < 0 || it >= it0 || test_krylov_res(lap_csr, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        it = cg(x, lap_csr, b, tol, 1000);
+        if (it != it0)
+            SLS_ERR("failed!");
+    }
+
+    // MINRES for Hermitian indefinite matrix
+    {
+        McoohComp a(N, N);
+        for (Long k = 0; k < lap.nnz(); ++k)
+            if (lap.row(k) <= lap.col(k))
+                a.push(lap(k), lap.row(k), lap.col(k));
+        for (Long n = 0; n < N - 1; ++n)
+            a.push(Comp(0, 0.3), n, n + 1);
+        for (Long n = 0; n < N; ++n)
+            a.add(-3.7, n, n);
+        VecComp b(N), x(N); rand(b);
+        x = 0;
+        Long it = minres(x, a, b, tol, 2000);
+        if (it < 0 || test_krylov_res(a, x, b) > 1e3 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        KrylovWsp<Comp> wsp;
+        it = minres(x, a, b, PrecJacobi<Comp>(a), tol, 2000, wsp);
+        if (it < 0 || test_krylov_res(a, x, b) > 1e3 * tol)
+            SLS_ERR("failed!");
+    }
+
+    // GMRES(m) and BiCGSTAB for a non-Hermitian matrix
+    {
+        McooComp a(N, N);
+        for (Long k = 0; k < lap.nnz(); ++k) {
+            Long i = lap.row(k), j = lap.col(k);
+            a.push(lap(k) + (j == i + 1 ? 0.5 : 0) + (i == j ? Comp(0, 0.5) : 0), i, j);
+        }
+        a.sort_r();
+        McsrComp a_csr(N, N); a_csr = a;
+        MsellComp a_sell(N, N); a_sell = a;
+        VecComp b(N), x(N); rand(b);
+        KrylovWsp<Comp> wsp;
+        x = 0;
+        Long it0 = gmres(x, a, b, 30, tol, 2000);
+        if (it0 < 0 || test_krylov_res(a, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        Long it = gmres(x, a_csr, b, PrecIlu0<Comp>(a_csr), 30, tol, 2000, wsp);
+        if (it < 0 || it >= it0 || test_krylov_res(a, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        it = bicgstab(x, a_sell, b, tol, 2000);
+        if (it < 0 || test_krylov_res(a, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        it = bicgstab(x, a_csr, b, PrecJacobi<Comp>(a_csr), tol, 2000, wsp);
+        if (it < 0 || test_krylov_res(a, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+    }
+
+    // CmatObd
+    {
+        Long N0 = 6, Nblk = 40;
+        Cmat3Doub a3(N0, N0, Nblk);
+        rand(a3);
+        for (Long k = 0; k < Nblk; ++k)
+            for (Long j = 0; j < N0; ++j) {
+                a3(j, j, k) += 3;
+                for (Long i = 0; i < j; ++i)
+                    a3(i, j, k) = a3(j, i, k);
+            }
+        CmobdDoub a(N0, Nblk); a = a3;
+        Long N = a.n1();
+        VecDoub b(N), x(N); rand(b);
+        KrylovWsp<Doub> wsp;
+        x = 0;
+        Long it = gmres(x, a, b, PrecBlockJacobi<Doub>(a, N0 - 1), 20, tol, 1000, wsp);
+        if (it < 0 || test_krylov_res(a, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        // exact factorization as preconditioner
+        x = 0;
+        it = bicgstab(x, a, b, LuBand<Doub>(a), tol, 1000, wsp);
+        if (it != 1 || test_krylov_res(a, x, b) > 10 * tol)
+            SLS_ERR("failed!");
+        x = 0;
+        it = minres(x, a, b, PrecJacobi<Doub>(a), tol, 1000, wsp);
+        if (it < 0 || test_krylov_res(a, x, b) > 1e3 * tol)
+            SLS_ERR("failed!");
+    }
+}
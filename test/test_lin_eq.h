@@ -1,15 +1,105 @@
 #pragma once
 #include "../SLISC/lin_eq.h"
+#include "../SLISC/arithmetic.h"
+#include "../SLISC/random.h"
 
 void test_lin_eq()
 {
     using namespace slisc;
-    CmatDoub a(3, 3), a_inv(3, 3), b(3, 3);
-    a = 1; a(0, 0) += 2; a(1, 1) += 2; a(2, 2) += 2;    
-    a_inv = a;
-    inv_mat(a_inv);
-    mul(b, a, a_inv);
-    b(0, 0) -= 1; b(1, 1) -= 1; b(2, 2) -= 1;
-    if (norm(b) > 2e-15)
-        SLS_ERR("failed!");
+#ifdef SLS_USE_LAPACKE
+    {
+        CmatDoub a(3, 3), a_inv(3, 3), b(3, 3);
+        a = 1; a(0, 0) += 2; a(1, 1) += 2; a(2, 2) += 2;
+        a_inv = a;
+        inv_mat(a_inv);
+        mul(b, a, a_inv);
+        b(0, 0) -= 1; b(1, 1) -= 1; b(2, 2) -= 1;
+        if (norm(b) > 2e-15)
+            SLS_ERR("failed!");
+    }
+#endif
+
+    // Lu<T> (more than one block for the native version)
+    {
+        Long N = 150, Ncol = 5;
+        CmatDoub a(N, N), x(N, Ncol), b(N, Ncol);
+        rand(a); rand(x);
+        for (Long i = 0; i < N; ++i)
+            a(i, i) -= 0.5; // make pivoting necessary
+        mul(b, a, x);
+        LuDoub lu(a);
+        lu.solve(b);
+        b -= x;
+        if (max_abs(b) > 1e-10)
+            SLS_ERR("failed!");
+
+        CmatComp ac(N, N), xc(N, Ncol), bc(N, Ncol);
+        VecComp xv(N), bv(N);
+        rand(ac); rand(xc); rand(xv);
+        mul(bc, ac, xc);
+        mul(bv, ac, xv);
+        LuComp luc;
+        luc.factor(ac);
+        luc.solve(bc);
+        bc -= xc;
+        if (max_abs(bc) > 1e-10)
+            SLS_ERR("failed!");
+        luc.solve(bv);
+        bv -= xv;
+        if (max_abs(bv) > 1e-10)
+            SLS_ERR("failed!");
+
+        // same result as the native version
+        CmatDoub lu1(N, N); lu1 = a;
+        VecInt ipiv(N);
+        lu_native(lu1.ptr(), ipiv.ptr(), N);
+        mul(b, a, x);
+        lu_solve_native(b.ptr(), lu1.ptr(), ipiv.ptr(), N, Ncol);
+        b -= x;
+        if (max_abs(b) > 1e-10)
+            SLS_ERR("failed!");
+    }
+
+    // Chol<T>
+    {
+        Long N = 140, Ncol = 3;
+        CmatComp a(N, N), x(N, Ncol), b(N, Ncol);
+        for (Long j = 0; j < N; ++j) {
+            for (Long i = 0; i < j; ++i) {
+                a(i, j) = Comp(randDoub() - 0.5, randDoub() - 0.5);
+                a(j, i) = conj(a(i, j));
+            }
+            a(j, j) = N * 0.5;
+        }
+        rand(x);
+        mul(b, a, x);
+        CholComp chol(a);
+        chol.solve(b);
+        b -= x;
+        if (max_abs(b) > 1e-12)
+            SLS_ERR("failed!");
+
+        CmatDoub ar(N, N), xr(N, Ncol), br(N, Ncol);
+        for (Long j = 0; j < N; ++j) {
+            for (Long i = 0; i < j; ++i)
+                ar(i, j) = ar(j, i) = randDoub() - 0.5;
+            ar(j, j) = N * 0.5;
+        }
+        rand(xr);
+        mul(br, ar, xr);
+        CholDoub cholr(ar);
+        cholr.solve(br);
+        br -= xr;
+        if (max_abs(br) > 1e-12)
+            SLS_ERR("failed!");
+
+        // native version
+        CmatComp l(N, N); l = a;
+        chol_native(l.ptr(), N);
+        mul(b, a, x);
+        chol_solve_native(b.ptr(), l.ptr(), N, Ncol);
+        b -= x;
+        if (max_abs(b) > 1e-12)
+            SLS_ERR("failed!");
+    }
 }
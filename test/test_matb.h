@@ -0,0 +1,105 @@
+#pragma once
+#include "../SLISC/matb.h"
+#include "../SLISC/random.h"
+#include "../SLISC/arithmetic.h"
+
+void test_matb()
+{
+    using namespace slisc;
+
+    // compression of buffers
+    {
+        Long N = 10000;
+        VecDoub x(N);
+        for (Long i = 0; i < N; ++i)
+            x[i] = sin(0.001 * i) + (i % 7 == 0 ? 1 : 0);
+        vector<Uchar> out;
+        Int methods[] = { 1, 2 };
+        for (Int method : methods) {
+#ifndef SLS_USE_ZLIB
+            if (method == 2)
+                continue;
+#endif
+            Int ret = compress_buf(out, (Uchar *)x.ptr(), N * sizeof(Doub), sizeof(Doub), method);
+            if (ret != method || Size(out) >= N * (Long)sizeof(Doub))
+                SLS_ERR("failed!");
+            VecDoub y(N);
+            if (decompress_buf((Uchar *)y.ptr(), N * sizeof(Doub), out.data(), out.size(), sizeof(Doub), ret))
+                SLS_ERR("failed!");
+            if (y != x) SLS_ERR("failed!");
+        }
+        // incompressible data
+        VecChar r(1000);
+        for (Long i = 0; i < r.size(); ++i)
+            r[i] = (Char)randInt(256);
+        Int ret = compress_buf(out, (Uchar *)r.ptr(), r.size(), 1, 1);
+        VecChar r1(r.size());
+        if (decompress_buf((Uchar *)r1.ptr(), r1.size(), out.data(), out.size(), 1, ret))
+            SLS_ERR("failed!");
+        if (r1 != r) SLS_ERR("failed!");
+        // corrupted data
+        if (lz_decompress((Uchar *)r1.ptr(), 10, (Uchar *)r.ptr(), r.size()) >= 0)
+            SLS_ERR("failed!");
+    }
+
+    // save and load
+    for (Int comp = 0; comp < 2; ++comp) {
+        Matb matb;
+        if (file_exist("test.matb"))
+            remove("test.matb");
+        matb.open("test.matb", "w", comp);
+        matb.m_chunk = 1000; // test multiple chunks
+
+        Int si = 99; save(si, "si", matb);
+        Doub s = 3.14159265358979323; save(s, "s", matb);
+        Comp sc(s, -s); save(sc, "sc", matb);
+        VecInt vi(3); vi[0] = 1; vi[1] = 2; vi[2] = 3;
+        save(vi, "vi", matb);
+        VecComp vc(1000);
+        for (Long i = 0; i < vc.size(); ++i)
+            vc[i] = exp(Comp(-0.01 * i, 0.1 * i));
+        save(vc, "vc", matb);
+        MatDoub A(30, 40);
+        for (Long i = 0; i < A.size(); ++i)
+            A[i] = randDoub();
+        save(A, "A", matb);
+        CmatComp C(40, 30);
+        for (Long i = 0; i < C.size(); ++i)
+            C[i] = Comp(i, -i);
+        save(C, "C", matb);
+        Mat3Doub A3(3, 4, 5);
+        for (Long i = 0; i < A3.size(); ++i)
+            A3[i] = randDoub();
+        save(A3, "A3", matb);
+        Cmat3Comp C3(5, 4, 3);
+        for (Long i = 0; i < C3.size(); ++i)
+            C3[i] = Comp(randDoub(), randDoub());
+        save(C3, "C3", matb);
+        matb.close();
+
+        matb.open("test.matb", "r");
+        Int r_si; load(r_si, "si", matb);
+        if (r_si != si) SLS_ERR("failed!");
+        Doub r_s; load(r_s, "s", matb);
+        if (r_s != s) SLS_ERR("failed!");
+        Comp r_sc; load(r_sc, "sc", matb);
+        if (r_sc != sc) SLS_ERR("failed!");
+        VecInt r_vi(0); load(r_vi, "vi", matb);
+        if (r_vi != vi) SLS_ERR("failed!");
+        VecDoub r_vd(0); load(r_vd, "vi", matb); // type promotion
+        for (Long i = 0; i < vi.size(); ++i)
+            if (r_vd[i] != vi[i]) SLS_ERR("failed!");
+        VecComp r_vc(0); load(r_vc, "vc", matb);
+        if (r_vc != vc) SLS_ERR("failed!");
+        MatDoub r_A(0, 0); load(r_A, "A", matb);
+        if (r_A != A) SLS_ERR("failed!");
+        CmatComp r_C(0, 0); load(r_C, "C", matb);
+        if (r_C != C) SLS_ERR("failed!");
+        Mat3Doub r_A3(0, 0, 0); load(r_A3, "A3", matb);
+        if (r_A3 != A3) SLS_ERR("failed!");
+        Cmat3Comp r_C3(0, 0, 0); load(r_C3, "C3", matb);
+        if (r_C3 != C3) SLS_ERR("failed!");
+        matb.close();
+    }
+    remove("test.matb");
+}
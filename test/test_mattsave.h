@@ -144,4 +144,73 @@ void test_mattsave()
     if (norm(r_CC3) > 1e-15) SLS_ERR("failed!");
 
     matt.close();
+
+    // append records
+    if (file_exist("test_append.matt"))
+        remove("test_append.matt");
+    matt.open("test_append.matt", "w");
+    Long Nrec = 5;
+    VecComp psi(4); CmatDoub obs(2, 3);
+    CmatComp psi_all(4, Nrec); Cmat3Doub obs_all(2, 3, Nrec);
+    for (Long k = 0; k < Nrec; ++k) {
+        for (Long i = 0; i < psi.size(); ++i)
+            psi_all(i, k) = psi[i] = Comp(randDoub(), randDoub());
+        for (Long i = 0; i < obs.size(); ++i)
+            obs_all[i + obs.size()*k] = obs[i] = randDoub();
+        append(psi, "psi", matt);
+        save(s, "s" + to_string(k), matt);
+        append(obs, "obs", matt);
+    }
+    // simulate a crash: copy the file before close()
+    Str str;
+    read_file(str, "test_append.matt");
+    {
+        ofstream fout("test_crash.matt", std::ios::binary);
+        fout << str << "8 1";
+    }
+    matt.close();
+
+    for (Int ifile = 0; ifile < 2; ++ifile) {
+        matt.open(ifile == 0 ? "test_append.matt" : "test_crash.matt", "r");
+        if (matt.m_n != 2 + Nrec) SLS_ERR("failed!");
+        CmatComp r_psi_all(0, 0);
+        load(r_psi_all, "psi", matt);
+        r_psi_all -= psi_all;
+        if (norm(r_psi_all) > 1e-15) SLS_ERR("failed!");
+        Cmat3Doub r_obs_all(0, 0, 0);
+        load(r_obs_all, "obs", matt);
+        r_obs_all -= obs_all;
+        if (norm(r_obs_all) > 1e-15) SLS_ERR("failed!");
+        load(r_s, "s3", matt);
+        if (r_s != s) SLS_ERR("failed!");
+        VecComp r_psi(0);
+        load_rec(r_psi, "psi", 3, matt);
+        for (Long i = 0; i < r_psi.size(); ++i)
+            if (abs(r_psi[i] - psi_all(i, 3)) > 1e-15) SLS_ERR("failed!");
+        CmatDoub r_obs(0, 0);
+        load_rec(r_obs, "obs", 1, matt);
+        for (Long i = 0; i < r_obs.size(); ++i)
+            if (abs(r_obs[i] - obs_all[i + r_obs.size()]) > 1e-15) SLS_ERR("failed!");
+        matt.close();
+    }
+    remove("test_crash.matt");
+
+    // (m, 1) matrices saved with the same name are not records
+    remove("test_append.matt");
+    matt.open("test_append.matt", "w");
+    CmatDoub col(3, 1), col2(3, 1);
+    col[0] = 1; col[1] = 2; col[2] = 3;
+    col2 = col; col2 *= 2;
+    save(col, "col", matt);
+    save(col2, "col", matt);
+    matt.close();
+    matt.open("test_append.matt", "r");
+    if (matt.m_n != 2 || !matt.m_ind_rec[0].empty() || !matt.m_ind_rec[1].empty())
+        SLS_ERR("failed!");
+    CmatDoub r_col(0, 0);
+    load(r_col, "col", matt);
+    if (r_col.n1() != 3 || r_col.n2() != 1 || r_col != col)
+        SLS_ERR("failed!");
+    matt.close();
+    remove("test_append.matt");
 }
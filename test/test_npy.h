@@ -0,0 +1,92 @@
+#pragma once
+#include "../SLISC/npy.h"
+#include "../SLISC/random.h"
+#include "../SLISC/arithmetic.h"
+
+void test_npy()
+{
+    using namespace slisc;
+
+    VecDoub v(7);
+    for (Long i = 0; i < v.size(); ++i)
+        v[i] = randDoub();
+    MatComp A(3, 4);
+    for (Long i = 0; i < A.size(); ++i)
+        A[i] = Comp(randDoub(), randDoub());
+    CmatInt B(4, 5);
+    for (Long i = 0; i < B.size(); ++i)
+        B[i] = randInt(100);
+    Mat3Doub A3(2, 3, 4);
+    for (Long i = 0; i < A3.size(); ++i)
+        A3[i] = randDoub();
+    Cmat3Comp C3(4, 3, 2);
+    for (Long i = 0; i < C3.size(); ++i)
+        C3[i] = Comp(randDoub(), randDoub());
+
+    // .npy files
+    {
+        save_npy(v, "test_v.npy");
+        VecDoub v1(0);
+        if (load_npy(v1, "test_v.npy")) SLS_ERR("failed!");
+        if (v1 != v) SLS_ERR("failed!");
+
+        save_npy(A, "test_A.npy");
+        MatComp A1(0, 0);
+        load_npy(A1, "test_A.npy");
+        if (A1 != A) SLS_ERR("failed!");
+        // load row-major data to a column-major container
+        CmatComp A2(0, 0);
+        load_npy(A2, "test_A.npy");
+        if (A2.n1() != A.n1() || A2.n2() != A.n2()) SLS_ERR("failed!");
+        for (Long i = 0; i < A.n1(); ++i)
+            for (Long j = 0; j < A.n2(); ++j)
+                if (A2(i, j) != A(i, j)) SLS_ERR("failed!");
+
+        save_npy(C3, "test_C3.npy");
+        Mat3Comp C31(0, 0, 0);
+        load_npy(C31, "test_C3.npy");
+        for (Long i = 0; i < C3.n1(); ++i)
+            for (Long j = 0; j < C3.n2(); ++j)
+                for (Long k = 0; k < C3.n3(); ++k)
+                    if (C31(i, j, k) != C3(i, j, k)) SLS_ERR("failed!");
+
+        // memory map
+        save_npy(B, "test_B.npy");
+        NpyMap map("test_B.npy");
+        if (!map.fortran || map.shape.size() != 2) SLS_ERR("failed!");
+        Scmat_c<Int> sB; map.view(sB);
+        if (sB.n1() != B.n1() || sB.n2() != B.n2()) SLS_ERR("failed!");
+        for (Long i = 0; i < B.size(); ++i)
+            if (sB[i] != B[i]) SLS_ERR("failed!");
+        map.open("test_A.npy");
+        Svector_c<Comp> sA; map.view(sA);
+        for (Long i = 0; i < A.size(); ++i)
+            if (sA[i] != A[i]) SLS_ERR("failed!");
+        map.close();
+
+        remove("test_v.npy"); remove("test_A.npy");
+        remove("test_B.npy"); remove("test_C3.npy");
+    }
+
+    // .npz files
+    {
+        Npz npz("test.npz", "w");
+        save(v, "v", npz);
+        save(A, "A", npz);
+        save(B, "B", npz);
+        save(A3, "A3", npz);
+        npz.close();
+
+        npz.open("test.npz", "r");
+        VecDoub v1(0); load(v1, "v", npz);
+        if (v1 != v) SLS_ERR("failed!");
+        MatComp A1(0, 0); load(A1, "A", npz);
+        if (A1 != A) SLS_ERR("failed!");
+        CmatInt B1(0, 0); load(B1, "B", npz);
+        if (B1 != B) SLS_ERR("failed!");
+        Mat3Doub A31(0, 0, 0); load(A31, "A3", npz);
+        if (A31 != A3) SLS_ERR("failed!");
+        npz.close();
+        remove("test.npz");
+    }
+}
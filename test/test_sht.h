@@ -0,0 +1,71 @@
+#pragma once
+#include "../SLISC/sht.h"
+#include "../SLISC/arithmetic.h"
+#include "../SLISC/random.h"
+
+inline void test_sht()
+{
+    using namespace slisc;
+    // GaussLegendre(), exact for polynomials of degree 2N-1
+    {
+        Long N = 7;
+        VecDoub x(N), w(N);
+        GaussLegendre(x, w);
+        for (Int k = 0; k < 2 * N; ++k) {
+            Doub s = 0;
+            for (Long i = 0; i < N; ++i)
+                s += w[i] * pow(x[i], k);
+            if (abs(s - (isodd(k) ? 0. : 2. / (k + 1))) > 1e-14)
+                SLS_ERR("failed!");
+        }
+    }
+
+    // isht() compared with ylm(), then sht() recovers the coefficients
+    {
+        Int lmax = 10;
+        ShtPlan plan(lmax);
+        if (plan.Nth != lmax + 1 || plan.Nph != 32)
+            SLS_ERR("failed!");
+        VecComp c(plan.size()), c1(plan.size());
+        rand(c);
+        MatComp f(plan.Nth, plan.Nph), f1(plan.Nth, plan.Nph);
+        isht(f, c, plan);
+        for (Long i = 0; i < plan.Nth; ++i)
+            for (Long j = 0; j < plan.Nph; ++j) {
+                Comp s = 0;
+                for (Int l = 0; l <= lmax; ++l)
+                    for (Int m = -l; m <= l; ++m)
+                        s += c[ylm_ind(l, m)] * ylm(l, m, plan.theta[i], plan.phi[j]);
+                if (abs(s - f(i, j)) > 1e-12)
+                    SLS_ERR("failed!");
+            }
+        sht(c1, f, plan);
+        c1 -= c;
+        if (max_abs(c1) > 1e-12)
+            SLS_ERR("failed!");
+
+        // parallel version
+        isht_par(f1, c, plan);
+        f1 -= f;
+        if (max_abs(f1) > 1e-14)
+            SLS_ERR("failed!");
+        sht_par(c1, f, plan);
+        c1 -= c;
+        if (max_abs(c1) > 1e-12)
+            SLS_ERR("failed!");
+    }
+
+    // oversampled grid, larger lmax
+    {
+        Int lmax = 60;
+        ShtPlan plan(lmax, 80, 256);
+        VecComp c(plan.size()), c1(plan.size());
+        rand(c);
+        MatComp f(plan.Nth, plan.Nph);
+        isht(f, c, plan);
+        sht(c1, f, plan);
+        c1 -= c;
+        if (max_abs(c1) > 1e-11)
+            SLS_ERR("failed!");
+    }
+}
@@ -25,4 +25,42 @@ inline void test_sort()
         if (a[i] != a0[order[i]])
             SLS_ERR("failed!");
     }
+
+    // test sort2_radix_par() (stable), with more than one chunk
+    {
+        Long N = 200000, vmax = 1000000007;
+        VecLong a(N), a0(N), order(N);
+        for (Long i = 0; i < N; ++i)
+            a0[i] = randInt(i % 3 == 0 ? 100 : vmax);
+        a = a0;
+        linspace(order, 0, N - 1);
+        sort2_radix_par(a, order, vmax);
+        for (Long i = 1; i < N; ++i) {
+            if (a[i] < a[i-1] || (a[i] == a[i-1] && order[i] < order[i-1]))
+                SLS_ERR("failed!");
+        }
+        for (Long i = 0; i < N; ++i) {
+            if (a[i] != a0[order[i]])
+                SLS_ERR("failed!");
+        }
+    }
+
+    // same, the lowest byte is always 0 so the first pass is skipped
+    {
+        Long N = 200000, vmax = 255 << 16;
+        VecLong a(N), a0(N), order(N);
+        for (Long i = 0; i < N; ++i)
+            a0[i] = randInt(256) << 8;
+        a = a0;
+        linspace(order, 0, N - 1);
+        sort2_radix_par(a, order, vmax);
+        for (Long i = 1; i < N; ++i) {
+            if (a[i] < a[i-1] || (a[i] == a[i-1] && order[i] < order[i-1]))
+                SLS_ERR("failed!");
+        }
+        for (Long i = 0; i < N; ++i) {
+            if (a[i] != a0[order[i]])
+                SLS_ERR("failed!");
+        }
+    }
 }
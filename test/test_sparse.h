@@ -4,6 +4,7 @@
 #include "../SLISC/cmatobd.h"
 #include "../SLISC/diag.h"
 #include "../SLISC/band_arith.h"
+#include "../SLISC/band_lin_eq.h"
 #include "../SLISC/disp.h"
 
 inline void test_sparse()
@@ -128,8 +129,195 @@ inline void test_sparse()
             if (a != b)
                 SLS_ERR("failed!");
         }
+
+        // find() with binary search and hash table, add()
+        {
+            Long N = 30;
+            McooInt a(N, N, N*N), b(N, N, N*N);
+            for (Long i = 0; i < N; ++i)
+                for (Long j = 0; j < N; j += 2)
+                    a.push(i + 100*j, i, j);
+            if (!a.sorted()) SLS_ERR("failed!");
+            a.push(-1, 0, 1);
+            if (a.sorted()) SLS_ERR("failed!");
+            a.sort_r();
+            if (!a.sorted()) SLS_ERR("failed!");
+            b.use_hash();
+            for (Long j = N-1; j >= 0; --j)
+                for (Long i = 0; i < N; ++i)
+                    b.set(-i, i, j);
+            for (Long i = 0; i < N; ++i)
+                for (Long j = 0; j < N; ++j) {
+                    if (j % 2 == 0 && a(i, j) != i + 100*j) SLS_ERR("failed!");
+                    if (j % 2 == 1 && a(i, j) != (i == 0 && j == 1 ? -1 : 0)) SLS_ERR("failed!");
+                    b.add(i + 100*j, i, j);
+                    b.add(i, i, j);
+                }
+            if (b.nnz() != N*N) SLS_ERR("failed!");
+            for (Long i = 0; i < N; ++i)
+                for (Long j = 0; j < N; ++j)
+                    if (b(i, j) != i + 100*j || b.find(i, j) != N*(N-1-j) + i)
+                        SLS_ERR("failed!");
+            b.sort_r();
+            for (Long i = 0; i < N; ++i)
+                for (Long j = 0; j < N; ++j)
+                    if (b.find(i, j) != N*i + j) SLS_ERR("failed!");
+            b.use_hash(false);
+            if (b.find(N-1, N-1) != N*N-1 || b.find(1, 2) != N+2) SLS_ERR("failed!");
+            // const find() with an out-of-date hash table falls back to searching
+            b.use_hash(); b.row_ptr();
+            const McooInt &cb = b;
+            Long Nerr = 0;
+#pragma omp parallel for reduction(+:Nerr)
+            for (Long i = 0; i < N; ++i)
+                for (Long j = 0; j < N; ++j)
+                    if (cb.find(i, j) != N*i + j || cb(i, j) != i + 100*j) ++Nerr;
+            if (Nerr != 0) SLS_ERR("failed!");
+            McoohComp c(3, 3, 5);
+            c.use_hash();
+            c.add(Comp(1, 1), 0, 2); c.add(Comp(1, 1), 2, 0);
+            if (c.nnz() != 1 || c(0, 2) != Comp(2, 0) || c(2, 0) != Comp(2, 0))
+                SLS_ERR("failed!");
+        }
     }
     
+    // bulk push with growing capacity, sum_dup(), MatCsr
+    {
+        Long Nr = 300, Nc = 200, N = 10000;
+        McooDoub a(Nr, Nc);
+        CmatDoub b(Nr, Nc); b = 0;
+        VecDoub s(N); VecLong is(N), js(N);
+        for (Long k = 0; k < N; ++k) {
+            s[k] = randInt(10); is[k] = randInt(Nr); js[k] = randInt(Nc);
+            b(is[k], js[k]) += s[k];
+        }
+        a.push(s[0], is[0], js[0]);
+        a.push(s.ptr() + 1, is.ptr() + 1, js.ptr() + 1, N - 1);
+        if (a.nnz() != N || a.capacity() < N || a.sorted())
+            SLS_ERR("failed!");
+        a.sum_dup();
+        if (!a.sorted())
+            SLS_ERR("failed!");
+        for (Long k = 1; k < a.nnz(); ++k)
+            if (Nc*a.row(k) + a.col(k) <= Nc*a.row(k-1) + a.col(k-1))
+                SLS_ERR("failed!");
+        CmatDoub b1(Nr, Nc); b1 = a;
+        if (b1 != b) SLS_ERR("failed!");
+        McsrDoub c(Nr, Nc);
+        c = a;
+        if (c.nnz() != a.nnz() || c.row_ptr()[Nr] != a.nnz())
+            SLS_ERR("failed!");
+        for (Long i = 0; i < Nr; ++i)
+            for (Long j = 0; j < Nc; ++j)
+                if (c(i, j) != b(i, j))
+                    SLS_ERR("failed!");
+        VecComp x(Nc), y(Nr), y1(Nr), y2(Nr);
+        rand(x);
+        mul(y, b, x); mul(y1, c, x); mul_par(y2, c, x);
+        y1 -= y; y2 -= y;
+        if (max_abs(y1) > 1e-12 || max_abs(y2) > 1e-12)
+            SLS_ERR("failed!");
+
+        // many vectors, column major and row major
+        Long Ncol = 5;
+        CmatComp X(Nc, Ncol), Y(Nr, Ncol), Y1(Nr, Ncol), Y2(Nr, Ncol);
+        MatComp Xr(Nc, Ncol), Yr(Nr, Ncol), Yr1(Nr, Ncol);
+        rand(X); Xr = X;
+        mul(Y, b, X); mul(Y1, c, X); mul_par(Y2, c, X);
+        mul(Yr, c, Xr); mul_par(Yr1, c, Xr);
+        Y1 -= Y; Y2 -= Y;
+        if (max_abs(Y1) > 1e-12 || max_abs(Y2) > 1e-12)
+            SLS_ERR("failed!");
+        for (Long j = 0; j < Ncol; ++j)
+            for (Long i = 0; i < Nr; ++i)
+                if (abs(Yr(i, j) - Y(i, j)) > 1e-12 || Yr1(i, j) != Yr(i, j))
+                    SLS_ERR("failed!");
+    }
+
+    // 32-bit indices
+    {
+        Long N = 50;
+        McooComp a(N, N, 3*N);
+        Mcoo32Comp a32(N, N);
+        McoohComp b(N, N, 2*N);
+        Mcooh32Comp b32(N, N, 2*N);
+        for (Long i = 0; i < N; ++i) {
+            a.push(Comp(i, 1), i, i);
+            b.push(Comp(i, 0), i, i);
+            if (i > 0) {
+                a.push(Comp(-1, i), i, i - 1);
+                b.push(Comp(-1, i), i, i - 1);
+            }
+            if (i < N - 1)
+                a.push(Comp(2, -i), i, i + 1);
+        }
+        a.sort_r();
+        a32.reserve(a.nnz());
+        a32 = a; b32 = b;
+        if (!is_same<decltype(a32.row_ptr()), Int *>())
+            SLS_ERR("failed!");
+        if (a32.nnz() != a.nnz() || a32(3, 2) != a(3, 2) || b32(2, 3) != b(2, 3))
+            SLS_ERR("failed!");
+        Mcsr32Comp c32(N, N);
+        c32 = a32;
+        VecComp x(N), y(N), y1(N), y2(N), y3(N);
+        rand(x);
+        mul(y, a, x); mul(y1, a32, x); mul(y2, c32, x);
+        y1 -= y; y2 -= y;
+        if (max_abs(y1) > 1e-13 || max_abs(y2) > 1e-13)
+            SLS_ERR("failed!");
+        mul(y, b, x); mul(y3, b32, x);
+        y3 -= y;
+        if (max_abs(y3) > 1e-13 || norm_inf(a32) != norm_inf(a) || norm_inf(b32) != norm_inf(b))
+            SLS_ERR("failed!");
+        CmatComp d(N, N), d32(N, N);
+        d = a; d32 = a32;
+        if (d32 != d) SLS_ERR("failed!");
+    }
+
+    // SELL-C-sigma
+    {
+        Long N = 203;
+        McooDoub a(N, N);
+        McoohComp b(N, N);
+        for (Long i = 0; i < N; ++i) {
+            Long Nrow = i % 7 == 0 ? 20 : 1 + i % 4;
+            for (Long k = 0; k < Nrow; ++k) {
+                Long j = (i * 13 + k * 31) % N;
+                a.add(randDoub(), i, j);
+                b.add(Comp(randDoub(), randDoub()), i, j);
+            }
+        }
+        VecComp x(N), y(N), y1(N), y2(N);
+        rand(x);
+        mul(y, a, x);
+        MsellDoub c(N, N, 8, 32);
+        c = a;
+        if (c.nnz() != a.nnz() || c.capacity() % 8 != 0 || c.nslice() != (N + 7) / 8)
+            SLS_ERR("failed!");
+        mul(y1, c, x); mul_par(y2, c, x);
+        y1 -= y; y2 -= y;
+        if (max_abs(y1) > 1e-12 || max_abs(y2) > 1e-12)
+            SLS_ERR("failed!");
+        VecComp z(N), z1(N);
+        mul(z, b, x);
+        Msell32Comp d(N, N, 4, 1);
+        d = b;
+        mul_par(z1, d, x);
+        z1 -= z;
+        if (max_abs(z1) > 1e-12)
+            SLS_ERR("failed!");
+        // slice heights without a compile-time kernel, and more than sell_group rows
+        for (Long C : { 6, 100 }) {
+            MsellDoub e(N, N, C, 32);
+            e = a;
+            mul(y1, e, x); mul_par(y2, e, x);
+            y1 -= y; y2 -= y;
+            if (max_abs(y1) > 1e-12 || max_abs(y2) > 1e-12)
+                SLS_ERR("failed!");
+        }
+    }
+
     // TODO: Diag
 
     {
@@ -358,4 +546,78 @@ inline void test_sparse()
         if (max_abs(y1) > 1e-13)
             SLS_ERR("failed");
     }
+
+    // band LU solver, single and multiple right hand sides
+    {
+        Long N = 30, Nlow = 2, Nup = 1, Ncol = 3;
+        CmatComp den(N, N); rand(den);
+        Band<Comp> ban(den, Nup, Nlow);
+        den = 0;
+        band2mat(den, ban.m_a, Nup, Nlow);
+        LuBand<Comp> lu(ban);
+        VecComp x(N), b(N), b1(N); rand(x);
+        mul(b, den, x);
+        lu.solve(b);
+        b -= x;
+        if (max_abs(b) > 1e-8)
+            SLS_ERR("failed!");
+        CmatComp X(N, Ncol), B(N, Ncol); rand(X);
+        mul(B, den, X);
+        lu.solve(B);
+        B -= X;
+        if (max_abs(B) > 1e-8)
+            SLS_ERR("failed!");
+    }
+
+    // band LDL^H solver for a Hermitian positive definite matrix
+    {
+        Long N = 30, Nlow = 3;
+        CmatComp den(N, N); den = 0;
+        for (Long j = 0; j < N; ++j) {
+            den(j, j) = 10 + randDoub();
+            for (Long i = j + 1; i < MIN(N, j + Nlow + 1); ++i) {
+                den(i, j) = Comp(randDoub() - 0.5, randDoub() - 0.5);
+                den(j, i) = conj(den(i, j));
+            }
+        }
+        Band<Comp> ban(den, Nlow, Nlow);
+        LdlBand<Comp> ldl(ban);
+        VecComp x(N), b(N); rand(x);
+        mul(b, den, x);
+        ldl.solve(b);
+        b -= x;
+        if (max_abs(b) > 1e-12)
+            SLS_ERR("failed!");
+    }
+
+    // LU and LDL^H solver for CmatObd
+    {
+        Long N0 = 5, Nblk = 8;
+        Cmat3Doub a3(N0, N0, Nblk);
+        rand(a3);
+        for (Long k = 0; k < Nblk; ++k)
+            for (Long j = 0; j < N0; ++j) {
+                a3(j, j, k) += 10;
+                for (Long i = 0; i < j; ++i)
+                    a3(i, j, k) = a3(j, i, k);
+            }
+        CmobdDoub a(N0, Nblk); a = a3;
+        Long N = a.n1();
+        CmatDoub den(N, N);
+        for (Long j = 0; j < N; ++j)
+            for (Long i = 0; i < N; ++i)
+                den(i, j) = a(i, j);
+        VecDoub x(N), b(N), b1(N); rand(x);
+        mul(b, den, x); b1 = b;
+        LuBand<Doub> lu(a);
+        lu.solve(b);
+        b -= x;
+        if (max_abs(b) > 1e-10)
+            SLS_ERR("failed!");
+        LdlBand<Doub> ldl(a);
+        ldl.solve(b1);
+        b1 -= x;
+        if (max_abs(b1) > 1e-10)
+            SLS_ERR("failed!");
+    }
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include "../SLISC/ylm.h"
+#include "../SLISC/arithmetic.h"
+#include "../SLISC/random.h"
 
 inline void test_ylm()
 {
@@ -15,4 +17,47 @@ inline void test_ylm()
     ret = yl1l2LM(1, 2, 3, 1, 1.1, 2.2, 1.2, 2.3);
     if (abs(ret - Comp(-0.01344167979466, 0.016624624728563)) > 1e-8)
         SLS_ERR("failed");
+
+    // ylm_table(), compare with ylm()
+    {
+        Int lmax = 12; Long N = 150;
+        VecDoub theta(N), phi(N);
+        for (Long i = 0; i < N; ++i) {
+            theta[i] = 7 * randDoub() - 2; phi[i] = 10 * randDoub() - 3;
+        }
+        CmatComp Y((lmax + 1) * (lmax + 1), N), Y1((lmax + 1) * (lmax + 1), N);
+        ylm_table(Y, lmax, theta, phi);
+        for (Long i = 0; i < N; ++i)
+            for (Int l = 0; l <= lmax; ++l)
+                for (Int m = -l; m <= l; ++m)
+                    if (abs(Y(ylm_ind(l, m), i) - ylm(l, m, theta[i], phi[i])) > 1e-13)
+                        SLS_ERR("failed");
+        ylm_table_par(Y1, lmax, theta, phi);
+        if (Y != Y1)
+            SLS_ERR("failed");
+    }
+
+    // large l: sum_m |Y_lm|^2 = (2l+1)/(4pi), and legendre_norm_table()
+    {
+        Int lmax = 300; Long N = 24;
+        VecDoub theta(N), phi(N, 0.3);
+        linspace(theta, 0., PI);
+        CmatComp Y((lmax + 1) * (lmax + 1), N);
+        ylm_table_par(Y, lmax, theta, phi);
+        for (Long i = 0; i < N; ++i)
+            for (Int l = 0; l <= lmax; l += 50) {
+                Doub s = 0;
+                for (Int m = -l; m <= l; ++m)
+                    s += norm(Y(ylm_ind(l, m), i));
+                if (abs(s * 4 * PI / (2 * l + 1) - 1) > 1e-11)
+                    SLS_ERR("failed");
+            }
+        CmatDoub P(N, plm_ind(lmax + 1, 0));
+        legendre_norm_table(P, lmax, theta);
+        for (Long i = 0; i < N; i += 3)
+            for (Int l = 0; l <= lmax; l += 7)
+                for (Int m = 0; m <= l; m += 5)
+                    if (abs(P(i, plm_ind(l, m)) - real(Y(ylm_ind(l, m), i) * exp(Comp(0, -0.3 * m)))) > 1e-12)
+                        SLS_ERR("failed");
+    }
 }